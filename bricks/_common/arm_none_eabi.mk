@@ -199,6 +199,19 @@ CFLAGS += -Os -DNDEBUG -flto=auto
 CFLAGS += -fdata-sections -ffunction-sections
 endif
 
+# Optional heap profiler: make PB_HEAP_PROFILER=1. LTO is disabled so that
+# calls to the wrapped allocation functions from all objects are redirected.
+# Without LTO, the firmware only fits on hubs with plenty of flash.
+ifeq ($(PB_HEAP_PROFILER),1)
+ifeq ($(filter $(PBIO_PLATFORM),prime_hub essential_hub ev3),)
+$(error "PB_HEAP_PROFILER=1 is only supported on SPIKE Prime, SPIKE Essential and EV3")
+endif
+CFLAGS += -DPYBRICKS_OPT_HEAP_PROFILER=1 -fno-lto
+LDFLAGS += -Wl,--wrap=m_malloc,--wrap=m_malloc_maybe,--wrap=m_malloc0
+LDFLAGS += -Wl,--wrap=m_malloc_with_finaliser,--wrap=m_realloc
+LDFLAGS += -Wl,--wrap=mp_obj_malloc_helper
+endif
+
 ifeq ($(PB_MCU_FAMILY),STM32)
 # Required for STM32 library
 CFLAGS += -D$(PB_CMSIS_MCU)
@@ -7,6 +7,7 @@
 #include <stdio.h>
 #include <string.h>
 
+#include <pbdrv/clock.h>
 #include <pbdrv/stack.h>
 
 #include <pbio/button.h>
@@ -19,6 +20,7 @@
 #include <pbsys/storage.h>
 
 #include <pybricks/common.h>
+#include <pybricks/util_mp/pb_heap_profiler.h>
 #include <pybricks/util_mp/pb_obj_helper.h>
 
 #include "genhdr/mpversion.h"
@@ -199,14 +201,23 @@ typedef struct {
     /** mpy data follows thereafter. */
 } mpy_info_t;
 
-// Program data is a concatenation of multiple mpy files. This sets a reference
-// to the first script and the total size so we can search for modules.
+/** Entry in the module index, which is sorted by the hash of the name. */
+typedef struct {
+    /** Hash of the module name. */
+    uint32_t hash;
+    /** The module with this name. */
+    mpy_info_t *info;
+} mpy_index_entry_t;
+
+// Program data is a concatenation of multiple mpy files. Instead of walking
+// through all of them on every import, we index them once when the program
+// starts. The index is sorted by name hash so modules can be found quickly.
+// If there is no RAM for the index, it is NULL and modules are searched one
+// by one from the first to the end.
 static mpy_info_t *mpy_first;
 static mpy_info_t *mpy_end;
-static inline void mpy_data_init(pbsys_main_program_t *program) {
-    mpy_first = (mpy_info_t *)program->code_start;
-    mpy_end = (mpy_info_t *)program->code_end;
-}
+static mpy_index_entry_t *mpy_index;
+static size_t mpy_index_size;
 
 /**
  * Gets a reference to the mpy data of a script.
@@ -218,6 +229,70 @@ static uint8_t *mpy_data_get_buf(mpy_info_t *info) {
     return (uint8_t *)info + sizeof(info->mpy_size) + strlen(info->mpy_name) + 1;
 }
 
+/**
+ * Gets the script that follows the given script in the program data.
+ * @param [in]  info    A pointer to an mpy info header.
+ * @return              A pointer to the next mpy info header.
+ */
+static mpy_info_t *mpy_data_get_next(mpy_info_t *info) {
+    return (mpy_info_t *)(mpy_data_get_buf(info) + pbio_get_uint32_le(info->mpy_size));
+}
+
+/**
+ * Gets the hash of a module name (32-bit FNV-1a).
+ * @param [in]  name    Null-terminated module name.
+ * @return              The hash.
+ */
+static uint32_t mpy_data_get_hash(const char *name) {
+    uint32_t hash = 2166136261u;
+    for (const uint8_t *c = (const uint8_t *)name; *c; c++) {
+        hash = (hash ^ *c) * 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * Builds the module index for the program data. The index is stored at the
+ * start of the user RAM, right after the program data.
+ * @param [in]  program The program to run.
+ * @return              The start of the remaining user RAM.
+ */
+static void *mpy_data_init(pbsys_main_program_t *program) {
+
+    mpy_first = (mpy_info_t *)program->code_start;
+    mpy_end = (mpy_info_t *)program->code_end;
+
+    // Index is word aligned, right after the program data.
+    uintptr_t index_start = ((uintptr_t)program->user_ram_start + sizeof(uintptr_t) - 1) & ~(sizeof(uintptr_t) - 1);
+    mpy_index = (mpy_index_entry_t *)index_start;
+    mpy_index_size = 0;
+
+    for (mpy_info_t *info = mpy_first; info < mpy_end; info = mpy_data_get_next(info)) {
+
+        // Don't grow into memory that isn't ours. An incomplete index would
+        // hide modules, so search without an index instead.
+        if ((void *)(mpy_index + mpy_index_size + 1) > program->user_ram_end) {
+            mpy_index = NULL;
+            mpy_index_size = 0;
+            return program->user_ram_start;
+        }
+
+        // Insertion sort by hash. Programs do not have that many modules.
+        mpy_index_entry_t entry = {
+            .hash = mpy_data_get_hash(info->mpy_name),
+            .info = info,
+        };
+        size_t i = mpy_index_size++;
+        while (i > 0 && mpy_index[i - 1].hash > entry.hash) {
+            mpy_index[i] = mpy_index[i - 1];
+            i--;
+        }
+        mpy_index[i] = entry;
+    }
+
+    return mpy_index + mpy_index_size;
+}
+
 /**
  * Finds a MicroPython module in the program data.
  * @param [in]  name    The fully qualified name of the module.
@@ -227,10 +302,34 @@ static uint8_t *mpy_data_get_buf(mpy_info_t *info) {
 static mpy_info_t *mpy_data_find(qstr name) {
     const char *name_str = qstr_str(name);
 
-    for (mpy_info_t *info = mpy_first; info < mpy_end;
-         info = (mpy_info_t *)(mpy_data_get_buf(info) + pbio_get_uint32_le(info->mpy_size))) {
-        if (strcmp(info->mpy_name, name_str) == 0) {
-            return info;
+    // Without an index, compare the names of all modules.
+    if (!mpy_index) {
+        for (mpy_info_t *info = mpy_first; info < mpy_end; info = mpy_data_get_next(info)) {
+            if (strcmp(info->mpy_name, name_str) == 0) {
+                return info;
+            }
+        }
+        return NULL;
+    }
+
+    uint32_t hash = mpy_data_get_hash(name_str);
+
+    // Find the first entry with this hash.
+    size_t low = 0;
+    size_t high = mpy_index_size;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (mpy_index[mid].hash < hash) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    // Compare names of all entries with this hash, in case of collisions.
+    for (size_t i = low; i < mpy_index_size && mpy_index[i].hash == hash; i++) {
+        if (strcmp(mpy_index[i].info->mpy_name, name_str) == 0) {
+            return mpy_index[i].info;
         }
     }
 
@@ -361,12 +460,15 @@ void pbsys_main_run_program(pbsys_main_program_t *program) {
     #endif
     mp_stack_set_limit(MP_STATE_THREAD(stack_top) - stack_start - 1024);
 
-    // MicroPython heap is the free RAM after program data.
-    gc_init(program->user_ram_start, program->user_ram_end);
+    // Index the downloaded modules. This is used to run main, and to find
+    // modules when they are imported.
+    void *heap_start = mpy_data_init(program);
 
-    // Set program data reference to first script. This is used to run main,
-    // and to set the starting point for finding downloaded modules.
-    mpy_data_init(program);
+    // MicroPython heap is the free RAM after program data and module index.
+    gc_init(heap_start, program->user_ram_end);
+    #if PYBRICKS_OPT_HEAP_PROFILER
+    pb_heap_profiler_reset();
+    #endif
 
     // Initialize MicroPython.
     mp_init();
@@ -412,9 +514,15 @@ void pbsys_main_run_program(pbsys_main_program_t *program) {
 }
 
 void gc_collect(void) {
+    #if PYBRICKS_OPT_HEAP_PROFILER
+    uint32_t start = pbdrv_clock_get_us();
+    #endif
     gc_collect_start();
     gc_helper_collect_regs_and_stack();
     gc_collect_end();
+    #if PYBRICKS_OPT_HEAP_PROFILER
+    pb_heap_profiler_add_gc_pause(pbdrv_clock_get_us() - start);
+    #endif
 }
 
 mp_obj_t mp_builtin_open(size_t n_args, const mp_obj_t *args, mp_map_t *kwargs) {
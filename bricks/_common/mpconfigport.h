@@ -10,6 +10,12 @@
 #include <stdint.h>
 #include <pbdrv/config.h>
 
+// Records allocation sites and GC pauses. Enabled with PB_HEAP_PROFILER=1 at
+// build time, since this also wraps the allocator at link time.
+#ifndef PYBRICKS_OPT_HEAP_PROFILER
+#define PYBRICKS_OPT_HEAP_PROFILER              (0)
+#endif
+
 #define MICROPY_BANNER_NAME_AND_VERSION "Pybricks MicroPython " MICROPY_GIT_TAG " on " MICROPY_BUILD_DATE
 
 #define MICROPY_ENABLE_COMPILER                 (PYBRICKS_OPT_COMPILER)
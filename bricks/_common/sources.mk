@@ -101,6 +101,7 @@ PYBRICKS_PYBRICKS_SRC_C = $(addprefix pybricks/,\
 	tools/pb_type_matrix.c \
 	tools/pb_type_stopwatch.c \
 	tools/pb_type_task.c \
+	util_mp/pb_heap_profiler.c \
 	util_mp/pb_obj_helper.c \
 	util_mp/pb_type_enum.c \
 	util_pb/pb_color_map.c \
@@ -155,6 +156,7 @@ PBIO_SRC_C = $(addprefix lib/pbio/,\
 	drv/gpio/gpio_virtual.c \
 	drv/i2c/i2c_ev3.c \
 	drv/imu/imu_lsm6ds3tr_c_stm32.c \
+	drv/imu/imu_virtual_simulation.c \
 	drv/ioport/ioport.c \
 	drv/led/led_array_pwm.c \
 	drv/led/led_array.c \
@@ -191,10 +193,13 @@ PBIO_SRC_C = $(addprefix lib/pbio/,\
 	drv/usb/usb_stm32.c \
 	drv/usb/usb_ev3.c \
 	drv/virtual.c \
+	drv/virtual_replay.c \
 	drv/watchdog/watchdog_stm32.c \
 	platform/$(PBIO_PLATFORM)/platform.c \
 	src/angle.c \
 	src/battery.c \
+	src/broadcast.c \
+	src/clock_sync.c \
 	src/color/conversion.c \
 	src/color/util.c \
 	src/control.c \
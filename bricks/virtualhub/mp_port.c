@@ -16,6 +16,7 @@
 
 #include "pbio_os_config.h"
 
+#include <pbdrv/clock.h>
 #include <pbio/main.h>
 #include <pbio/os.h>
 #include <pbsys/core.h>
@@ -118,6 +119,15 @@ void pbio_os_hook_wait_for_interrupt(pbio_os_irq_flags_t flags) {
         .tv_sec = 0,
         .tv_nsec = 100000,
     };
+
+    // With virtual time, nothing else is going to happen while we are idle,
+    // so skip ahead to the next tick instead of sleeping. Signals are still
+    // handled, but without waiting for them.
+    if (pbdrv_clock_linux_is_virtual_time()) {
+        timeout.tv_nsec = 0;
+        pbdrv_clock_linux_advance_virtual_time(1000);
+    }
+
     // "sleep" with "interrupts" enabled
     sigset_t origmask = flags;
     MP_THREAD_GIL_EXIT();
@@ -126,6 +136,12 @@ void pbio_os_hook_wait_for_interrupt(pbio_os_irq_flags_t flags) {
 }
 
 void pb_virtualhub_delay_us(mp_uint_t us) {
+    if (pbdrv_clock_linux_is_virtual_time()) {
+        pbdrv_clock_linux_advance_virtual_time(us);
+        MICROPY_VM_HOOK_LOOP;
+        return;
+    }
+
     mp_uint_t start = mp_hal_ticks_us();
 
     while (mp_hal_ticks_us() - start < us) {
@@ -12,7 +12,7 @@
 #define PYBRICKS_PY_COMMON_CHARGER      (1)
 #define PYBRICKS_PY_COMMON_COLOR_LIGHT  (1)
 #define PYBRICKS_PY_COMMON_CONTROL      (1)
-#define PYBRICKS_PY_COMMON_IMU          (0)
+#define PYBRICKS_PY_COMMON_IMU          (1)
 #define PYBRICKS_PY_COMMON_KEYPAD       (1)
 #define PYBRICKS_PY_COMMON_KEYPAD_HUB_BUTTONS (1)
 #define PYBRICKS_PY_COMMON_LIGHT_ARRAY  (1)
@@ -35,6 +35,7 @@
 #define PYBRICKS_PY_PUPDEVICES_REMOTE   (0)
 #define PYBRICKS_PY_DEVICES             (1)
 #define PYBRICKS_PY_ROBOTICS            (1)
+#define PYBRICKS_PY_ROBOTICS_DRIVEBASE_GYRO (1)
 #define PYBRICKS_PY_ROBOTICS_DRIVEBASE_SPIKE (0)
 #define PYBRICKS_PY_TOOLS               (1)
 #define PYBRICKS_PY_TOOLS_HUB_MENU      (0)
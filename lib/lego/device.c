@@ -54,3 +54,27 @@ uint32_t lego_device_data_set_delay(lego_device_type_id_t id, uint8_t mode) {
     // the light on the color sensor and ultrasonic sensor.
     return 10;
 }
+
+/**
+ * Gets the fastest baud rate that the device can use after synchronization.
+ *
+ * Devices advertise the standard rate during synchronization, but some can
+ * go faster when asked to.
+ *
+ * @param [in]  id          The device type ID.
+ * @return                  Baud rate, or 0 if the device should keep the advertised rate.
+ */
+uint32_t lego_device_fast_baud_rate(lego_device_type_id_t id) {
+    // Only add devices here once they have been confirmed to work reliably at
+    // the faster rate on real hubs. None have been so far.
+    switch (id) {
+        #if PBIO_TEST_BUILD
+        // Used by the emulated device tests to cover the switch and the
+        // fallback to the advertised rate.
+        case LEGO_DEVICE_TYPE_ID_TECHNIC_M_ANGULAR_MOTOR:
+            return 230400;
+        #endif
+        default:
+            return 0;
+    }
+}
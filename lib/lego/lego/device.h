@@ -373,4 +373,6 @@ uint32_t lego_device_stale_data_delay(lego_device_type_id_t id, uint8_t mode);
 
 uint32_t lego_device_data_set_delay(lego_device_type_id_t id, uint8_t mode);
 
+uint32_t lego_device_fast_baud_rate(lego_device_type_id_t id);
+
 #endif // _LEGO_DEVICES_H_
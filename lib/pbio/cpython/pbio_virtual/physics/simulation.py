@@ -1,7 +1,7 @@
 # SPDX-License-Identifier: MIT
 # Copyright (c) 2022 The Pybricks Authors
 
-from numpy import array, zeros, concatenate
+from numpy import arange, concatenate, zeros
 from abc import ABC, abstractmethod
 
 
@@ -10,6 +10,10 @@ class SimulationModel(ABC):
 
     This class provides generic simulation code. Each subclass must provide
     its own equations of motion by overriding the state change function.
+
+    Results are kept in preallocated ring buffers that hold the most recent
+    ``HISTORY`` samples, so the cost per simulated step does not grow as the
+    simulation keeps running.
     """
 
     # These tuples should be used to name all the relevant signals.
@@ -20,6 +24,9 @@ class SimulationModel(ABC):
     # Simulation time step (expressed in seconds).
     DT = 0.0001
 
+    # Number of most recent samples kept for output lookups (1 second).
+    HISTORY = 10000
+
     def __init__(self, t0=0, x0=None):
         """Initializes the system with initial conditions.
 
@@ -33,14 +40,21 @@ class SimulationModel(ABC):
         self.m = len(self.INPUTS)
         self.p = len(self.OUTPUTS)
 
-        # Empty buffers to hold results, starting with the initial time/state.
-        self.times = array([t0])
-        self.states = zeros((self.n, 1)) if x0 is None else x0.reshape(self.n, 1)
-        self.outputs = self.output(t0, x0).reshape(self.p, 1)
+        # Ring buffers to hold results. Sample k is taken at t0 + k * DT and
+        # is stored at index k % HISTORY.
+        self.t0 = t0
+        self.samples = 0
+        self.state_buffer = zeros((self.n, self.HISTORY))
+        self.output_buffer = zeros((self.p, self.HISTORY))
+
+        # State at the next sample, which is not yet stored.
+        self.state = zeros(self.n) if x0 is None else x0.reshape(self.n)
+
+        # Externally set input, used until something else is set.
+        self.input = zeros(self.m)
 
-        # Empty buffers to hold externally set input data.
-        self.input_values = zeros((self.m, 1))
-        self.input_times = array([t0])
+        # Store the initial state as the first sample.
+        self.simulate(t0)
 
     def actuate(self, t, u):
         """Sets the actuation state of the system. This will be used by
@@ -50,8 +64,7 @@ class SimulationModel(ABC):
             t (float): Current time.
             u (array): Control signal vector.
         """
-        self.input_times = concatenate((self.input_times, array([t])))
-        self.input_values = concatenate((self.input_values, u.reshape(self.m, 1)), axis=1)
+        self.input = u.reshape(self.m)
 
     def simulate(self, time_end):
         """Simulates the system until time_end, subject to the ongoing input.
@@ -61,45 +74,60 @@ class SimulationModel(ABC):
 
         Arguments:
             te (float): End time.
-
-        Returns:
-            tuple: Time (array: 1 x samples) and
-                   state vector at all time samples (n x samples).
         """
 
-        # Time samples for this segment
-        t0 = self.times[-1]
-        nsamples = int((time_end - t0) / self.DT) + 1
-        times = array([t0 + i * self.DT for i in range(nsamples)])
+        # Number of samples up to and including the end time.
+        end = int(round((time_end - self.t0) / self.DT, 6)) + 1
+        if end <= self.samples:
+            return
 
         # Continue using last input.
-        u = self.input_values[:, -1]
-
-        # Create empty state vector samples
-        states = zeros((self.n, nsamples))
-        outputs = zeros((self.p, nsamples))
+        u = self.input
+        dt = self.DT
+        state = self.state
 
-        # Start at current state
-        state = self.states[:, -1]
-
-        # Evaluate RK4 integration for all time steps
-        for i, t in enumerate(times):
+        # Evaluate RK4 integration for all new time steps.
+        for k in range(self.samples, end):
+            t = self.t0 + k * dt
+            i = k % self.HISTORY
 
             # Save the state and output
-            states[:, i] = state
-            outputs[:, i] = self.output(t, state)
+            self.state_buffer[:, i] = state
+            self.output_buffer[:, i] = self.output(t, state)
 
             # Single RK4 step to evaluate the next state.
             k1 = self.state_change(t, state, u)
-            k2 = self.state_change(t + self.DT / 2, state + self.DT * k1 / 2, u)
-            k3 = self.state_change(t + self.DT / 2, state + self.DT * k2 / 2, u)
-            k4 = self.state_change(t + self.DT, state + self.DT * k3, u)
-            state = state + self.DT / 6 * (k1 + 2 * k2 + 2 * k3 + k4)
+            k2 = self.state_change(t + dt / 2, state + dt * k1 / 2, u)
+            k3 = self.state_change(t + dt / 2, state + dt * k2 / 2, u)
+            k4 = self.state_change(t + dt, state + dt * k3, u)
+            state = state + dt / 6 * (k1 + 2 * k2 + 2 * k3 + k4)
+
+        self.state = state
+        self.samples = end
 
-        # Concatenate results
-        self.times = concatenate((self.times, times))
-        self.states = concatenate((self.states, states), axis=1)
-        self.outputs = concatenate((self.outputs, outputs), axis=1)
+    def history(self):
+        """Gets the samples that are still available, oldest first.
+
+        Returns:
+            tuple: Time (array: samples), state vectors (n x samples) and
+                   output vectors (p x samples).
+        """
+        first = max(0, self.samples - self.HISTORY)
+        times = self.t0 + arange(first, self.samples) * self.DT
+
+        # Unwrap the ring buffers.
+        split = first % self.HISTORY
+        if self.samples < self.HISTORY:
+            states = self.state_buffer[:, : self.samples]
+            outputs = self.output_buffer[:, : self.samples]
+        else:
+            states = concatenate(
+                (self.state_buffer[:, split:], self.state_buffer[:, :split]), axis=1
+            )
+            outputs = concatenate(
+                (self.output_buffer[:, split:], self.output_buffer[:, :split]), axis=1
+            )
+        return times, states, outputs
 
     @abstractmethod
     def state_change(self, t, x, u):
@@ -142,15 +170,21 @@ class SimulationModel(ABC):
         Returns:
             array: The output vector.
         """
-        # If time is in the past, interpolate from available results.
-        if time < self.times[-1]:
-
-            # Find first index larger than given time, which always exists.
-            i = next(i for i, t in enumerate(self.times) if t > time)
-
-            # Interpolate output in time
-            ratio = (time - self.times[i - 1]) / (self.times[i] - self.times[i - 1])
-            return self.outputs[:, i - 1] + ratio * (self.outputs[:, i] - self.outputs[:, i - 1])
+        latest = self.samples - 1
+
+        # Sample at or just before the requested time.
+        k = int((time - self.t0) / self.DT)
+
+        # If time is in the past, interpolate from available results. Anything
+        # older than the history window uses the oldest available sample.
+        if k < latest:
+            k = max(k, self.samples - self.HISTORY)
+            i = k % self.HISTORY
+            j = (k + 1) % self.HISTORY
+            ratio = min(max((time - self.t0) / self.DT - k, 0), 1)
+            return self.output_buffer[:, i] + ratio * (
+                self.output_buffer[:, j] - self.output_buffer[:, i]
+            )
 
         # Return latest available data.
-        return self.outputs[:, -1]
+        return self.output_buffer[:, latest % self.HISTORY]
@@ -10,10 +10,19 @@
 #include <pbdrv/battery.h>
 #include <pbio/error.h>
 
+#include "../virtual_replay.h"
+
 void pbdrv_battery_init(void) {
 }
 
 pbio_error_t pbdrv_battery_get_voltage_now(uint16_t *value) {
+    #if PBDRV_CONFIG_VIRTUAL_REPLAY
+    const int32_t *row = pbdrv_virtual_replay_get_row(PBDRV_VIRTUAL_REPLAY_TRACE_BATTERY, 2);
+    if (row) {
+        *value = row[1];
+        return PBIO_SUCCESS;
+    }
+    #endif
     *value = 7200;
     return PBIO_SUCCESS;
 }
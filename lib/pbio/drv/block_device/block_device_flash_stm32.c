@@ -17,6 +17,7 @@
 #include <pbdrv/block_device.h>
 
 #include <pbio/error.h>
+#include <pbio/int_math.h>
 #include <pbio/util.h>
 
 #include STM32_HAL_H
@@ -43,37 +44,57 @@ PT_THREAD(pbdrv_block_device_read(struct pt *pt, uint32_t offset, uint8_t *buffe
     PT_END(pt);
 }
 
+pbio_error_t pbdrv_block_device_get_mapped_data(uint32_t offset, uint32_t size, const uint8_t **data) {
+
+    if (offset + size > PBDRV_CONFIG_BLOCK_DEVICE_FLASH_STM32_SIZE) {
+        return PBIO_ERROR_INVALID_ARG;
+    }
+
+    // Internal flash is memory mapped, so data can be used in place.
+    *data = _pbdrv_block_device_storage_start + offset;
+    return PBIO_SUCCESS;
+}
+
 typedef union _double_word_t {
     uint8_t data[8];
     uint64_t dword;
 } double_word_t;
 
-static pbio_error_t block_device_erase_and_write(uint8_t *buffer, uint32_t size) {
+static pbio_error_t block_device_erase_and_write(uint8_t *buffer, uint32_t size, uint32_t start, uint32_t end) {
 
     static const uint32_t base_address = (uint32_t)(&_pbdrv_block_device_storage_start[0]);
 
-    // Exit if size is 0, too big, or not a multiple of double-word size.
-    if (size == 0 || size > PBDRV_CONFIG_BLOCK_DEVICE_FLASH_STM32_SIZE || size % sizeof(uint64_t)) {
+    // Exit if size is too big or not a multiple of double-word size.
+    if (size > PBDRV_CONFIG_BLOCK_DEVICE_FLASH_STM32_SIZE || size % sizeof(uint64_t) || end > PBDRV_CONFIG_BLOCK_DEVICE_FLASH_STM32_SIZE) {
         return PBIO_ERROR_INVALID_ARG;
     }
 
+    // Nothing to do if nothing changed.
+    if (start >= end) {
+        return PBIO_SUCCESS;
+    }
+
+    // Pages that overlap with the changed data.
+    uint32_t first_page = start / FLASH_PAGE_SIZE;
+    uint32_t last_page = (end + FLASH_PAGE_SIZE - 1) / FLASH_PAGE_SIZE;
+
     // Unlock flash for writing.
     HAL_StatusTypeDef hal_err = HAL_FLASH_Unlock();
     if (hal_err != HAL_OK) {
         return PBIO_ERROR_IO;
     }
 
-    // Erase the whole user storage area.
+    // Erase only the changed pages.
     FLASH_EraseInitTypeDef erase_init = {
         #if defined(STM32F0)
-        .PageAddress = base_address,
+        .PageAddress = base_address + first_page * FLASH_PAGE_SIZE,
         #elif defined(STM32L4)
         .Banks = FLASH_BANK_1, // Hard coded for STM32L431RC.
-        .Page = (FLASH_SIZE - (PBDRV_CONFIG_BLOCK_DEVICE_FLASH_STM32_SIZE)) / FLASH_PAGE_SIZE,
+        .Page = (FLASH_SIZE - (PBDRV_CONFIG_BLOCK_DEVICE_FLASH_STM32_SIZE)) / FLASH_PAGE_SIZE + first_page,
         #else
         #error "Unsupported target."
         #endif
-        .NbPages = PBDRV_CONFIG_BLOCK_DEVICE_FLASH_STM32_SIZE / FLASH_PAGE_SIZE,
+        .NbPages = last_page - first_page,
         .TypeErase = FLASH_TYPEERASE_PAGES
     };
 
@@ -90,9 +111,10 @@ static pbio_error_t block_device_erase_and_write(uint8_t *buffer, uint32_t size)
         return PBIO_ERROR_IO;
     }
 
-    // Write data chunk by chunk.
-    uint32_t done = 0;
-    while (done < size) {
+    // Write data chunk by chunk, up to the end of the erased pages.
+    uint32_t done = first_page * FLASH_PAGE_SIZE;
+    uint32_t write_end = pbio_int_math_min(last_page * FLASH_PAGE_SIZE, size);
+    while (done < write_end) {
 
         // Disable interrupts while writing as above.
         state = __get_PRIMASK();
@@ -116,9 +138,9 @@ static pbio_error_t block_device_erase_and_write(uint8_t *buffer, uint32_t size)
     return PBIO_SUCCESS;
 }
 
-PT_THREAD(pbdrv_block_device_store(struct pt *pt, uint8_t *buffer, uint32_t size, pbio_error_t *err)) {
+PT_THREAD(pbdrv_block_device_store(struct pt *pt, uint8_t *buffer, uint32_t size, uint32_t start, uint32_t end, pbio_error_t *err)) {
     PT_BEGIN(pt);
-    *err = block_device_erase_and_write(buffer, size);
+    *err = block_device_erase_and_write(buffer, size, start, end);
     PT_END(pt);
 }
 
@@ -14,10 +14,13 @@
 
 #include <pbdrv/block_device.h>
 
+#include <pbio/int_math.h>
 #include <pbio/version.h>
 
 #include <pbsys/storage.h>
 
+#include "block_device_test.h"
+
 /**
 The following script is compiled using pybricksdev compile hello.py in MULTI_MPY_V6.
 
@@ -60,7 +63,7 @@ static const uint8_t _program_data[] = {
 
 static struct {
     uint32_t write_size;
-    uint8_t user_data[PBSYS_CONFIG_STORAGE_USER_DATA_SIZE];
+    uint8_t user_data[PBDRV_CONFIG_BLOCK_DEVICE_TEST_SIZE_USER];
     char stored_firmware_hash[8];
     pbsys_storage_settings_t settings;
     uint32_t program_offset;
@@ -68,17 +71,46 @@ static struct {
     uint8_t program_data[sizeof(_program_data)];
 } blockdev = { 0 };
 
+/**
+ * Emulated storage, erased to 0xFF like real flash.
+ */
+static uint8_t storage[PBDRV_CONFIG_BLOCK_DEVICE_TEST_SIZE];
+
+/**
+ * Size of one erase block of the emulated storage.
+ */
+#define BLOCK_DEVICE_TEST_ERASE_SIZE (1024)
+
+/**
+ * Number of times each erase block was erased, to verify wear in tests.
+ */
+static uint32_t erase_count[PBDRV_CONFIG_BLOCK_DEVICE_TEST_SIZE / BLOCK_DEVICE_TEST_ERASE_SIZE];
+
+#if PBIO_TEST_BUILD
+// There is no MicroPython version in the unit tests.
+#define MICROPY_GIT_HASH "pbiotest"
+#else
 // Information from MicroPython should not be used in the pbdrv drivers but it
 // is permissible for this test. It ensures we can place the expected git
 // version at the right place. FIXME: Move the git version to pybricks build
 // system, since it isn't actually the micropython git version.
 #include "genhdr/mpversion.h"
+#endif
 
 void pbdrv_block_device_init(void) {
-    blockdev.write_size = sizeof(blockdev) + sizeof(_program_data);
+    blockdev.write_size = sizeof(blockdev);
     blockdev.program_size = sizeof(_program_data);
     memcpy(&blockdev.stored_firmware_hash[0], MICROPY_GIT_HASH, sizeof(blockdev.stored_firmware_hash));
     memcpy(&blockdev.program_data[0], _program_data, sizeof(_program_data));
+
+    // Start with the program above on otherwise erased storage.
+    memset(storage, 0xFF, sizeof(storage));
+    memcpy(storage, &blockdev, sizeof(blockdev));
+    memset(erase_count, 0, sizeof(erase_count));
+}
+
+uint32_t pbdrv_block_device_test_get_erase_count(uint32_t offset) {
+    return erase_count[offset / BLOCK_DEVICE_TEST_ERASE_SIZE];
 }
 
 PT_THREAD(pbdrv_block_device_read(struct pt *pt, uint32_t offset, uint8_t *buffer, uint32_t size, pbio_error_t *err)) {
@@ -92,17 +124,44 @@ PT_THREAD(pbdrv_block_device_read(struct pt *pt, uint32_t offset, uint8_t *buffe
     }
 
     // Copy requested data to RAM.
-    memcpy(buffer, (uint8_t *)&blockdev + offset, size);
+    memcpy(buffer, storage + offset, size);
     *err = PBIO_SUCCESS;
 
     PT_END(pt);
 }
 
-// Don't store any data in this implementation.
-PT_THREAD(pbdrv_block_device_store(struct pt *pt, uint8_t *buffer, uint32_t size, pbio_error_t *err)) {
+pbio_error_t pbdrv_block_device_get_mapped_data(uint32_t offset, uint32_t size, const uint8_t **data) {
+
+    if (offset + size > PBDRV_CONFIG_BLOCK_DEVICE_TEST_SIZE) {
+        return PBIO_ERROR_INVALID_ARG;
+    }
+
+    *data = storage + offset;
+    return PBIO_SUCCESS;
+}
+
+PT_THREAD(pbdrv_block_device_store(struct pt *pt, uint8_t *buffer, uint32_t size, uint32_t start, uint32_t end, pbio_error_t *err)) {
+
     PT_BEGIN(pt);
+
+    // Exit on invalid size.
+    if (size > PBDRV_CONFIG_BLOCK_DEVICE_TEST_SIZE || end > PBDRV_CONFIG_BLOCK_DEVICE_TEST_SIZE) {
+        *err = PBIO_ERROR_INVALID_ARG;
+        PT_EXIT(pt);
+    }
+
+    // Erase and rewrite the blocks that overlap with the changed data.
+    for (uint32_t block = start / BLOCK_DEVICE_TEST_ERASE_SIZE; block * BLOCK_DEVICE_TEST_ERASE_SIZE < end; block++) {
+        uint32_t offset = block * BLOCK_DEVICE_TEST_ERASE_SIZE;
+        memset(storage + offset, 0xFF, BLOCK_DEVICE_TEST_ERASE_SIZE);
+        erase_count[block]++;
+        if (offset < size) {
+            memcpy(storage + offset, buffer + offset, pbio_int_math_min(size - offset, BLOCK_DEVICE_TEST_ERASE_SIZE));
+        }
+    }
     *err = PBIO_SUCCESS;
+
     PT_END(pt);
 }
 
-#endif // PBDRV_CONFIG_BLOCK_DEVICE_FLASH_STM32
+#endif // PBDRV_CONFIG_BLOCK_DEVICE_TEST
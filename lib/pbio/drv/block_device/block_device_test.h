@@ -0,0 +1,18 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 The Pybricks Authors
+
+#ifndef _INTERNAL_PBDRV_BLOCK_DEVICE_TEST_H_
+#define _INTERNAL_PBDRV_BLOCK_DEVICE_TEST_H_
+
+#include <stdint.h>
+
+#include <pbdrv/config.h>
+
+#if PBDRV_CONFIG_BLOCK_DEVICE_TEST
+
+// this can be used by tests to check which blocks were erased
+uint32_t pbdrv_block_device_test_get_erase_count(uint32_t offset);
+
+#endif // PBDRV_CONFIG_BLOCK_DEVICE_TEST
+
+#endif // _INTERNAL_PBDRV_BLOCK_DEVICE_TEST_H_
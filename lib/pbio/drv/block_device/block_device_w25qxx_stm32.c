@@ -398,6 +398,14 @@ out:
     PT_END(pt);
 }
 
+pbio_error_t pbdrv_block_device_get_mapped_data(uint32_t offset, uint32_t size, const uint8_t **data) {
+    // External flash is only accessible through SPI commands. The chip is
+    // wired to a regular SPI peripheral with one data line in each direction,
+    // not to the QUADSPI pins, so it can't be memory mapped on these hubs.
+    // Programs are loaded into RAM instead.
+    return PBIO_ERROR_NOT_SUPPORTED;
+}
+
 /**
  * Write or erase one chunk of data from flash.
  *
@@ -457,21 +465,29 @@ static PT_THREAD(flash_erase_or_write(struct pt *pt, uint32_t address, uint8_t *
     PT_END(pt);
 }
 
-PT_THREAD(pbdrv_block_device_store(struct pt *pt, uint8_t *buffer, uint32_t size, pbio_error_t *err)) {
+PT_THREAD(pbdrv_block_device_store(struct pt *pt, uint8_t *buffer, uint32_t size, uint32_t start, uint32_t end, pbio_error_t *err)) {
 
     static struct pt child;
     static uint32_t offset;
     static uint32_t size_now;
     static uint32_t size_done;
+    static uint32_t erase_start;
+    static uint32_t erase_end;
 
     PT_BEGIN(pt);
 
     // Exit on invalid size.
-    if (size == 0 || size > PBDRV_CONFIG_BLOCK_DEVICE_W25QXX_STM32_SIZE) {
+    if (size > PBDRV_CONFIG_BLOCK_DEVICE_W25QXX_STM32_SIZE || end > PBDRV_CONFIG_BLOCK_DEVICE_W25QXX_STM32_SIZE) {
         *err = PBIO_ERROR_INVALID_ARG;
         PT_EXIT(pt);
     }
 
+    // Nothing to do if nothing changed.
+    if (start >= end) {
+        *err = PBIO_SUCCESS;
+        PT_EXIT(pt);
+    }
+
     if (bdev.process) {
         *err = PBIO_ERROR_BUSY;
         PT_EXIT(pt);
@@ -479,8 +495,12 @@ PT_THREAD(pbdrv_block_device_store(struct pt *pt, uint8_t *buffer, uint32_t size
 
     bdev.process = PROCESS_CURRENT();
 
+    // Only the sectors that overlap with the changed data are rewritten.
+    erase_start = start / FLASH_SIZE_ERASE * FLASH_SIZE_ERASE;
+    erase_end = (end + FLASH_SIZE_ERASE - 1) / FLASH_SIZE_ERASE * FLASH_SIZE_ERASE;
+
     // Erase sector by sector.
-    for (offset = 0; offset < size; offset += FLASH_SIZE_ERASE) {
+    for (offset = erase_start; offset < erase_end; offset += FLASH_SIZE_ERASE) {
         // Writing size 0 means erase.
         PT_SPAWN(pt, &child, flash_erase_or_write(&child,
             PBDRV_CONFIG_BLOCK_DEVICE_W25QXX_STM32_START_ADDRESS + offset, NULL, 0, err));
@@ -489,9 +509,9 @@ PT_THREAD(pbdrv_block_device_store(struct pt *pt, uint8_t *buffer, uint32_t size
         }
     }
 
-    // Write page by page.
-    for (size_done = 0; size_done < size; size_done += size_now) {
-        size_now = pbio_int_math_min(size - size_done, FLASH_SIZE_WRITE);
+    // Write page by page, up to the end of the erased sectors.
+    for (size_done = erase_start; size_done < pbio_int_math_min(erase_end, size); size_done += size_now) {
+        size_now = pbio_int_math_min(pbio_int_math_min(erase_end, size) - size_done, FLASH_SIZE_WRITE);
         PT_SPAWN(pt, &child, flash_erase_or_write(&child,
             PBDRV_CONFIG_BLOCK_DEVICE_W25QXX_STM32_START_ADDRESS + size_done, buffer + size_done, size_now, err));
         if (*err != PBIO_SUCCESS) {
@@ -711,6 +711,14 @@ bool pbdrv_bluetooth_is_connected(pbdrv_bluetooth_connection_t connection) {
     return false;
 }
 
+uint16_t pbdrv_bluetooth_get_mtu(void) {
+    if (pybricks_con_handle == HCI_CON_HANDLE_INVALID) {
+        return ATT_DEFAULT_MTU;
+    }
+
+    return att_server_get_mtu(pybricks_con_handle);
+}
+
 void pbdrv_bluetooth_set_on_event(pbdrv_bluetooth_on_event_t on_event) {
     bluetooth_on_event = on_event;
 }
@@ -397,6 +397,13 @@ bool pbdrv_bluetooth_is_connected(pbdrv_bluetooth_connection_t connection) {
     return false;
 }
 
+// Notifications are copied into a buffer of this size by ATT_HandleValueNoti().
+_Static_assert(PBDRV_BLUETOOTH_MAX_MTU_SIZE <= ATT_MAX_MTU_SIZE, "MTU too large for ATT buffers");
+
+uint16_t pbdrv_bluetooth_get_mtu(void) {
+    return conn_handle == NO_CONNECTION ? ATT_MTU_SIZE : conn_mtu;
+}
+
 void pbdrv_bluetooth_set_on_event(pbdrv_bluetooth_on_event_t on_event) {
     bluetooth_on_event = on_event;
 }
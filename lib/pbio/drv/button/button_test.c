@@ -10,6 +10,8 @@
 #include <pbio/button.h>
 #include <pbio/error.h>
 
+#include "../virtual_replay.h"
+
 static pbio_button_flags_t pbio_test_button_flags;
 
 void pbio_test_button_set_pressed(pbio_button_flags_t flags) {
@@ -20,6 +22,13 @@ void pbdrv_button_init(void) {
 }
 
 pbio_error_t pbdrv_button_is_pressed(pbio_button_flags_t *pressed) {
+    #if PBDRV_CONFIG_VIRTUAL_REPLAY
+    const int32_t *row = pbdrv_virtual_replay_get_row(PBDRV_VIRTUAL_REPLAY_TRACE_BUTTON, 2);
+    if (row) {
+        *pressed = row[1];
+        return PBIO_SUCCESS;
+    }
+    #endif
     *pressed = pbio_test_button_flags;
     return PBIO_SUCCESS;
 }
@@ -5,12 +5,48 @@
 
 #if PBDRV_CONFIG_CLOCK_LINUX
 
+#include <stdbool.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <time.h>
 #include <unistd.h>
 
+#include <contiki.h>
+
+#include <pbdrv/clock.h>
 #include <pbio/os.h>
 
+// When PBIO_VIRTUAL_TIME is set in the environment, the clock does not follow
+// the wall clock. Instead, time only moves when the port advances it, which
+// makes runs deterministic and lets idle waits complete instantly.
+static bool virtual_time;
+static uint64_t virtual_time_us;
+
+static void pbdrv_clock_linux_virtual_time_init(void) {
+    virtual_time = getenv("PBIO_VIRTUAL_TIME") != NULL;
+    virtual_time_us = 0;
+}
+
+bool pbdrv_clock_linux_is_virtual_time(void) {
+    return virtual_time;
+}
+
+void pbdrv_clock_linux_advance_virtual_time(uint32_t us) {
+    if (!virtual_time) {
+        return;
+    }
+
+    uint64_t prev_ms = virtual_time_us / 1000;
+    virtual_time_us += us;
+
+    // Same as the 1ms tick on embedded systems, but only when a millisecond
+    // boundary is crossed.
+    if (virtual_time_us / 1000 != prev_ms) {
+        etimer_request_poll();
+        pbio_os_request_poll();
+    }
+}
+
 // The SIGNAL option adds a timer that acts as the 1ms tick on embedded systems.
 
 #if PBDRV_CONFIG_CLOCK_LINUX_SIGNAL
@@ -20,8 +56,6 @@
 #include <signal.h>
 #include <stdio.h>
 
-#include <contiki.h>
-
 #define NSEC_PER_MSEC       1000000
 
 #define TIMER_SIGNAL        SIGRTMIN
@@ -46,6 +80,13 @@ void pbdrv_clock_init(void) {
     static timer_t clock_timer;
     int err;
 
+    pbdrv_clock_linux_virtual_time_init();
+
+    // Virtual time is advanced by the port instead of the timer signal.
+    if (virtual_time) {
+        return;
+    }
+
     main_thread = pthread_self();
 
     // set up 1ms tick using signal
@@ -90,29 +131,43 @@ void pbdrv_clock_init(void) {
 #else // PBDRV_CONFIG_CLOCK_LINUX_SIGNAL
 
 void pbdrv_clock_init(void) {
+    pbdrv_clock_linux_virtual_time_init();
 }
 
 #endif // PBDRV_CONFIG_CLOCK_LINUX_SIGNAL
 
 uint32_t pbdrv_clock_get_ms(void) {
+    if (virtual_time) {
+        return virtual_time_us / 1000;
+    }
     struct timespec time_val;
     clock_gettime(CLOCK_MONOTONIC_RAW, &time_val);
     return time_val.tv_sec * 1000 + time_val.tv_nsec / 1000000;
 }
 
 uint32_t pbdrv_clock_get_100us(void) {
+    if (virtual_time) {
+        return virtual_time_us / 100;
+    }
     struct timespec time_val;
     clock_gettime(CLOCK_MONOTONIC_RAW, &time_val);
     return time_val.tv_sec * 10000 + time_val.tv_nsec / 100000;
 }
 
 uint32_t pbdrv_clock_get_us(void) {
+    if (virtual_time) {
+        return virtual_time_us;
+    }
     struct timespec time_val;
     clock_gettime(CLOCK_MONOTONIC_RAW, &time_val);
     return time_val.tv_sec * 1000000 + time_val.tv_nsec / 1000;
 }
 
 void pbdrv_clock_busy_delay_ms(uint32_t ms) {
+    if (virtual_time) {
+        pbdrv_clock_linux_advance_virtual_time(ms * 1000);
+        return;
+    }
     uint32_t start = pbdrv_clock_get_ms();
     while (pbdrv_clock_get_ms() - start < ms) {
     }
@@ -0,0 +1,65 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2025 The Pybricks Authors
+
+// Software IMU implementation for feeding samples in tests
+
+#include <pbdrv/config.h>
+
+#if PBDRV_CONFIG_IMU_TEST
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <pbdrv/imu.h>
+
+#include "imu_test.h"
+
+struct _pbdrv_imu_dev_t {
+    /** IMU configuration to convert raw data to physical units. */
+    pbdrv_imu_config_t config;
+    /** Callback to process one frame of unfiltered gyro and accelerometer data. */
+    pbdrv_imu_handle_frame_data_func_t handle_frame_data;
+    /* Callback to process unfiltered gyro and accelerometer data recorded while stationary. */
+    pbdrv_imu_handle_stationary_data_func_t handle_stationary_data;
+};
+
+static pbdrv_imu_dev_t global_imu_dev;
+
+void pbio_test_imu_handle_frame_data(int16_t *data) {
+    if (global_imu_dev.handle_frame_data) {
+        global_imu_dev.handle_frame_data(data);
+    }
+}
+
+// internal driver interface implementation
+
+void pbdrv_imu_init(void) {
+    pbdrv_imu_dev_t *imu_dev = &global_imu_dev;
+
+    // Same as the LSM6DS3TR-C at 833 Hz, 2000 dps and 8 g full scale.
+    imu_dev->config.sample_time = 1.0f / 833;
+    imu_dev->config.gyro_scale = 0.07f;
+    imu_dev->config.accel_scale = 0.244f * 9.81f;
+    imu_dev->config.gyro_stationary_threshold = 1;
+    imu_dev->config.accel_stationary_threshold = 1;
+}
+
+// public driver interface implementation
+
+pbio_error_t pbdrv_imu_get_imu(pbdrv_imu_dev_t **imu_dev, pbdrv_imu_config_t **config) {
+    *imu_dev = &global_imu_dev;
+    *config = &global_imu_dev.config;
+    return PBIO_SUCCESS;
+}
+
+void pbdrv_imu_set_data_handlers(pbdrv_imu_dev_t *imu_dev, pbdrv_imu_handle_frame_data_func_t frame_data_func, pbdrv_imu_handle_stationary_data_func_t stationary_data_func) {
+    imu_dev->handle_frame_data = frame_data_func;
+    imu_dev->handle_stationary_data = stationary_data_func;
+}
+
+bool pbdrv_imu_is_stationary(pbdrv_imu_dev_t *imu_dev) {
+    // Tests only give moving samples.
+    return false;
+}
+
+#endif // PBDRV_CONFIG_IMU_TEST
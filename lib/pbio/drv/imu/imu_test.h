@@ -0,0 +1,18 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2025 The Pybricks Authors
+
+#ifndef _INTERNAL_PBDRV_IMU_TEST_H_
+#define _INTERNAL_PBDRV_IMU_TEST_H_
+
+#include <pbdrv/config.h>
+
+#if PBDRV_CONFIG_IMU_TEST
+
+#include <stdint.h>
+
+// this can be used by tests that consume the imu driver
+void pbio_test_imu_handle_frame_data(int16_t *data);
+
+#endif // PBDRV_CONFIG_IMU_TEST
+
+#endif // _INTERNAL_PBDRV_IMU_TEST_H_
@@ -0,0 +1,151 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2025 The Pybricks Authors
+
+// IMU driver that reports the motion of the simulated drive base.
+
+#include <pbdrv/config.h>
+
+#if PBDRV_CONFIG_IMU_VIRTUAL_SIMULATION
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <pbdrv/imu.h>
+
+#include <pbio/util.h>
+
+#include "imu_virtual_simulation.h"
+
+/** Simulated sample rate, equal to the simulation tick rate. */
+#define IMU_VIRTUAL_SIMULATION_DATA_RATE (1000)
+
+struct _pbdrv_imu_dev_t {
+    /** IMU configuration to convert raw data to phsyical units. */
+    pbdrv_imu_config_t config;
+    /** Callback to process one frame of unfiltered gyro and accelerometer data. */
+    pbdrv_imu_handle_frame_data_func_t handle_frame_data;
+    /* Callback to process unfiltered gyro and accelerometer data recorded while stationary. */
+    pbdrv_imu_handle_stationary_data_func_t handle_stationary_data;
+    /** Latest raw data. */
+    int16_t data[6];
+    /** Raw data point to which new samples are compared to detect stationary. */
+    int16_t stationary_data_start[6];
+    /** Sum of gyro samples during the stationary period. */
+    int32_t stationary_gyro_data_sum[3];
+    /** Sum of accelerometer samples during the stationary period. */
+    int32_t stationary_accel_data_sum[3];
+    /** Number of sequential stationary samples. */
+    uint32_t stationary_sample_count;
+    /** Whether it is currently stationary, to be polled by higher level APIs. */
+    bool stationary_now;
+};
+
+static pbdrv_imu_dev_t global_imu_dev;
+
+static inline bool is_bounded(int16_t diff, int16_t threshold) {
+    return diff < threshold && diff > -threshold;
+}
+
+static int16_t pbdrv_imu_virtual_simulation_to_raw(double value, float scale) {
+    double raw = value / scale;
+    if (raw > INT16_MAX) {
+        return INT16_MAX;
+    }
+    if (raw < INT16_MIN) {
+        return INT16_MIN;
+    }
+    return (int16_t)raw;
+}
+
+static void pbdrv_imu_virtual_simulation_reset_stationary_buffer(pbdrv_imu_dev_t *imu_dev) {
+    imu_dev->stationary_sample_count = 0;
+    memcpy(imu_dev->stationary_data_start, imu_dev->data, sizeof(imu_dev->stationary_data_start));
+    memset(&imu_dev->stationary_accel_data_sum, 0, sizeof(imu_dev->stationary_accel_data_sum));
+    memset(&imu_dev->stationary_gyro_data_sum, 0, sizeof(imu_dev->stationary_gyro_data_sum));
+}
+
+static void pbdrv_imu_virtual_simulation_update_stationary_status(pbdrv_imu_dev_t *imu_dev) {
+
+    // Simulated data has no noise, so compare to the first sample of the window.
+    for (uint32_t i = 0; i < PBIO_ARRAY_SIZE(imu_dev->data); i++) {
+        int16_t threshold = i < 3 ? imu_dev->config.gyro_stationary_threshold : imu_dev->config.accel_stationary_threshold;
+        if (!is_bounded(imu_dev->data[i] - imu_dev->stationary_data_start[i], threshold)) {
+            imu_dev->stationary_now = false;
+            pbdrv_imu_virtual_simulation_reset_stationary_buffer(imu_dev);
+            return;
+        }
+    }
+
+    // Updating running sum of stationary data.
+    imu_dev->stationary_sample_count++;
+    for (uint32_t i = 0; i < 3; i++) {
+        imu_dev->stationary_gyro_data_sum[i] += imu_dev->data[i];
+        imu_dev->stationary_accel_data_sum[i] += imu_dev->data[i + 3];
+    }
+
+    // Exit if we don't have one second worth of samples yet.
+    if (imu_dev->stationary_sample_count < IMU_VIRTUAL_SIMULATION_DATA_RATE) {
+        return;
+    }
+
+    // This tells external APIs that we are really stationary.
+    imu_dev->stationary_now = true;
+
+    // Process the data recorded while stationary.
+    if (imu_dev->handle_stationary_data) {
+        imu_dev->handle_stationary_data(imu_dev->stationary_gyro_data_sum, imu_dev->stationary_accel_data_sum, imu_dev->stationary_sample_count);
+    }
+
+    // Reset counter and gyro sum data so we can start over.
+    pbdrv_imu_virtual_simulation_reset_stationary_buffer(imu_dev);
+}
+
+void pbdrv_imu_virtual_simulation_update(const double *angular_velocity, const double *acceleration) {
+    pbdrv_imu_dev_t *imu_dev = &global_imu_dev;
+
+    for (uint32_t i = 0; i < 3; i++) {
+        imu_dev->data[i] = pbdrv_imu_virtual_simulation_to_raw(angular_velocity[i], imu_dev->config.gyro_scale);
+        imu_dev->data[i + 3] = pbdrv_imu_virtual_simulation_to_raw(acceleration[i], imu_dev->config.accel_scale);
+    }
+
+    pbdrv_imu_virtual_simulation_update_stationary_status(imu_dev);
+    if (imu_dev->handle_frame_data) {
+        imu_dev->handle_frame_data(imu_dev->data);
+    }
+}
+
+// internal driver interface implementation
+
+void pbdrv_imu_init(void) {
+    pbdrv_imu_dev_t *imu_dev = &global_imu_dev;
+
+    // Same scales as the LSM6DS3TR-C at 2000 dps and 8 g full scale.
+    imu_dev->config.sample_time = 1.0f / IMU_VIRTUAL_SIMULATION_DATA_RATE;
+    imu_dev->config.gyro_scale = 0.07f;
+    imu_dev->config.accel_scale = 0.244f * 9.81f;
+
+    // Simulated data has no noise. These are replaced by the user settings,
+    // if they are loaded.
+    imu_dev->config.gyro_stationary_threshold = 1;
+    imu_dev->config.accel_stationary_threshold = 1;
+}
+
+// public driver interface implementation
+
+pbio_error_t pbdrv_imu_get_imu(pbdrv_imu_dev_t **imu_dev, pbdrv_imu_config_t **config) {
+    *imu_dev = &global_imu_dev;
+    *config = &global_imu_dev.config;
+    return PBIO_SUCCESS;
+}
+
+void pbdrv_imu_set_data_handlers(pbdrv_imu_dev_t *imu_dev, pbdrv_imu_handle_frame_data_func_t frame_data_func, pbdrv_imu_handle_stationary_data_func_t stationary_data_func) {
+    imu_dev->handle_frame_data = frame_data_func;
+    imu_dev->handle_stationary_data = stationary_data_func;
+}
+
+bool pbdrv_imu_is_stationary(pbdrv_imu_dev_t *imu_dev) {
+    return imu_dev->stationary_now;
+}
+
+#endif // PBDRV_CONFIG_IMU_VIRTUAL_SIMULATION
@@ -0,0 +1,24 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2025 The Pybricks Authors
+
+// IMU driver that reports the motion of the simulated drive base.
+
+#ifndef _INTERNAL_PBDRV_IMU_VIRTUAL_SIMULATION_H_
+#define _INTERNAL_PBDRV_IMU_VIRTUAL_SIMULATION_H_
+
+#include <pbdrv/config.h>
+
+#if PBDRV_CONFIG_IMU_VIRTUAL_SIMULATION
+
+/**
+ * Processes one simulated sample. Called by the simulation on every tick.
+ *
+ * @param [in]  angular_velocity  Angular velocity (xyz) in the hub frame in deg/s.
+ * @param [in]  acceleration      Acceleration (xyz) in the hub frame in mm/s^2,
+ *                                including gravity.
+ */
+void pbdrv_imu_virtual_simulation_update(const double *angular_velocity, const double *acceleration);
+
+#endif // PBDRV_CONFIG_IMU_VIRTUAL_SIMULATION
+
+#endif // _INTERNAL_PBDRV_IMU_VIRTUAL_SIMULATION_H_
@@ -5,6 +5,7 @@
 
 #if PBDRV_CONFIG_MOTOR_DRIVER_VIRTUAL_SIMULATION
 
+#include <math.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <stdio.h>
@@ -24,6 +25,8 @@
 #include <pbio/util.h>
 
 #include "motor_driver_virtual_simulation.h"
+#include "../imu/imu_virtual_simulation.h"
+#include "../virtual_replay.h"
 
 typedef struct _pbio_simulation_model_t {
     double d_angle_d_speed;
@@ -52,6 +55,7 @@ struct _pbdrv_motor_driver_dev_t {
     double speed;
     double voltage;
     double torque;
+    double load_torque;
     const pbio_simulation_model_t *model;
     const pbdrv_motor_driver_virtual_simulation_platform_data_t *pdata;
     pbdrv_counter_dev_t counter;
@@ -75,6 +79,120 @@ static const pbio_simulation_model_t model_technic_m_angular = {
 
 static pbdrv_motor_driver_dev_t motor_driver_devs[PBDRV_CONFIG_MOTOR_DRIVER_NUM_DEV];
 
+/** Standard gravity in mm/s^2. */
+#define SIMULATION_GRAVITY (9806.65)
+
+/** Simulation time step (s). */
+#define SIMULATION_DT (0.001)
+
+#if PBDRV_CONFIG_MOTOR_DRIVER_VIRTUAL_SIMULATION_DRIVEBASE
+
+/**
+ * State of the simulated robot body, moving on a flat surface.
+ */
+typedef struct {
+    /** Position in the world frame (mm). */
+    double x;
+    double y;
+    /** Heading, counterclockwise from the world x-axis (rad). */
+    double heading;
+    /** Forward speed (m/s). */
+    double speed;
+    /** Angular velocity, counterclockwise positive (rad/s). */
+    double angular_velocity;
+    /** Forward acceleration in the last step (m/s^2). */
+    double acceleration;
+} pbio_simulation_body_t;
+
+static pbio_simulation_body_t body;
+
+// The motors are only coupled through the body if PBIO_VIRTUAL_DRIVEBASE is
+// set in the environment, so they can still be tested individually.
+static bool drivebase_enabled;
+
+static double pbdrv_motor_driver_virtual_simulation_traction(double slip, double stiffness, double max) {
+    double force = slip * stiffness;
+    if (force > max) {
+        return max;
+    }
+    if (force < -max) {
+        return -max;
+    }
+    return force;
+}
+
+/**
+ * Advances the robot body by one time step and sets the resulting load on
+ * the wheel motors, to be used in the next motor update.
+ */
+static void pbdrv_motor_driver_virtual_simulation_drivebase_step(void) {
+    const pbdrv_motor_driver_virtual_simulation_drivebase_platform_data_t *pdata = &pbdrv_motor_driver_virtual_simulation_drivebase_platform_data;
+    pbdrv_motor_driver_dev_t *left = &motor_driver_devs[pdata->left_index];
+    pbdrv_motor_driver_dev_t *right = &motor_driver_devs[pdata->right_index];
+
+    // Everything in SI units from here.
+    double radius = pdata->wheel_diameter / 2000;
+    double half_track = pdata->axle_track / 2000;
+
+    // Speed of the wheel surfaces relative to the robot (mdeg/s to m/s).
+    double surface_left = -left->speed * M_PI / 180000 * radius;
+    double surface_right = right->speed * M_PI / 180000 * radius;
+
+    // Speed of the robot at the wheel contact points.
+    double ground_left = body.speed - body.angular_velocity * half_track;
+    double ground_right = body.speed + body.angular_velocity * half_track;
+
+    // Traction force grows with slip until the wheels slip freely.
+    double force_left = pbdrv_motor_driver_virtual_simulation_traction(surface_left - ground_left, pdata->traction_stiffness, pdata->traction_max);
+    double force_right = pbdrv_motor_driver_virtual_simulation_traction(surface_right - ground_right, pdata->traction_stiffness, pdata->traction_max);
+
+    // Rigid body motion of the robot.
+    body.acceleration = (force_left + force_right) / pdata->mass;
+    body.speed += body.acceleration * SIMULATION_DT;
+    body.angular_velocity += (force_right - force_left) * half_track / pdata->inertia * SIMULATION_DT;
+    body.heading += body.angular_velocity * SIMULATION_DT;
+    body.x += body.speed * cos(body.heading) * SIMULATION_DT * 1000;
+    body.y += body.speed * sin(body.heading) * SIMULATION_DT * 1000;
+
+    // The same forces act back on the wheels (N m to the model units).
+    left->load_torque = -force_left * radius * 1e6;
+    right->load_torque = force_right * radius * 1e6;
+}
+
+#endif // PBDRV_CONFIG_MOTOR_DRIVER_VIRTUAL_SIMULATION_DRIVEBASE
+
+#if PBDRV_CONFIG_IMU_VIRTUAL_SIMULATION
+
+/**
+ * Feeds the motion of the robot body to the simulated IMU, mounted flat at
+ * the center of the robot with the x-axis pointing forward.
+ */
+static void pbdrv_motor_driver_virtual_simulation_imu_step(void) {
+    double angular_velocity[3] = { 0 };
+    double acceleration[3] = { 0, 0, SIMULATION_GRAVITY };
+
+    #if PBDRV_CONFIG_MOTOR_DRIVER_VIRTUAL_SIMULATION_DRIVEBASE
+    angular_velocity[2] = body.angular_velocity * 180 / M_PI;
+    acceleration[0] = body.acceleration * 1000;
+    acceleration[1] = body.speed * body.angular_velocity * 1000;
+    #endif
+
+    #if PBDRV_CONFIG_VIRTUAL_REPLAY
+    // Recorded IMU data replaces the simulated motion.
+    const int32_t *row = pbdrv_virtual_replay_get_row(PBDRV_VIRTUAL_REPLAY_TRACE_IMU, 7);
+    if (row) {
+        for (uint32_t i = 0; i < 3; i++) {
+            angular_velocity[i] = row[1 + i];
+            acceleration[i] = row[4 + i];
+        }
+    }
+    #endif
+
+    pbdrv_imu_virtual_simulation_update(angular_velocity, acceleration);
+}
+
+#endif // PBDRV_CONFIG_IMU_VIRTUAL_SIMULATION
+
 pbio_error_t pbdrv_counter_get_dev(uint8_t id, pbdrv_counter_dev_t **dev) {
     if (id >= PBIO_ARRAY_SIZE(motor_driver_devs)) {
         return PBIO_ERROR_NO_DEV;
@@ -190,6 +308,16 @@ PROCESS_THREAD(pbdrv_motor_driver_virtual_simulation_process, ev, data) {
             }
         }
 
+        #if PBDRV_CONFIG_MOTOR_DRIVER_VIRTUAL_SIMULATION_DRIVEBASE
+        if (drivebase_enabled) {
+            pbdrv_motor_driver_virtual_simulation_drivebase_step();
+        }
+        #endif
+
+        #if PBDRV_CONFIG_IMU_VIRTUAL_SIMULATION
+        pbdrv_motor_driver_virtual_simulation_imu_step();
+        #endif
+
         for (dev_index = 0; dev_index < PBDRV_CONFIG_MOTOR_DRIVER_NUM_DEV; dev_index++) {
             driver = &motor_driver_devs[dev_index];
 
@@ -221,7 +349,7 @@ PROCESS_THREAD(pbdrv_motor_driver_virtual_simulation_process, ev, data) {
             }
 
             double voltage = driver->voltage;
-            double torque = friction + external_torque;
+            double torque = friction + external_torque + driver->load_torque;
 
             // Get next state based on current state and input: x(k+1) = Ax(k) + Bu(k)
             double angle_next = driver->angle +
@@ -244,6 +372,16 @@ PROCESS_THREAD(pbdrv_motor_driver_virtual_simulation_process, ev, data) {
             driver->angle = angle_next;
             driver->speed = speed_next;
             driver->current = current_next;
+
+            #if PBDRV_CONFIG_VIRTUAL_REPLAY
+            // Recorded raw shaft angle (column 11) and speed (column 12)
+            // replace the simulated motion.
+            const int32_t *row = pbdrv_virtual_replay_get_row(PBDRV_VIRTUAL_REPLAY_TRACE_PORT_A + dev_index, 13);
+            if (row) {
+                driver->angle = row[11] * 1000.0;
+                driver->speed = row[12] * 1000.0;
+            }
+            #endif
         }
 
         etimer_reset(&tick_timer);
@@ -314,6 +452,7 @@ void pbdrv_motor_driver_init(void) {
         driver->speed = driver->pdata->initial_speed;
         driver->current = 0;
         driver->torque = 0;
+        driver->load_torque = 0;
         driver->voltage = 0;
 
         // Select model corresponding to device ID.
@@ -335,6 +474,12 @@ void pbdrv_motor_driver_init(void) {
     }
 
 
+    #if PBDRV_CONFIG_MOTOR_DRIVER_VIRTUAL_SIMULATION_DRIVEBASE
+    body = (pbio_simulation_body_t) { 0 };
+    drivebase_enabled = getenv("PBIO_VIRTUAL_DRIVEBASE") != NULL;
+    #endif
+
+    pbdrv_virtual_replay_init();
     pbdrv_motor_driver_virtual_simulation_prepare_parser();
     if (simulation_enabled) {
         process_start(&pbdrv_motor_driver_virtual_simulation_process);
@@ -37,6 +37,38 @@ typedef struct {
 extern const pbdrv_motor_driver_virtual_simulation_platform_data_t
     pbdrv_motor_driver_virtual_simulation_platform_data[PBDRV_CONFIG_MOTOR_DRIVER_NUM_DEV];
 
+#if PBDRV_CONFIG_MOTOR_DRIVER_VIRTUAL_SIMULATION_DRIVEBASE
+
+/**
+ * Description of a simulated robot with two driven wheels.
+ *
+ * The left motor turns counterclockwise and the right motor turns clockwise
+ * to drive forward, as when both motors are mounted mirrored.
+ */
+typedef struct {
+    /** Motor driver index of the motor that drives the left wheel. */
+    uint8_t left_index;
+    /** Motor driver index of the motor that drives the right wheel. */
+    uint8_t right_index;
+    /** Diameter of the wheels (mm). */
+    double wheel_diameter;
+    /** Distance between the points where the wheels touch the ground (mm). */
+    double axle_track;
+    /** Mass of the robot (kg). */
+    double mass;
+    /** Moment of inertia of the robot about the vertical axis (kg m^2). */
+    double inertia;
+    /** Traction force per unit of slip speed between wheel and ground (N s/m). */
+    double traction_stiffness;
+    /** Maximum traction force of each wheel, above which it slips (N). */
+    double traction_max;
+} pbdrv_motor_driver_virtual_simulation_drivebase_platform_data_t;
+
+extern const pbdrv_motor_driver_virtual_simulation_drivebase_platform_data_t
+    pbdrv_motor_driver_virtual_simulation_drivebase_platform_data;
+
+#endif // PBDRV_CONFIG_MOTOR_DRIVER_VIRTUAL_SIMULATION_DRIVEBASE
+
 void pbdrv_motor_driver_virtual_simulation_get_angle(pbdrv_motor_driver_dev_t *dev, int32_t *rotations, int32_t *millidegrees);
 
 void pbdrv_motor_driver_disable_process(void);
@@ -0,0 +1,637 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2025 The Pybricks Authors
+
+// Emulates a LEGO UART (LUMP) device on the other end of a UART.
+//
+// This sends the same info and data messages as real devices so that the
+// LUMP implementation can be tested without hardware. The hub side talks to
+// it by passing the bytes it writes and asking for the bytes it can read,
+// along with the baud rate it is using. Bytes become available for reading
+// only as fast as they could be sent at the baud rate of the device, and are
+// lost if the hub is listening at a different baud rate, like on a real line.
+
+#include <pbdrv/config.h>
+
+#if PBDRV_CONFIG_UART_LUMP_EMULATOR
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <lego/lump.h>
+
+#include <pbdrv/clock.h>
+#include <pbio/util.h>
+
+#include "lump_emulator.h"
+
+/** Baud rate at which all devices send their info. */
+#define LUMP_EMULATOR_BAUD_SYNC (2400)
+
+/** Baud rate at which Powered Up devices may be asked to sync. */
+#define LUMP_EMULATOR_BAUD_LPF2 (115200)
+
+/** Time after power up before the info is sent, in milliseconds. */
+#define LUMP_EMULATOR_RESET_TIME (20)
+
+/** Time to wait for the ACK after sending the info, in milliseconds. */
+#define LUMP_EMULATOR_INFO_TIMEOUT (500)
+
+/** Time without keep alive messages after which the device resets, in milliseconds. */
+#define LUMP_EMULATOR_KEEP_ALIVE_TIMEOUT (1000)
+
+/** Cost of one byte on the line, including start and stop bits, in bits times 1000. */
+#define LUMP_EMULATOR_BYTE_COST (10 * 1000)
+
+/** First payload byte of a ::LUMP_CMD_WRITE message that sets a mode combination. */
+#define LUMP_EMULATOR_WRITE_COMBI_SET (0x20)
+
+static const pbdrv_lump_emulator_mode_t color_distance_sensor_modes[] = {
+    { .name = "COLOR", .num_values = 1, .data_type = LUMP_DATA_TYPE_DATA8 },
+    { .name = "PROX", .num_values = 1, .data_type = LUMP_DATA_TYPE_DATA8 },
+    { .name = "COUNT", .num_values = 1, .data_type = LUMP_DATA_TYPE_DATA32 },
+    { .name = "REFLT", .num_values = 1, .data_type = LUMP_DATA_TYPE_DATA8 },
+    { .name = "AMBI", .num_values = 1, .data_type = LUMP_DATA_TYPE_DATA8 },
+    { .name = "COL O", .num_values = 1, .data_type = LUMP_DATA_TYPE_DATA8, .writable = true },
+    { .name = "RGB I", .num_values = 3, .data_type = LUMP_DATA_TYPE_DATA16 },
+    { .name = "IR Tx", .num_values = 1, .data_type = LUMP_DATA_TYPE_DATA16, .writable = true },
+    { .name = "SPEC1", .num_values = 4, .data_type = LUMP_DATA_TYPE_DATA8 },
+    { .name = "DEBUG", .num_values = 2, .data_type = LUMP_DATA_TYPE_DATA16 },
+    { .name = "CALIB", .num_values = 8, .data_type = LUMP_DATA_TYPE_DATA16 },
+};
+
+static const uint16_t color_distance_sensor_mode_combos[] = {
+    0x004F,
+};
+
+const pbdrv_lump_emulator_device_t pbdrv_lump_emulator_color_distance_sensor = {
+    .type_id = LUMP_TYPE_ID_COLOR_DIST_SENSOR,
+    .baud_rate = 115200,
+    .max_baud_rate = 115200,
+    .data_interval = 10,
+    .num_modes = PBIO_ARRAY_SIZE(color_distance_sensor_modes),
+    .modes = color_distance_sensor_modes,
+    .num_mode_combos = PBIO_ARRAY_SIZE(color_distance_sensor_mode_combos),
+    .mode_combos = color_distance_sensor_mode_combos,
+};
+
+static const pbdrv_lump_emulator_mode_t spike_color_sensor_modes[] = {
+    { .name = "COLOR", .num_values = 1, .data_type = LUMP_DATA_TYPE_DATA8 },
+    { .name = "REFLT", .num_values = 1, .data_type = LUMP_DATA_TYPE_DATA8 },
+    { .name = "AMBI", .num_values = 1, .data_type = LUMP_DATA_TYPE_DATA8 },
+    { .name = "LIGHT", .num_values = 3, .data_type = LUMP_DATA_TYPE_DATA8, .writable = true },
+    { .name = "RREFL", .num_values = 2, .data_type = LUMP_DATA_TYPE_DATA16 },
+    { .name = "RGB I", .num_values = 4, .data_type = LUMP_DATA_TYPE_DATA16 },
+    { .name = "HSV", .num_values = 3, .data_type = LUMP_DATA_TYPE_DATA16 },
+    { .name = "SHSV", .num_values = 4, .data_type = LUMP_DATA_TYPE_DATA16 },
+    { .name = "DEBUG", .num_values = 2, .data_type = LUMP_DATA_TYPE_DATA16 },
+};
+
+const pbdrv_lump_emulator_device_t pbdrv_lump_emulator_spike_color_sensor = {
+    .type_id = LUMP_TYPE_ID_SPIKE_COLOR_SENSOR,
+    .baud_rate = 115200,
+    .max_baud_rate = 115200,
+    .sync_at_115200 = true,
+    .data_interval = 10,
+    .num_modes = PBIO_ARRAY_SIZE(spike_color_sensor_modes),
+    .modes = spike_color_sensor_modes,
+};
+
+static const pbdrv_lump_emulator_mode_t spike_ultrasonic_sensor_modes[] = {
+    { .name = "DISTL", .num_values = 1, .data_type = LUMP_DATA_TYPE_DATA16 },
+    { .name = "DISTS", .num_values = 1, .data_type = LUMP_DATA_TYPE_DATA16 },
+    { .name = "SINGL", .num_values = 1, .data_type = LUMP_DATA_TYPE_DATA16 },
+    { .name = "LISTN", .num_values = 1, .data_type = LUMP_DATA_TYPE_DATA8 },
+    { .name = "TRAW", .num_values = 1, .data_type = LUMP_DATA_TYPE_DATA32 },
+    { .name = "LIGHT", .num_values = 4, .data_type = LUMP_DATA_TYPE_DATA8, .writable = true },
+    { .name = "PING", .num_values = 1, .data_type = LUMP_DATA_TYPE_DATA8, .writable = true },
+    { .name = "ADRAW", .num_values = 1, .data_type = LUMP_DATA_TYPE_DATA16 },
+    { .name = "CALIB", .num_values = 7, .data_type = LUMP_DATA_TYPE_DATA16 },
+};
+
+const pbdrv_lump_emulator_device_t pbdrv_lump_emulator_spike_ultrasonic_sensor = {
+    .type_id = LUMP_TYPE_ID_SPIKE_ULTRASONIC_SENSOR,
+    .baud_rate = 115200,
+    .max_baud_rate = 115200,
+    .sync_at_115200 = true,
+    .data_interval = 10,
+    .num_modes = PBIO_ARRAY_SIZE(spike_ultrasonic_sensor_modes),
+    .modes = spike_ultrasonic_sensor_modes,
+};
+
+static const pbdrv_lump_emulator_mode_t spike_force_sensor_modes[] = {
+    { .name = "FORCE", .num_values = 1, .data_type = LUMP_DATA_TYPE_DATA8 },
+    { .name = "TOUCH", .num_values = 1, .data_type = LUMP_DATA_TYPE_DATA8 },
+    { .name = "TAP", .num_values = 1, .data_type = LUMP_DATA_TYPE_DATA8 },
+    { .name = "FRAW", .num_values = 1, .data_type = LUMP_DATA_TYPE_DATA16 },
+    { .name = "FPRAW", .num_values = 1, .data_type = LUMP_DATA_TYPE_DATA16 },
+    { .name = "CALIB", .num_values = 8, .data_type = LUMP_DATA_TYPE_DATA16 },
+};
+
+const pbdrv_lump_emulator_device_t pbdrv_lump_emulator_spike_force_sensor = {
+    .type_id = LUMP_TYPE_ID_SPIKE_FORCE_SENSOR,
+    .baud_rate = 115200,
+    .max_baud_rate = 115200,
+    .sync_at_115200 = true,
+    .data_interval = 10,
+    .num_modes = PBIO_ARRAY_SIZE(spike_force_sensor_modes),
+    .modes = spike_force_sensor_modes,
+};
+
+static const pbdrv_lump_emulator_mode_t technic_m_angular_motor_modes[] = {
+    { .name = "POWER", .num_values = 1, .data_type = LUMP_DATA_TYPE_DATA8, .writable = true },
+    { .name = "SPEED", .num_values = 1, .data_type = LUMP_DATA_TYPE_DATA8 },
+    { .name = "POS", .num_values = 1, .data_type = LUMP_DATA_TYPE_DATA32 },
+    { .name = "APOS", .num_values = 1, .data_type = LUMP_DATA_TYPE_DATA16 },
+    { .name = "CALIB", .num_values = 2, .data_type = LUMP_DATA_TYPE_DATA16 },
+    { .name = "STATS", .num_values = 14, .data_type = LUMP_DATA_TYPE_DATA16 },
+};
+
+static const uint16_t technic_m_angular_motor_mode_combos[] = {
+    0x000E,
+};
+
+const pbdrv_lump_emulator_device_t pbdrv_lump_emulator_technic_m_angular_motor = {
+    .type_id = LUMP_TYPE_ID_TECHNIC_M_ANGULAR_MOTOR,
+    .baud_rate = 115200,
+    .max_baud_rate = 230400,
+    .sync_at_115200 = true,
+    .flags0 = LUMP_MODE_FLAGS0_MOTOR | LUMP_MODE_FLAGS0_MOTOR_POWER | LUMP_MODE_FLAGS0_MOTOR_SPEED |
+        LUMP_MODE_FLAGS0_MOTOR_REL_POS | LUMP_MODE_FLAGS0_MOTOR_ABS_POS,
+    .data_interval = 10,
+    .num_modes = PBIO_ARRAY_SIZE(technic_m_angular_motor_modes),
+    .modes = technic_m_angular_motor_modes,
+    .num_mode_combos = PBIO_ARRAY_SIZE(technic_m_angular_motor_mode_combos),
+    .mode_combos = technic_m_angular_motor_mode_combos,
+};
+
+static uint8_t pbdrv_lump_emulator_msg_size(uint8_t header) {
+    if ((header & LUMP_MSG_TYPE_MASK) == LUMP_MSG_TYPE_SYS) {
+        return 1;
+    }
+    uint8_t size = LUMP_MSG_SIZE(header) + 2;
+    if ((header & LUMP_MSG_TYPE_MASK) == LUMP_MSG_TYPE_INFO) {
+        size++;
+    }
+    return size;
+}
+
+static uint8_t pbdrv_lump_emulator_payload_size(uint8_t size, lump_msg_size_t *size_bits) {
+    uint8_t bits = 0;
+    while ((1 << bits) < size) {
+        bits++;
+    }
+    *size_bits = bits << 3;
+    return 1 << bits;
+}
+
+/**
+ * Queues one message to be sent by the device.
+ *
+ * @param [in]  emu       The emulator.
+ * @param [in]  msg_type  The message type.
+ * @param [in]  cmd       The command or mode, up to ::LUMP_MAX_MODE.
+ * @param [in]  cmd2      The INFO command, if @p msg_type is ::LUMP_MSG_TYPE_INFO.
+ * @param [in]  data      The payload. It is padded with zeros as needed.
+ * @param [in]  size      The size of the payload.
+ * @param [in]  corrupt   Whether to send a bad checksum.
+ */
+static void pbdrv_lump_emulator_queue_msg(pbdrv_lump_emulator_t *emu, lump_msg_type_t msg_type, uint8_t cmd, uint8_t cmd2, const uint8_t *data, uint8_t size, bool corrupt) {
+
+    if (msg_type == LUMP_MSG_TYPE_SYS) {
+        if (emu->tx_size < sizeof(emu->tx_buf)) {
+            emu->tx_buf[emu->tx_size++] = cmd;
+        }
+        return;
+    }
+
+    lump_msg_size_t size_bits;
+    uint8_t padded_size = pbdrv_lump_emulator_payload_size(size, &size_bits);
+    uint8_t msg_size = padded_size + (msg_type == LUMP_MSG_TYPE_INFO ? 3 : 2);
+
+    // Drop the message if it does not fit, like a device that can't keep up.
+    if (emu->tx_size + msg_size > sizeof(emu->tx_buf)) {
+        emu->num_bytes_dropped += msg_size;
+        return;
+    }
+
+    uint8_t *msg = &emu->tx_buf[emu->tx_size];
+    uint8_t *payload = msg + 1;
+    msg[0] = msg_type | size_bits | (cmd & LUMP_MSG_CMD_MASK);
+    if (msg_type == LUMP_MSG_TYPE_INFO) {
+        *payload++ = cmd2;
+    }
+    memcpy(payload, data, size);
+    memset(payload + size, 0, padded_size - size);
+
+    uint8_t checksum = 0xFF;
+    for (uint8_t i = 0; i < msg_size - 1; i++) {
+        checksum ^= msg[i];
+    }
+    msg[msg_size - 1] = corrupt ? checksum ^ 0x01 : checksum;
+
+    emu->tx_size += msg_size;
+}
+
+static void pbdrv_lump_emulator_queue_float_pair(pbdrv_lump_emulator_t *emu, uint8_t mode, uint8_t cmd2, float min, float max) {
+    uint8_t payload[8];
+    uint32_t bits;
+    memcpy(&bits, &min, sizeof(bits));
+    pbio_set_uint32_le(&payload[0], bits);
+    memcpy(&bits, &max, sizeof(bits));
+    pbio_set_uint32_le(&payload[4], bits);
+    pbdrv_lump_emulator_queue_msg(emu, LUMP_MSG_TYPE_INFO, mode, cmd2, payload, sizeof(payload), false);
+}
+
+/**
+ * Queues the complete device info, ending with ACK.
+ *
+ * Modes are sent from the highest to the lowest, like real devices do.
+ */
+static void pbdrv_lump_emulator_queue_info(pbdrv_lump_emulator_t *emu) {
+
+    const pbdrv_lump_emulator_device_t *device = emu->device;
+    uint8_t payload[LUMP_MAX_MSG_SIZE];
+
+    payload[0] = device->type_id;
+    pbdrv_lump_emulator_queue_msg(emu, LUMP_MSG_TYPE_CMD, LUMP_CMD_TYPE, 0, payload, 1, false);
+
+    // Modes beyond LUMP_MAX_MODE are given in the extended part.
+    uint8_t last_mode = device->num_modes - 1;
+    if (last_mode > LUMP_MAX_MODE) {
+        payload[0] = LUMP_MAX_MODE;
+        payload[1] = LUMP_MAX_MODE;
+        payload[2] = last_mode;
+        payload[3] = last_mode;
+        pbdrv_lump_emulator_queue_msg(emu, LUMP_MSG_TYPE_CMD, LUMP_CMD_MODES, 0, payload, 4, false);
+    } else {
+        payload[0] = last_mode;
+        payload[1] = last_mode;
+        pbdrv_lump_emulator_queue_msg(emu, LUMP_MSG_TYPE_CMD, LUMP_CMD_MODES, 0, payload, 2, false);
+    }
+
+    pbio_set_uint32_le(payload, device->baud_rate);
+    pbdrv_lump_emulator_queue_msg(emu, LUMP_MSG_TYPE_CMD, LUMP_CMD_SPEED, 0, payload, 4, false);
+
+    pbio_set_uint32_le(&payload[0], 0x10000000);
+    pbio_set_uint32_le(&payload[4], 0x10000000);
+    pbdrv_lump_emulator_queue_msg(emu, LUMP_MSG_TYPE_CMD, LUMP_CMD_VERSION, 0, payload, 8, false);
+
+    for (int16_t mode = last_mode; mode >= 0; mode--) {
+        const pbdrv_lump_emulator_mode_t *info = &device->modes[mode];
+        uint8_t plus_8 = mode > LUMP_MAX_MODE ? LUMP_INFO_MODE_PLUS_8 : 0;
+
+        // Newer devices send capability flags after a name of up to 5 characters.
+        memset(payload, 0, sizeof(payload));
+        strncpy((char *)payload, info->name, LUMP_MAX_NAME_SIZE);
+        if (device->flags0) {
+            payload[LUMP_MAX_SHORT_NAME_SIZE + 1] = device->flags0;
+            pbdrv_lump_emulator_queue_msg(emu, LUMP_MSG_TYPE_INFO, mode, LUMP_INFO_NAME | plus_8, payload, 16, false);
+        } else {
+            pbdrv_lump_emulator_queue_msg(emu, LUMP_MSG_TYPE_INFO, mode, LUMP_INFO_NAME | plus_8, payload, strlen(info->name), false);
+        }
+
+        pbdrv_lump_emulator_queue_float_pair(emu, mode, LUMP_INFO_RAW | plus_8, 0.0f, 1023.0f);
+        pbdrv_lump_emulator_queue_float_pair(emu, mode, LUMP_INFO_PCT | plus_8, 0.0f, 100.0f);
+        pbdrv_lump_emulator_queue_float_pair(emu, mode, LUMP_INFO_SI | plus_8, 0.0f, 1023.0f);
+
+        payload[0] = 0;
+        pbdrv_lump_emulator_queue_msg(emu, LUMP_MSG_TYPE_INFO, mode, LUMP_INFO_UNITS | plus_8, payload, 1, false);
+
+        payload[0] = 0x10;
+        payload[1] = info->writable ? 0x10 : 0x00;
+        pbdrv_lump_emulator_queue_msg(emu, LUMP_MSG_TYPE_INFO, mode, LUMP_INFO_MAPPING | plus_8, payload, 2, false);
+
+        payload[0] = info->num_values;
+        payload[1] = info->data_type;
+        payload[2] = 4;
+        payload[3] = 0;
+        pbdrv_lump_emulator_queue_msg(emu, LUMP_MSG_TYPE_INFO, mode, LUMP_INFO_FORMAT | plus_8, payload, 4, false);
+
+        // Mode combinations are given last, with the info of mode 0.
+        if (mode == 0 && device->num_mode_combos) {
+            for (uint8_t c = 0; c < device->num_mode_combos; c++) {
+                pbio_set_uint16_le(&payload[c * 2], device->mode_combos[c]);
+            }
+            pbdrv_lump_emulator_queue_msg(emu, LUMP_MSG_TYPE_INFO, 0, LUMP_INFO_MODE_COMBOS, payload, device->num_mode_combos * 2, false);
+        }
+    }
+
+    pbdrv_lump_emulator_queue_msg(emu, LUMP_MSG_TYPE_SYS, LUMP_SYS_ACK, 0, NULL, 0, false);
+}
+
+static uint8_t pbdrv_lump_emulator_value_size(const pbdrv_lump_emulator_mode_t *info) {
+    switch (info->data_type) {
+        case LUMP_DATA_TYPE_DATA16:
+            return 2;
+        case LUMP_DATA_TYPE_DATA32:
+        case LUMP_DATA_TYPE_DATAF:
+            return 4;
+        default:
+            return 1;
+    }
+}
+
+/**
+ * Queues the data of the current mode, preceded by the extended mode.
+ *
+ * In a mode combination, the requested values of all modes are sent one
+ * after the other, as if they were data of the current mode.
+ */
+static void pbdrv_lump_emulator_queue_data(pbdrv_lump_emulator_t *emu) {
+
+    uint8_t ext_mode = emu->mode > LUMP_MAX_MODE ? 8 : 0;
+    pbdrv_lump_emulator_queue_msg(emu, LUMP_MSG_TYPE_CMD, LUMP_CMD_EXT_MODE, 0, &ext_mode, 1, false);
+
+    emu->num_data_sent++;
+    bool corrupt = emu->corrupt_interval && emu->num_data_sent % emu->corrupt_interval == 0;
+    if (corrupt) {
+        emu->num_data_corrupted++;
+    }
+
+    const pbdrv_lump_emulator_mode_t *info = &emu->device->modes[emu->mode];
+    if (!emu->combi_num_values) {
+        uint8_t size = info->num_values * pbdrv_lump_emulator_value_size(info);
+        pbdrv_lump_emulator_queue_msg(emu, LUMP_MSG_TYPE_DATA, emu->mode, 0, emu->data[emu->mode], size, corrupt);
+        return;
+    }
+
+    uint8_t payload[LUMP_MAX_MSG_SIZE];
+    uint8_t size = 0;
+    for (uint8_t i = 0; i < emu->combi_num_values; i++) {
+        uint8_t mode = emu->combi[i] >> 4;
+        uint8_t value = emu->combi[i] & 0x0F;
+        uint8_t value_size = pbdrv_lump_emulator_value_size(&emu->device->modes[mode]);
+        if (size + value_size > sizeof(payload)) {
+            break;
+        }
+        memcpy(&payload[size], &emu->data[mode][value * value_size], value_size);
+        size += value_size;
+    }
+    pbdrv_lump_emulator_queue_msg(emu, LUMP_MSG_TYPE_DATA, emu->mode, 0, payload, size, corrupt);
+}
+
+/**
+ * Sets up a mode combination as requested with a ::LUMP_CMD_WRITE message.
+ *
+ * The payload has the index of the combination, followed by the requested
+ * values. If any of them is not in the combination, data is sent for the
+ * current mode only.
+ *
+ * @param [in]  emu      The emulator.
+ * @param [in]  payload  The payload of the message.
+ * @param [in]  size     The size of the payload, including padding.
+ */
+static void pbdrv_lump_emulator_set_combi(pbdrv_lump_emulator_t *emu, const uint8_t *payload, uint8_t size) {
+
+    const pbdrv_lump_emulator_device_t *device = emu->device;
+    uint8_t index = payload[0] & 0x0F;
+    if ((payload[0] & 0xF0) != LUMP_EMULATOR_WRITE_COMBI_SET || index >= device->num_mode_combos) {
+        return;
+    }
+
+    emu->combi_num_values = 0;
+    for (uint8_t i = 1; i < size; i++) {
+        uint8_t mode = payload[i] >> 4;
+        uint8_t value = payload[i] & 0x0F;
+        if (!(device->mode_combos[index] & (1 << mode)) || value >= device->modes[mode].num_values) {
+            emu->combi_num_values = 0;
+            return;
+        }
+        // Each value is requested only once, so a repeated value is padding.
+        if (memchr(emu->combi, payload[i], emu->combi_num_values)) {
+            break;
+        }
+        emu->combi[emu->combi_num_values++] = payload[i];
+    }
+}
+
+static void pbdrv_lump_emulator_set_state(pbdrv_lump_emulator_t *emu, pbdrv_lump_emulator_state_t state, uint32_t baud_rate) {
+    emu->state = state;
+    emu->baud_rate = baud_rate;
+    emu->state_time = pbdrv_clock_get_ms();
+}
+
+static void pbdrv_lump_emulator_reset(pbdrv_lump_emulator_t *emu) {
+    pbdrv_lump_emulator_set_state(emu, PBDRV_LUMP_EMULATOR_STATE_RESET, LUMP_EMULATOR_BAUD_SYNC);
+    emu->tx_size = 0;
+    emu->tx_ready = 0;
+    emu->rx_size = 0;
+    emu->rx_ext_mode = 0;
+    emu->mode = 0;
+    emu->combi_num_values = 0;
+}
+
+/**
+ * Moves queued bytes across the line and advances the protocol state.
+ *
+ * @param [in]  emu        The emulator.
+ * @param [in]  baud_rate  Baud rate at which the hub is listening.
+ */
+static void pbdrv_lump_emulator_update(pbdrv_lump_emulator_t *emu, uint32_t baud_rate) {
+
+    uint32_t now = pbdrv_clock_get_ms();
+
+    // Send as many bytes as the line allows since the last update.
+    uint32_t elapsed = now - emu->line_time;
+    emu->line_time = now;
+    if (emu->tx_ready < emu->tx_size) {
+        // Limit the elapsed time so that the budget can't overflow.
+        emu->line_budget += (elapsed < 10000 ? elapsed : 10000) * emu->baud_rate;
+        while (emu->tx_ready < emu->tx_size && emu->line_budget >= LUMP_EMULATOR_BYTE_COST) {
+            emu->line_budget -= LUMP_EMULATOR_BYTE_COST;
+            emu->tx_ready++;
+        }
+    }
+    if (emu->tx_ready == emu->tx_size) {
+        emu->line_budget = 0;
+    }
+
+    // Bytes that arrive while the hub listens at another rate are lost.
+    if (emu->tx_ready && baud_rate != emu->baud_rate) {
+        emu->num_bytes_dropped += emu->tx_ready;
+        memmove(emu->tx_buf, emu->tx_buf + emu->tx_ready, emu->tx_size - emu->tx_ready);
+        emu->tx_size -= emu->tx_ready;
+        emu->tx_ready = 0;
+    }
+
+    switch (emu->state) {
+        case PBDRV_LUMP_EMULATOR_STATE_RESET:
+            if (now - emu->state_time >= LUMP_EMULATOR_RESET_TIME) {
+                pbdrv_lump_emulator_set_state(emu, PBDRV_LUMP_EMULATOR_STATE_INFO, LUMP_EMULATOR_BAUD_SYNC);
+                pbdrv_lump_emulator_queue_info(emu);
+            }
+            break;
+        case PBDRV_LUMP_EMULATOR_STATE_INFO:
+            // Start over if the hub did not acknowledge the info in time.
+            if (emu->tx_size) {
+                emu->state_time = now;
+            } else if (now - emu->state_time >= LUMP_EMULATOR_INFO_TIMEOUT) {
+                pbdrv_lump_emulator_reset(emu);
+            }
+            break;
+        case PBDRV_LUMP_EMULATOR_STATE_DATA:
+            if (now - emu->keep_alive_time >= LUMP_EMULATOR_KEEP_ALIVE_TIMEOUT) {
+                pbdrv_lump_emulator_reset(emu);
+                break;
+            }
+            if (now - emu->data_time >= emu->data_interval) {
+                emu->data_time = now;
+                pbdrv_lump_emulator_queue_data(emu);
+            }
+            break;
+    }
+}
+
+/**
+ * Handles one complete message from the hub.
+ */
+static void pbdrv_lump_emulator_handle_msg(pbdrv_lump_emulator_t *emu, const uint8_t *msg, uint8_t msg_size) {
+
+    uint8_t msg_type = msg[0] & LUMP_MSG_TYPE_MASK;
+    uint8_t cmd = msg[0] & LUMP_MSG_CMD_MASK;
+    uint32_t now = pbdrv_clock_get_ms();
+
+    if (msg_type == LUMP_MSG_TYPE_SYS) {
+        if (cmd == LUMP_SYS_NACK) {
+            emu->keep_alive_time = now;
+        } else if (cmd == LUMP_SYS_ACK && emu->state == PBDRV_LUMP_EMULATOR_STATE_INFO) {
+            pbdrv_lump_emulator_set_state(emu, PBDRV_LUMP_EMULATOR_STATE_DATA, emu->device->baud_rate);
+            emu->mode = 0;
+            emu->keep_alive_time = now;
+            emu->data_time = now;
+            emu->num_syncs++;
+        }
+        return;
+    }
+
+    uint8_t checksum = 0xFF;
+    for (uint8_t i = 0; i < msg_size - 1; i++) {
+        checksum ^= msg[i];
+    }
+    if (checksum != msg[msg_size - 1]) {
+        return;
+    }
+
+    if (msg_type == LUMP_MSG_TYPE_CMD && cmd == LUMP_CMD_SPEED) {
+        uint32_t speed = pbio_get_uint32_le(&msg[1]);
+        if (emu->state == PBDRV_LUMP_EMULATOR_STATE_RESET && speed == LUMP_EMULATOR_BAUD_LPF2) {
+            // Skip the slow info at 2400 baud.
+            pbdrv_lump_emulator_set_state(emu, PBDRV_LUMP_EMULATOR_STATE_INFO, LUMP_EMULATOR_BAUD_LPF2);
+            pbdrv_lump_emulator_queue_msg(emu, LUMP_MSG_TYPE_SYS, LUMP_SYS_ACK, 0, NULL, 0, false);
+            pbdrv_lump_emulator_queue_info(emu);
+        } else if (emu->state == PBDRV_LUMP_EMULATOR_STATE_DATA && speed <= emu->device->max_baud_rate) {
+            emu->baud_rate = speed;
+        }
+        return;
+    }
+
+    if (emu->state != PBDRV_LUMP_EMULATOR_STATE_DATA) {
+        return;
+    }
+
+    if (msg_type == LUMP_MSG_TYPE_CMD && cmd == LUMP_CMD_SELECT) {
+        if (msg[1] < emu->device->num_modes) {
+            emu->mode = msg[1];
+            emu->combi_num_values = 0;
+            emu->num_mode_switches++;
+            // Data of the new mode is sent right away.
+            emu->data_time = now - emu->data_interval;
+        }
+    } else if (msg_type == LUMP_MSG_TYPE_CMD && cmd == LUMP_CMD_EXT_MODE) {
+        emu->rx_ext_mode = msg[1];
+    } else if (msg_type == LUMP_MSG_TYPE_CMD && cmd == LUMP_CMD_WRITE) {
+        pbdrv_lump_emulator_set_combi(emu, &msg[1], msg_size - 2);
+    } else if (msg_type == LUMP_MSG_TYPE_DATA) {
+        uint8_t mode = cmd + emu->rx_ext_mode;
+        if (mode < emu->device->num_modes && emu->device->modes[mode].writable) {
+            memcpy(emu->data[mode], &msg[1], msg_size - 2);
+        }
+    }
+}
+
+/**
+ * Powers up an emulated device.
+ *
+ * @param [in]  emu     The emulator.
+ * @param [in]  device  The device to emulate.
+ */
+void pbdrv_lump_emulator_init(pbdrv_lump_emulator_t *emu, const pbdrv_lump_emulator_device_t *device) {
+    memset(emu, 0, sizeof(*emu));
+    emu->device = device;
+    emu->data_interval = device->data_interval;
+    emu->line_time = pbdrv_clock_get_ms();
+    pbdrv_lump_emulator_reset(emu);
+}
+
+/**
+ * Passes bytes written by the hub to the device.
+ *
+ * @param [in]  emu        The emulator.
+ * @param [in]  baud_rate  Baud rate at which the hub is sending.
+ * @param [in]  data       The bytes.
+ * @param [in]  size       Number of bytes.
+ */
+void pbdrv_lump_emulator_write(pbdrv_lump_emulator_t *emu, uint32_t baud_rate, const uint8_t *data, uint32_t size) {
+
+    pbdrv_lump_emulator_update(emu, baud_rate);
+
+    // The device can only make sense of bytes sent at its own rate, except
+    // that Powered Up devices listen for SPEED at 115200 while powering up.
+    bool listening = baud_rate == emu->baud_rate ||
+        (emu->state == PBDRV_LUMP_EMULATOR_STATE_RESET && emu->device->sync_at_115200 && baud_rate == LUMP_EMULATOR_BAUD_LPF2);
+    if (!listening) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < size; i++) {
+        emu->rx_buf[emu->rx_size++] = data[i];
+
+        uint8_t msg_size = pbdrv_lump_emulator_msg_size(emu->rx_buf[0]);
+        if (msg_size > sizeof(emu->rx_buf)) {
+            emu->rx_size = 0;
+            continue;
+        }
+        if (emu->rx_size == msg_size) {
+            pbdrv_lump_emulator_handle_msg(emu, emu->rx_buf, msg_size);
+            emu->rx_size = 0;
+        }
+    }
+}
+
+/**
+ * Gets the number of bytes that have reached the hub.
+ *
+ * @param [in]  emu        The emulator.
+ * @param [in]  baud_rate  Baud rate at which the hub is listening.
+ * @return                 Number of bytes that can be read.
+ */
+uint32_t pbdrv_lump_emulator_get_available(pbdrv_lump_emulator_t *emu, uint32_t baud_rate) {
+    pbdrv_lump_emulator_update(emu, baud_rate);
+    return emu->tx_ready;
+}
+
+/**
+ * Reads bytes that have reached the hub.
+ *
+ * @param [in]  emu        The emulator.
+ * @param [in]  baud_rate  Baud rate at which the hub is listening.
+ * @param [out] data       Buffer for the bytes.
+ * @param [in]  size       Size of the buffer.
+ * @return                 Number of bytes read.
+ */
+uint32_t pbdrv_lump_emulator_read(pbdrv_lump_emulator_t *emu, uint32_t baud_rate, uint8_t *data, uint32_t size) {
+
+    pbdrv_lump_emulator_update(emu, baud_rate);
+
+    if (size > emu->tx_ready) {
+        size = emu->tx_ready;
+    }
+    memcpy(data, emu->tx_buf, size);
+    memmove(emu->tx_buf, emu->tx_buf + size, emu->tx_size - size);
+    emu->tx_size -= size;
+    emu->tx_ready -= size;
+    return size;
+}
+
+#endif // PBDRV_CONFIG_UART_LUMP_EMULATOR
@@ -0,0 +1,132 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2025 The Pybricks Authors
+
+// Emulates a LEGO UART (LUMP) device on the other end of a UART.
+
+#ifndef _INTERNAL_PBDRV_UART_LUMP_EMULATOR_H_
+#define _INTERNAL_PBDRV_UART_LUMP_EMULATOR_H_
+
+#include <pbdrv/config.h>
+
+#if PBDRV_CONFIG_UART_LUMP_EMULATOR
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <lego/lump.h>
+
+/** Size of the buffer for bytes sent by the device but not yet read. */
+#define PBDRV_LUMP_EMULATOR_TX_BUF_SIZE (2048)
+
+/** One mode of an emulated device. */
+typedef struct {
+    /** Mode name, up to ::LUMP_MAX_SHORT_NAME_SIZE characters. */
+    const char *name;
+    /** Number of values in each data message. */
+    uint8_t num_values;
+    /** Type of each value. */
+    lump_data_type_t data_type;
+    /** Whether the hub can write data to this mode. */
+    bool writable;
+} pbdrv_lump_emulator_mode_t;
+
+/** Static description of an emulated device. */
+typedef struct {
+    /** Device type sent in the TYPE message. */
+    lump_type_id_t type_id;
+    /** Baud rate sent in the SPEED message. */
+    uint32_t baud_rate;
+    /** Highest baud rate the device switches to if the hub asks for it. */
+    uint32_t max_baud_rate;
+    /** Whether the device replies to a SPEED message at 115200 baud before sending its info. */
+    bool sync_at_115200;
+    /**
+     * First capability flags byte sent with each mode name, such as
+     * ::LUMP_MODE_FLAGS0_MOTOR_ABS_POS. If 0, the (older) name message without
+     * flags is used.
+     */
+    uint8_t flags0;
+    /** Time between data messages in milliseconds. */
+    uint32_t data_interval;
+    /** Number of modes. */
+    uint8_t num_modes;
+    /** Description of each mode. */
+    const pbdrv_lump_emulator_mode_t *modes;
+    /** Number of supported mode combinations. */
+    uint8_t num_mode_combos;
+    /** Supported mode combinations, as bit flags of modes. */
+    const uint16_t *mode_combos;
+} pbdrv_lump_emulator_device_t;
+
+typedef enum {
+    /** Powered up, waiting for a SPEED message or the time to send info. */
+    PBDRV_LUMP_EMULATOR_STATE_RESET,
+    /** Info sent, waiting for the hub to acknowledge it. */
+    PBDRV_LUMP_EMULATOR_STATE_INFO,
+    /** Synchronized, sending data. */
+    PBDRV_LUMP_EMULATOR_STATE_DATA,
+} pbdrv_lump_emulator_state_t;
+
+/** State of an emulated device. */
+typedef struct {
+    /** The device being emulated. */
+    const pbdrv_lump_emulator_device_t *device;
+    /** Protocol state. */
+    pbdrv_lump_emulator_state_t state;
+    /** Baud rate at which the device currently sends and receives. */
+    uint32_t baud_rate;
+    /** Time between data messages in milliseconds. Defaults to the device value. */
+    uint32_t data_interval;
+    /** If nonzero, every this many data messages is sent with a bad checksum. */
+    uint32_t corrupt_interval;
+    /** Currently selected mode. */
+    uint8_t mode;
+    /** Data of each mode. Updated by the hub for writable modes. */
+    uint8_t data[LUMP_MAX_EXT_MODE + 1][LUMP_MAX_MSG_SIZE];
+    /** Time of the last state change. */
+    uint32_t state_time;
+    /** Time of the last data message. */
+    uint32_t data_time;
+    /** Time of the last keep alive message from the hub. */
+    uint32_t keep_alive_time;
+    /** Time up to which bytes have been moved across the line. */
+    uint32_t line_time;
+    /** Time on the line not yet used to send a byte, in bits times 1000. */
+    uint32_t line_budget;
+    /** Bytes sent by the device. Those before tx_ready have reached the hub. */
+    uint8_t tx_buf[PBDRV_LUMP_EMULATOR_TX_BUF_SIZE];
+    uint32_t tx_size;
+    uint32_t tx_ready;
+    /** Partially received message from the hub. */
+    uint8_t rx_buf[LUMP_MAX_MSG_SIZE + 3];
+    uint8_t rx_size;
+    /** Extended mode set by the hub for the next data message. */
+    uint8_t rx_ext_mode;
+    /**
+     * Values sent in each data message while in a mode combination, as
+     * (mode << 4 | value index). Data is sent for a single mode if empty.
+     */
+    uint8_t combi[LUMP_MAX_MSG_SIZE];
+    uint8_t combi_num_values;
+    /** Statistics. */
+    uint32_t num_syncs;
+    uint32_t num_data_sent;
+    uint32_t num_data_corrupted;
+    uint32_t num_mode_switches;
+    uint32_t num_bytes_dropped;
+} pbdrv_lump_emulator_t;
+
+extern const pbdrv_lump_emulator_device_t pbdrv_lump_emulator_color_distance_sensor;
+extern const pbdrv_lump_emulator_device_t pbdrv_lump_emulator_spike_color_sensor;
+extern const pbdrv_lump_emulator_device_t pbdrv_lump_emulator_spike_ultrasonic_sensor;
+extern const pbdrv_lump_emulator_device_t pbdrv_lump_emulator_spike_force_sensor;
+extern const pbdrv_lump_emulator_device_t pbdrv_lump_emulator_technic_m_angular_motor;
+
+void pbdrv_lump_emulator_init(pbdrv_lump_emulator_t *emu, const pbdrv_lump_emulator_device_t *device);
+void pbdrv_lump_emulator_write(pbdrv_lump_emulator_t *emu, uint32_t baud_rate, const uint8_t *data, uint32_t size);
+uint32_t pbdrv_lump_emulator_get_available(pbdrv_lump_emulator_t *emu, uint32_t baud_rate);
+uint32_t pbdrv_lump_emulator_read(pbdrv_lump_emulator_t *emu, uint32_t baud_rate, uint8_t *data, uint32_t size);
+
+#endif // PBDRV_CONFIG_UART_LUMP_EMULATOR
+
+#endif // _INTERNAL_PBDRV_UART_LUMP_EMULATOR_H_
@@ -104,6 +104,47 @@ pbio_error_t pbdrv_uart_read(pbio_os_state_t *state, pbdrv_uart_dev_t *uart, uin
     PBIO_OS_ASYNC_END(PBIO_SUCCESS);
 }
 
+pbio_error_t pbdrv_uart_read_available(pbio_os_state_t *state, pbdrv_uart_dev_t *uart, uint8_t *msg, uint8_t length, uint8_t *size, uint32_t timeout) {
+
+    PBIO_OS_ASYNC_BEGIN(state);
+
+    if (!msg || !length) {
+        return PBIO_ERROR_INVALID_ARG;
+    }
+
+    if (uart->rx_buf) {
+        return PBIO_ERROR_BUSY;
+    }
+
+    uart->rx_buf = msg;
+    uart->rx_buf_size = length;
+    uart->rx_buf_index = 0;
+
+    if (timeout) {
+        pbio_os_timer_set(&uart->rx_timer, timeout);
+    }
+
+    // Await any data or timeout. Like above, all buffered data is drained on
+    // every re-entry, so this takes everything that arrived since the last
+    // poll, without waiting for a particular amount.
+    PBIO_OS_AWAIT_UNTIL(state, ({
+        while (uart->rx_ring_buf_head != uart->rx_ring_buf_tail && uart->rx_buf_index < uart->rx_buf_size) {
+            uart->rx_buf[uart->rx_buf_index++] = uart->rx_ring_buf[uart->rx_ring_buf_tail];
+            uart->rx_ring_buf_tail = (uart->rx_ring_buf_tail + 1) & (UART_RING_BUF_SIZE - 1);
+        }
+        uart->rx_buf_index > 0 || (timeout && pbio_os_timer_is_expired(&uart->rx_timer));
+    }));
+
+    uart->rx_buf = NULL;
+    *size = uart->rx_buf_index;
+
+    if (uart->rx_buf_index == 0) {
+        return PBIO_ERROR_TIMEDOUT;
+    }
+
+    PBIO_OS_ASYNC_END(PBIO_SUCCESS);
+}
+
 pbio_error_t pbdrv_uart_write(pbio_os_state_t *state, pbdrv_uart_dev_t *uart, uint8_t *msg, uint8_t length, uint32_t timeout) {
 
     PBIO_OS_ASYNC_BEGIN(state);
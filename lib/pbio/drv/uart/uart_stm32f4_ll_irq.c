@@ -108,6 +108,46 @@ pbio_error_t pbdrv_uart_read(pbio_os_state_t *state, pbdrv_uart_dev_t *uart, uin
     PBIO_OS_ASYNC_END(PBIO_SUCCESS);
 }
 
+pbio_error_t pbdrv_uart_read_available(pbio_os_state_t *state, pbdrv_uart_dev_t *uart, uint8_t *msg, uint8_t length, uint8_t *size, uint32_t timeout) {
+
+    PBIO_OS_ASYNC_BEGIN(state);
+
+    if (uart->read_buf) {
+        return PBIO_ERROR_BUSY;
+    }
+
+    uart->read_buf = msg;
+    uart->read_length = length;
+    uart->read_pos = 0;
+
+    if (timeout) {
+        pbio_os_timer_set(&uart->read_timer, timeout);
+    }
+
+    // Await any data or timeout. Like above, all buffered data is drained on
+    // every re-entry, so this takes everything that arrived since the last
+    // poll, without waiting for a particular amount.
+    PBIO_OS_AWAIT_UNTIL(state, ({
+        while (uart->read_pos < uart->read_length) {
+            int c = ringbuf_get(&uart->rx_buf);
+            if (c == -1) {
+                break;
+            }
+            uart->read_buf[uart->read_pos++] = c;
+        }
+        uart->read_pos > 0 || (timeout && pbio_os_timer_is_expired(&uart->read_timer));
+    }));
+
+    uart->read_buf = NULL;
+    *size = uart->read_pos;
+
+    if (uart->read_pos == 0) {
+        return PBIO_ERROR_TIMEDOUT;
+    }
+
+    PBIO_OS_ASYNC_END(PBIO_SUCCESS);
+}
+
 pbio_error_t pbdrv_uart_write(pbio_os_state_t *state, pbdrv_uart_dev_t *uart, uint8_t *msg, uint8_t length, uint32_t timeout) {
 
     PBIO_OS_ASYNC_BEGIN(state);
@@ -17,6 +17,7 @@
 
 #include <pbdrv/uart.h>
 #include <pbio/error.h>
+#include <pbio/int_math.h>
 #include <pbio/os.h>
 #include <pbio/util.h>
 
@@ -188,6 +189,23 @@ static uint32_t pbdrv_uart_get_num_available(pbdrv_uart_dev_t *uart) {
     return (rx_head - uart->rx_tail) & (RX_DATA_SIZE - 1);
 }
 
+// Copies read_length bytes from ring buffer to read_buf and completes the read.
+static void pbdrv_uart_copy_rx_data(pbdrv_uart_dev_t *uart) {
+
+    // Copy from ring buffer to user buffer, taking care of wrap-around.
+    if (uart->rx_tail + uart->read_length > RX_DATA_SIZE) {
+        uint32_t partial_size = RX_DATA_SIZE - uart->rx_tail;
+        volatile_copy(&uart->rx_data[uart->rx_tail], &uart->read_buf[0], partial_size);
+        volatile_copy(&uart->rx_data[0], &uart->read_buf[partial_size], uart->read_length - partial_size);
+    } else {
+        volatile_copy(&uart->rx_data[uart->rx_tail], &uart->read_buf[0], uart->read_length);
+    }
+
+    uart->rx_tail = (uart->rx_tail + uart->read_length) & (RX_DATA_SIZE - 1);
+    uart->read_buf = NULL;
+    uart->read_length = 0;
+}
+
 pbio_error_t pbdrv_uart_read(pbio_os_state_t *state, pbdrv_uart_dev_t *uart, uint8_t *msg, uint8_t length, uint32_t timeout) {
 
     PBIO_OS_ASYNC_BEGIN(state);
@@ -212,18 +230,37 @@ pbio_error_t pbdrv_uart_read(pbio_os_state_t *state, pbdrv_uart_dev_t *uart, uin
         return PBIO_ERROR_TIMEDOUT;
     }
 
-    // Copy from ring buffer to user buffer, taking care of wrap-around.
-    if (uart->rx_tail + uart->read_length > RX_DATA_SIZE) {
-        uint32_t partial_size = RX_DATA_SIZE - uart->rx_tail;
-        volatile_copy(&uart->rx_data[uart->rx_tail], &uart->read_buf[0], partial_size);
-        volatile_copy(&uart->rx_data[0], &uart->read_buf[partial_size], uart->read_length - partial_size);
-    } else {
-        volatile_copy(&uart->rx_data[uart->rx_tail], &uart->read_buf[0], uart->read_length);
+    pbdrv_uart_copy_rx_data(uart);
+
+    PBIO_OS_ASYNC_END(PBIO_SUCCESS);
+}
+
+pbio_error_t pbdrv_uart_read_available(pbio_os_state_t *state, pbdrv_uart_dev_t *uart, uint8_t *msg, uint8_t length, uint8_t *size, uint32_t timeout) {
+
+    PBIO_OS_ASYNC_BEGIN(state);
+
+    if (uart->read_buf) {
+        return PBIO_ERROR_BUSY;
     }
 
-    uart->rx_tail = (uart->rx_tail + uart->read_length) & (RX_DATA_SIZE - 1);
-    uart->read_buf = NULL;
-    uart->read_length = 0;
+    uart->read_buf = msg;
+
+    if (timeout) {
+        pbio_os_timer_set(&uart->rx_timer, timeout);
+    }
+
+    // Wait until there is any data or timeout.
+    PBIO_OS_AWAIT_UNTIL(state, pbdrv_uart_get_num_available(uart) > 0 || (timeout && pbio_os_timer_is_expired(&uart->rx_timer)));
+
+    // Take everything that the DMA has written so far, up to the given size.
+    uart->read_length = pbio_int_math_min(pbdrv_uart_get_num_available(uart), length);
+    *size = uart->read_length;
+    if (uart->read_length == 0) {
+        uart->read_buf = NULL;
+        return PBIO_ERROR_TIMEDOUT;
+    }
+
+    pbdrv_uart_copy_rx_data(uart);
 
     PBIO_OS_ASYNC_END(PBIO_SUCCESS);
 }
@@ -0,0 +1,172 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2025 The Pybricks Authors
+
+// Replays recorded sensor data in the virtual hub drivers.
+//
+// Traces are text files with one sample per line, given as comma separated
+// integers. The first column is the time in milliseconds. This is the format
+// written by Logger.save(), so motor logs recorded on a hub can be used as-is.
+
+#include <pbdrv/config.h>
+
+#if PBDRV_CONFIG_VIRTUAL_REPLAY
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <pbdrv/clock.h>
+#include <pbio/util.h>
+
+#include "virtual_replay.h"
+
+typedef struct {
+    /** All samples, row by row. */
+    int32_t *data;
+    /** Number of rows in the trace. */
+    uint32_t num_rows;
+    /** Number of columns in each row, including time. */
+    uint32_t num_cols;
+    /** Row that is currently being replayed. */
+    uint32_t row;
+} pbdrv_virtual_replay_data_t;
+
+static const char *const trace_file_names[] = {
+    [PBDRV_VIRTUAL_REPLAY_TRACE_PORT_A] = "A.txt",
+    [PBDRV_VIRTUAL_REPLAY_TRACE_PORT_B] = "B.txt",
+    [PBDRV_VIRTUAL_REPLAY_TRACE_PORT_C] = "C.txt",
+    [PBDRV_VIRTUAL_REPLAY_TRACE_PORT_D] = "D.txt",
+    [PBDRV_VIRTUAL_REPLAY_TRACE_PORT_E] = "E.txt",
+    [PBDRV_VIRTUAL_REPLAY_TRACE_PORT_F] = "F.txt",
+    [PBDRV_VIRTUAL_REPLAY_TRACE_BATTERY] = "battery.txt",
+    [PBDRV_VIRTUAL_REPLAY_TRACE_BUTTON] = "button.txt",
+    [PBDRV_VIRTUAL_REPLAY_TRACE_IMU] = "imu.txt",
+};
+
+static pbdrv_virtual_replay_data_t traces[PBDRV_VIRTUAL_REPLAY_NUM_TRACES];
+
+/** Hub time at which all traces start. */
+static uint32_t start_time;
+
+/**
+ * Parses one line of comma separated integers.
+ *
+ * @param [in]  line        The line of text.
+ * @param [out] values      The parsed values.
+ * @param [in]  max_values  Maximum number of values to parse.
+ * @return                  Number of values parsed.
+ */
+static uint32_t pbdrv_virtual_replay_parse_line(const char *line, int32_t *values, uint32_t max_values) {
+    uint32_t count = 0;
+    while (count < max_values) {
+        char *end;
+        long value = strtol(line, &end, 10);
+        if (end == line) {
+            break;
+        }
+        values[count++] = value;
+        // Skip the separator, if any.
+        line = end;
+        while (*line == ',' || *line == ' ') {
+            line++;
+        }
+    }
+    return count;
+}
+
+static void pbdrv_virtual_replay_load(pbdrv_virtual_replay_data_t *trace, const char *path) {
+
+    FILE *file = fopen(path, "r");
+    if (!file) {
+        return;
+    }
+
+    char line[256];
+    int32_t values[32];
+    uint32_t capacity = 0;
+
+    while (fgets(line, sizeof(line), file)) {
+        uint32_t num_cols = pbdrv_virtual_replay_parse_line(line, values, PBIO_ARRAY_SIZE(values));
+
+        // The first row sets the number of columns. Skip rows that don't match.
+        if (trace->num_rows == 0 && num_cols >= 2) {
+            trace->num_cols = num_cols;
+        }
+        if (num_cols != trace->num_cols || num_cols == 0) {
+            continue;
+        }
+
+        if (trace->num_rows == capacity) {
+            capacity = capacity ? capacity * 2 : 1024;
+            int32_t *data = realloc(trace->data, capacity * trace->num_cols * sizeof(int32_t));
+            if (!data) {
+                break;
+            }
+            trace->data = data;
+        }
+
+        for (uint32_t col = 0; col < num_cols; col++) {
+            trace->data[trace->num_rows * trace->num_cols + col] = values[col];
+        }
+        trace->num_rows++;
+    }
+
+    fclose(file);
+}
+
+/**
+ * Loads the traces from the directory set by the PBIO_VIRTUAL_REPLAY env var,
+ * if any. Time zero of the traces is the current hub time plus the number of
+ * milliseconds set by PBIO_VIRTUAL_REPLAY_OFFSET. Previously loaded traces
+ * are discarded.
+ */
+void pbdrv_virtual_replay_init(void) {
+
+    for (uint32_t i = 0; i < PBIO_ARRAY_SIZE(traces); i++) {
+        free(traces[i].data);
+        traces[i] = (pbdrv_virtual_replay_data_t) { 0 };
+    }
+
+    const char *dir = getenv("PBIO_VIRTUAL_REPLAY");
+    if (!dir) {
+        return;
+    }
+
+    const char *offset = getenv("PBIO_VIRTUAL_REPLAY_OFFSET");
+    start_time = pbdrv_clock_get_ms() + (offset ? atoi(offset) : 0);
+
+    for (uint32_t i = 0; i < PBIO_ARRAY_SIZE(traces); i++) {
+        char path[1024];
+        snprintf(path, sizeof(path), "%s/%s", dir, trace_file_names[i]);
+        pbdrv_virtual_replay_load(&traces[i], path);
+    }
+}
+
+/**
+ * Gets the recorded sample for the current hub time.
+ *
+ * The last sample at or before the current time is used. Before the start of
+ * the trace, this is the first sample. After the end, it is the last sample.
+ *
+ * @param [in]  trace     Which trace to get the sample from.
+ * @param [in]  num_cols  Minimum number of columns, including time.
+ * @return                The sample, starting with its time, or NULL if there
+ *                        is no such trace.
+ */
+const int32_t *pbdrv_virtual_replay_get_row(pbdrv_virtual_replay_trace_t trace, uint32_t num_cols) {
+
+    pbdrv_virtual_replay_data_t *t = &traces[trace];
+    if (t->num_rows == 0 || t->num_cols < num_cols) {
+        return NULL;
+    }
+
+    // Time only moves forward, so continue from where we were.
+    int32_t now = pbdrv_clock_get_ms() - start_time;
+    while (t->row + 1 < t->num_rows && t->data[(t->row + 1) * t->num_cols] <= now) {
+        t->row++;
+    }
+
+    return &t->data[t->row * t->num_cols];
+}
+
+#endif // PBDRV_CONFIG_VIRTUAL_REPLAY
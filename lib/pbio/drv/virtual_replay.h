@@ -0,0 +1,51 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2025 The Pybricks Authors
+
+// Replays recorded sensor data in the virtual hub drivers.
+
+#ifndef _INTERNAL_PBDRV_VIRTUAL_REPLAY_H_
+#define _INTERNAL_PBDRV_VIRTUAL_REPLAY_H_
+
+#include <pbdrv/config.h>
+
+#if PBDRV_CONFIG_VIRTUAL_REPLAY
+
+#include <stdint.h>
+
+/**
+ * Recorded traces that can be replayed. Each is loaded from a file with the
+ * given name in the directory set by the PBIO_VIRTUAL_REPLAY env var.
+ */
+typedef enum {
+    /**
+     * Servo log of the motor on port A (A.txt), as saved by Motor.log.save().
+     * Columns 11 and 12 are the raw angle (deg) and speed (deg/s) of the
+     * motor shaft, without direction, gears or angle reset. Ports B to F
+     * follow in order.
+     */
+    PBDRV_VIRTUAL_REPLAY_TRACE_PORT_A,
+    PBDRV_VIRTUAL_REPLAY_TRACE_PORT_B,
+    PBDRV_VIRTUAL_REPLAY_TRACE_PORT_C,
+    PBDRV_VIRTUAL_REPLAY_TRACE_PORT_D,
+    PBDRV_VIRTUAL_REPLAY_TRACE_PORT_E,
+    PBDRV_VIRTUAL_REPLAY_TRACE_PORT_F,
+    /** Battery voltage in mV (battery.txt). */
+    PBDRV_VIRTUAL_REPLAY_TRACE_BATTERY,
+    /** Pressed buttons as ::pbio_button_flags_t (button.txt). */
+    PBDRV_VIRTUAL_REPLAY_TRACE_BUTTON,
+    /** Angular velocity (xyz) in deg/s and acceleration (xyz) in mm/s^2 (imu.txt). */
+    PBDRV_VIRTUAL_REPLAY_TRACE_IMU,
+    /** Number of traces. */
+    PBDRV_VIRTUAL_REPLAY_NUM_TRACES,
+} pbdrv_virtual_replay_trace_t;
+
+void pbdrv_virtual_replay_init(void);
+const int32_t *pbdrv_virtual_replay_get_row(pbdrv_virtual_replay_trace_t trace, uint32_t num_cols);
+
+#else // PBDRV_CONFIG_VIRTUAL_REPLAY
+
+#define pbdrv_virtual_replay_init()
+
+#endif // PBDRV_CONFIG_VIRTUAL_REPLAY
+
+#endif // _INTERNAL_PBDRV_VIRTUAL_REPLAY_H_
@@ -42,7 +42,11 @@ PT_THREAD(pbdrv_block_device_read(struct pt *pt, uint32_t offset, uint8_t *buffe
 /**
  * Store data on storage device, starting from the base address.
  *
- * This erases as many sectors as needed for the given size prior to writing.
+ * Only the sectors that overlap with the changed range from @p start to
+ * @p end are erased and rewritten with the corresponding part of @p buffer.
+ * All other sectors are left untouched, so they must already hold the same
+ * data as @p buffer. Anything in the rewritten sectors that lies beyond
+ * @p size is left erased. To store everything, use a range from 0 to @p size.
  *
  * On systems with data storage on an external chip, this is implemented with
  * non-blocking I/O operations.
@@ -53,14 +57,33 @@ PT_THREAD(pbdrv_block_device_read(struct pt *pt, uint32_t offset, uint8_t *buffe
  *
  * @param [in] pt       Protothread to run this function in.
  * @param [in] buffer   Data buffer to write.
- * @param [in] size     How many bytes to write.
+ * @param [in] size     Total size of the data in the buffer.
+ * @param [in] start    Offset of the first byte that changed.
+ * @param [in] end      Offset just past the last byte that changed.
  * @param [out] err     ::PBIO_SUCCESS on success.
- *                      ::PBIO_INVALID_ARGUMENT if size is too big.
+ *                      ::PBIO_INVALID_ARGUMENT if size or end is too big.
  *                      ::PBIO_ERROR_BUSY (driver-specific error)
  *                      ::PBIO_ERROR_TIMEDOUT (driver-specific error)
  *                      ::PBIO_ERROR_IO (driver-specific error)
  */
-PT_THREAD(pbdrv_block_device_store(struct pt *pt, uint8_t *buffer, uint32_t size, pbio_error_t *err));
+PT_THREAD(pbdrv_block_device_store(struct pt *pt, uint8_t *buffer, uint32_t size, uint32_t start, uint32_t end, pbio_error_t *err));
+
+/**
+ * Gets a pointer to data on a storage device, if it is memory mapped.
+ *
+ * This can be used to access stored data in place instead of reading it into
+ * RAM first. The data remains valid until the next call to
+ * ::pbdrv_block_device_store.
+ *
+ * @param [in] offset   Offset from the base address for this block device.
+ * @param [in] size     How many bytes will be accessed.
+ * @param [out] data    Pointer to the data.
+ * @return              ::PBIO_SUCCESS on success.
+ *                      ::PBIO_ERROR_INVALID_ARG if offset + size is too big.
+ *                      ::PBIO_ERROR_NOT_SUPPORTED if the storage device is
+ *                      not memory mapped.
+ */
+pbio_error_t pbdrv_block_device_get_mapped_data(uint32_t offset, uint32_t size, const uint8_t **data);
 
 #else
 
@@ -69,11 +92,14 @@ static inline PT_THREAD(pbdrv_block_device_read(struct pt *pt, uint32_t offset,
     *err = PBIO_ERROR_NOT_SUPPORTED;
     PT_END(pt);
 }
-static inline PT_THREAD(pbdrv_block_device_store(struct pt *pt, uint8_t *buffer, uint32_t size, pbio_error_t *err)) {
+static inline PT_THREAD(pbdrv_block_device_store(struct pt *pt, uint8_t *buffer, uint32_t size, uint32_t start, uint32_t end, pbio_error_t *err)) {
     PT_BEGIN(pt);
     *err = PBIO_ERROR_NOT_SUPPORTED;
     PT_END(pt);
 }
+static inline pbio_error_t pbdrv_block_device_get_mapped_data(uint32_t offset, uint32_t size, const uint8_t **data) {
+    return PBIO_ERROR_NOT_SUPPORTED;
+}
 
 #endif
 
@@ -86,7 +86,7 @@ struct _pbdrv_bluetooth_send_context_t {
     /** The data to be sent. This data must remain valid until @p done is called. */
     const uint8_t *data;
     /** The size of @p data. */
-    uint8_t size;
+    uint16_t size;
     /** The connection to use. Only characteristics with notify capability are allowed. */
     pbdrv_bluetooth_connection_t connection;
 };
@@ -269,6 +269,17 @@ void pbdrv_bluetooth_stop_advertising(void);
  */
 bool pbdrv_bluetooth_is_connected(pbdrv_bluetooth_connection_t connection);
 
+/**
+ * Gets the ATT MTU of the current central connection.
+ *
+ * Notifications sent with ::pbdrv_bluetooth_send() may be up to this size
+ * minus 3 bytes for the ATT header.
+ *
+ * @return                  The negotiated MTU or 23 (the minimum allowed
+ *                          by the Bluetooth spec) if not negotiated yet.
+ */
+uint16_t pbdrv_bluetooth_get_mtu(void);
+
 /**
  * Registers a callback that is called when Bluetooth event occurs.
  *
@@ -421,6 +432,10 @@ static inline bool pbdrv_bluetooth_is_connected(pbdrv_bluetooth_connection_t con
     return false;
 }
 
+static inline uint16_t pbdrv_bluetooth_get_mtu(void) {
+    return 23;
+}
+
 static inline void pbdrv_bluetooth_send(pbdrv_bluetooth_send_context_t *context) {
     if (context->done) {
         context->done();
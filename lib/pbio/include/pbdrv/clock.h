@@ -12,6 +12,8 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+#include <pbdrv/config.h>
+
 /**
  * Gets the current clock time in milliseconds (1e-3 seconds).
  */
@@ -57,6 +59,34 @@ void pbdrv_clock_busy_delay_ms(uint32_t ms);
  */
 bool pbdrv_clock_is_ticking(void);
 
+#if PBDRV_CONFIG_CLOCK_LINUX
+
+/**
+ * Tests if the clock is virtual, which is selected by setting the
+ * PBIO_VIRTUAL_TIME environment variable.
+ *
+ * @return True if the clock only moves when advanced by the port.
+ */
+bool pbdrv_clock_linux_is_virtual_time(void);
+
+/**
+ * Advances the virtual clock. Does nothing if the clock is not virtual.
+ *
+ * @param [in]  us  The number of microseconds to advance.
+ */
+void pbdrv_clock_linux_advance_virtual_time(uint32_t us);
+
+#else // PBDRV_CONFIG_CLOCK_LINUX
+
+static inline bool pbdrv_clock_linux_is_virtual_time(void) {
+    return false;
+}
+
+static inline void pbdrv_clock_linux_advance_virtual_time(uint32_t us) {
+}
+
+#endif // PBDRV_CONFIG_CLOCK_LINUX
+
 #endif /* _PBDRV_CLOCK_H_ */
 
 /** @} */
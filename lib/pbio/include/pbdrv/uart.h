@@ -47,6 +47,23 @@ int32_t pbdrv_uart_get_char(pbdrv_uart_dev_t *uart_dev);
  */
 pbio_error_t pbdrv_uart_read(pbio_os_state_t *state, pbdrv_uart_dev_t *uart_dev, uint8_t *msg, uint8_t length, uint32_t timeout);
 
+/**
+ * Asynchronously read all data that is available on the UART.
+ *
+ * This completes as soon as at least one byte has been received. Everything
+ * else that is already in the receive buffer is copied along with it, up to
+ * @p length bytes. This lets callers parse several messages in one pass.
+ *
+ * @param [in]  state     The protothread state.
+ * @param [in]  uart_dev  The UART device.
+ * @param [out] msg       The buffer to store the received data.
+ * @param [in]  length    The size of @p msg.
+ * @param [out] size      How many bytes were received.
+ * @param [in]  timeout   The timeout in milliseconds or 0 for no timeout.
+ * @return The error code.
+ */
+pbio_error_t pbdrv_uart_read_available(pbio_os_state_t *state, pbdrv_uart_dev_t *uart_dev, uint8_t *msg, uint8_t length, uint8_t *size, uint32_t timeout);
+
 /**
  * Asynchronously write to the UART.
  *
@@ -105,6 +122,10 @@ static inline pbio_error_t pbdrv_uart_read(pbio_os_state_t *state, pbdrv_uart_de
     return PBIO_ERROR_NOT_SUPPORTED;
 }
 
+static inline pbio_error_t pbdrv_uart_read_available(pbio_os_state_t *state, pbdrv_uart_dev_t *uart_dev, uint8_t *msg, uint8_t length, uint8_t *size, uint32_t timeout) {
+    return PBIO_ERROR_NOT_SUPPORTED;
+}
+
 #endif // PBDRV_CONFIG_UART
 
 #endif // _PBDRV_UART_H_
@@ -0,0 +1,77 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2025 The Pybricks Authors
+
+/**
+ * @addtogroup Broadcast pbio/broadcast: Fragmented broadcasts
+ *
+ * Splits broadcast payloads that do not fit in one advertisement into
+ * fragments, and puts them back together on hubs that observe them.
+ * @{
+ */
+
+#ifndef _PBIO_BROADCAST_H_
+#define _PBIO_BROADCAST_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/** Maximum size of the payload that fits in one advertisement. */
+#define PBIO_BROADCAST_ADV_DATA_MAX_SIZE (31 /* max adv data size */ - 5 /* overhead */)
+
+/**
+ * Type code of a fragment in the upper 3 bits of its first byte. The lower 5
+ * bits are the fragment index, followed by one byte for the sequence number
+ * of the payload and one byte for the number of fragments.
+ */
+#define PBIO_BROADCAST_FRAGMENT_TYPE (7)
+
+#define PBIO_BROADCAST_FRAGMENT_HEADER_SIZE (3)
+#define PBIO_BROADCAST_FRAGMENT_DATA_SIZE (PBIO_BROADCAST_ADV_DATA_MAX_SIZE - PBIO_BROADCAST_FRAGMENT_HEADER_SIZE)
+#define PBIO_BROADCAST_FRAGMENTS_MAX (4)
+
+/** Maximum size of a fragmented payload. */
+#define PBIO_BROADCAST_DATA_MAX_SIZE (PBIO_BROADCAST_FRAGMENTS_MAX * PBIO_BROADCAST_FRAGMENT_DATA_SIZE)
+
+/**
+ * Fragments of one payload received so far.
+ */
+typedef struct _pbio_broadcast_reassembly_t {
+    /** Sequence number of the payload being received. */
+    uint8_t sequence;
+    /** Number of fragments of the payload being received. */
+    uint8_t count;
+    /** Size of the data in the last fragment. */
+    uint8_t last_size;
+    /** Bit flags of fragments received so far. */
+    uint8_t received;
+    uint8_t data[PBIO_BROADCAST_DATA_MAX_SIZE];
+} pbio_broadcast_reassembly_t;
+
+/**
+ * Last payload received on one channel.
+ */
+typedef struct _pbio_broadcast_received_t {
+    /**
+     * Number of payloads received so far. Wraps around. Users that wait for
+     * new data keep their own copy of the count to compare with, so that
+     * they don't interfere with each other.
+     */
+    uint32_t count;
+    /** Size of the last payload. */
+    uint8_t size;
+    uint8_t data[PBIO_BROADCAST_DATA_MAX_SIZE];
+    /** Fragments of the next payload received so far. */
+    pbio_broadcast_reassembly_t fragments;
+} pbio_broadcast_received_t;
+
+uint8_t pbio_broadcast_get_num_fragments(size_t size);
+size_t pbio_broadcast_get_fragment(const uint8_t *payload, size_t size, uint8_t sequence, uint8_t index, uint8_t *fragment);
+bool pbio_broadcast_is_fragment(const uint8_t *data, size_t size);
+bool pbio_broadcast_add_fragment(pbio_broadcast_reassembly_t *reassembly, const uint8_t *fragment, size_t size, uint8_t *payload, size_t *payload_size);
+void pbio_broadcast_receive(pbio_broadcast_received_t *received, const uint8_t *data, size_t size);
+bool pbio_broadcast_is_received_since(const pbio_broadcast_received_t *received, uint32_t count);
+
+#endif // _PBIO_BROADCAST_H_
+
+/** @} */
@@ -0,0 +1,58 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2025 The Pybricks Authors
+
+/**
+ * @addtogroup ClockSync pbio/clock_sync: Clock synchronization
+ *
+ * Estimates the clock of another hub from time samples it sends.
+ * @{
+ */
+
+#ifndef _PBIO_CLOCK_SYNC_H_
+#define _PBIO_CLOCK_SYNC_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * State of the clock synchronization with a leader hub.
+ *
+ * The leader shares its clock. Samples arrive some time after the leader set
+ * the time, so the sample with the largest offset to the local clock is the
+ * most accurate. The drift between the clocks is estimated from how this
+ * offset changes over time.
+ */
+typedef struct _pbio_clock_sync_t {
+    /** At least one time sample was received from the leader. */
+    bool synced;
+    /** Estimated offset to the leader clock at local time @p offset_time. */
+    int32_t offset;
+    uint32_t offset_time;
+    /** First estimated offset, used to estimate drift. */
+    int32_t first_offset;
+    uint32_t first_time;
+    /** Estimated clock drift in parts per million. */
+    int32_t drift_ppm;
+    /** Best offset sample in the current window. */
+    bool window_valid;
+    int32_t window_offset;
+    uint32_t window_offset_time;
+    uint32_t window_start;
+    /** Last time given by pbio_clock_sync_get_time(), if any. */
+    bool time_given;
+    uint32_t last_time;
+} pbio_clock_sync_t;
+
+/** Offset estimates are renewed with the best sample in each window. */
+#define PBIO_CLOCK_SYNC_WINDOW_MS (1000)
+
+/** Drift is estimated once offsets have been tracked for at least this long. */
+#define PBIO_CLOCK_SYNC_DRIFT_MIN_TIME_MS (10000)
+
+void pbio_clock_sync_reset(pbio_clock_sync_t *sync);
+void pbio_clock_sync_update(pbio_clock_sync_t *sync, uint32_t leader_time, uint32_t now);
+bool pbio_clock_sync_get_time(pbio_clock_sync_t *sync, uint32_t now, uint32_t *time);
+
+#endif // _PBIO_CLOCK_SYNC_H_
+
+/** @} */
@@ -15,6 +15,12 @@
 
 typedef struct _pbio_port_lump_dev_t pbio_port_lump_dev_t;
 
+/**
+ * Pseudo mode that indicates that the device streams the data of a
+ * combination of modes, as set by ::pbio_port_lump_set_combi_mode.
+ */
+#define PBIO_PORT_LUMP_MODE_COMBI (LUMP_MAX_EXT_MODE + 1)
+
 /**
  * Structure containing information about a legodev device mode.
  */
@@ -39,14 +45,20 @@ pbio_error_t pbio_port_lump_data_send_thread(pbio_os_state_t *state, pbio_port_l
 
 pbio_error_t pbio_port_lump_data_recv_thread(pbio_os_state_t *state, pbio_port_lump_dev_t *lump_dev, pbdrv_uart_dev_t *uart_dev);
 
+size_t pbio_port_lump_data_size(lump_data_type_t type);
+
 pbio_error_t pbio_port_lump_is_ready(pbio_port_lump_dev_t *lump_dev);
 
 pbio_error_t pbio_port_lump_set_mode(pbio_port_lump_dev_t *lump_dev, uint8_t mode);
 
 pbio_error_t pbio_port_lump_get_data(pbio_port_lump_dev_t *lump_dev, uint8_t mode, void **data);
 
+pbio_error_t pbio_port_lump_get_data_time(pbio_port_lump_dev_t *lump_dev, uint32_t *time, uint32_t *count);
+
 pbio_error_t pbio_port_lump_set_mode_with_data(pbio_port_lump_dev_t *lump_dev, uint8_t mode, const void *data, uint8_t size);
 
+pbio_error_t pbio_port_lump_set_combi_mode(pbio_port_lump_dev_t *lump_dev, const uint8_t *modes, uint8_t num_modes);
+
 pbio_error_t pbio_port_lump_assert_type_id(pbio_port_lump_dev_t *lump_dev, lego_device_type_id_t *type_id);
 
 pbio_error_t pbio_port_lump_get_info(pbio_port_lump_dev_t *lump_dev, uint8_t *num_modes, uint8_t *current_mode, pbio_port_lump_mode_info_t **mode_info);
@@ -63,6 +75,10 @@ static inline pbio_port_lump_dev_t *pbio_port_lump_init_instance(uint8_t device_
     return NULL;
 }
 
+static inline size_t pbio_port_lump_data_size(lump_data_type_t type) {
+    return 0;
+}
+
 static inline pbio_error_t pbio_port_lump_is_ready(pbio_port_lump_dev_t *lump_dev) {
     return PBIO_ERROR_NOT_SUPPORTED;
 }
@@ -75,10 +91,20 @@ static inline pbio_error_t pbio_port_lump_get_data(pbio_port_lump_dev_t *lump_de
     return PBIO_ERROR_NOT_SUPPORTED;
 }
 
+static inline pbio_error_t pbio_port_lump_get_data_time(pbio_port_lump_dev_t *lump_dev, uint32_t *time, uint32_t *count) {
+    *time = 0;
+    *count = 0;
+    return PBIO_ERROR_NOT_SUPPORTED;
+}
+
 static inline pbio_error_t pbio_port_lump_set_mode_with_data(pbio_port_lump_dev_t *lump_dev, uint8_t mode, const void *data, uint8_t size) {
     return PBIO_ERROR_NOT_SUPPORTED;
 }
 
+static inline pbio_error_t pbio_port_lump_set_combi_mode(pbio_port_lump_dev_t *lump_dev, const uint8_t *modes, uint8_t num_modes) {
+    return PBIO_ERROR_NOT_SUPPORTED;
+}
+
 static inline pbio_error_t pbio_port_lump_assert_type_id(pbio_port_lump_dev_t *lump_dev, lego_device_type_id_t *type_id) {
     return PBIO_ERROR_NOT_SUPPORTED;
 }
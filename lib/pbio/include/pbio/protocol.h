@@ -24,7 +24,7 @@
 #define PBIO_PROTOCOL_VERSION_MAJOR 1
 
 /** The minor version number for the protocol. */
-#define PBIO_PROTOCOL_VERSION_MINOR 4
+#define PBIO_PROTOCOL_VERSION_MINOR 5
 
 /** The patch version number for the protocol. */
 #define PBIO_PROTOCOL_VERSION_PATCH 0
@@ -193,6 +193,29 @@ typedef enum {
      * @since Pybricks Profile v1.4.0
      */
     PBIO_PYBRICKS_COMMAND_WRITE_APP_DATA = 7,
+
+    /**
+     * Requests to queue one frame of app data for the user program.
+     *
+     * Unlike ::PBIO_PYBRICKS_COMMAND_WRITE_APP_DATA, frames are queued and
+     * read by the user program one at a time in the order they were sent.
+     *
+     * If there is no room for the frame, the hub responds with
+     * ::PBIO_PYBRICKS_ERROR_BUSY and the sender should try again later. If a
+     * frame has the same sequence number as the previously accepted frame, it
+     * is acknowledged but not queued again. This way, the sender can safely
+     * retry frames for which no response was received.
+     *
+     * Frames sent while no user program is reading them are discarded.
+     *
+     * Parameters:
+     * - sequence: Sequence number of this frame (8-bit unsigned integer). This
+     *   should be incremented by one for each new frame.
+     * - payload: The frame data (0 to 255 bytes).
+     *
+     * @since Pybricks Profile v1.5.0
+     */
+    PBIO_PYBRICKS_COMMAND_WRITE_APP_DATA_FRAME = 8,
 } pbio_pybricks_command_t;
 /**
  * Application-specific error codes that are used in ATT_ERROR_RSP.
@@ -261,6 +284,27 @@ typedef enum {
      * @since Pybricks Profile v1.4.0
      */
     PBIO_PYBRICKS_EVENT_WRITE_APP_DATA = 2,
+
+    /**
+     * App data frames sent from the hub to the host.
+     *
+     * Frames written while a notification is being sent are combined into
+     * the next notification, as many as fit.
+     *
+     * The payload is:
+     * - sequence: Sequence number of the first frame in this event (8-bit
+     *   unsigned integer). Following frames have consecutive numbers, so
+     *   the host can detect lost frames.
+     * - ack: Sequence number of the last frame accepted from the host with
+     *   ::PBIO_PYBRICKS_COMMAND_WRITE_APP_DATA_FRAME (8-bit unsigned integer).
+     * - credits: Number of bytes free in the hub receive queue, capped at 255
+     *   (8-bit unsigned integer). Each queued frame takes its size plus one.
+     * - frames: One or more frames, each prefixed by its size (8-bit unsigned
+     *   integer).
+     *
+     * @since Pybricks Profile v1.5.0
+     */
+    PBIO_PYBRICKS_EVENT_WRITE_APP_DATA_FRAMES = 3,
 } pbio_pybricks_event_t;
 
 /**
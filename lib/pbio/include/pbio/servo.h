@@ -38,7 +38,7 @@
 
 
 /** Number of values per row when servo data logger is active. */
-#define PBIO_SERVO_LOGGER_NUM_COLS (10)
+#define PBIO_SERVO_LOGGER_NUM_COLS (12)
 
 /**
  * The servo system combines a dcmotor and rotation sensor with a controller
@@ -23,4 +23,10 @@
 #error "Must define PBSYS_CONFIG_STATUS_LIGHT in pbsysconfig.h"
 #endif
 
+// Largest Bluetooth notification payload. Hubs without Bluetooth use the
+// smallest size, which also sizes the app data buffers in the same way.
+#ifndef PBSYS_CONFIG_BLUETOOTH_MAX_CHAR_SIZE
+#define PBSYS_CONFIG_BLUETOOTH_MAX_CHAR_SIZE (20)
+#endif
+
 #endif // _PBSYS_CONFIG_H_
@@ -34,6 +34,11 @@ void pbsys_host_rx_write(const uint8_t *data, uint32_t size);
 pbio_error_t pbsys_host_rx(uint8_t *data, uint32_t *size);
 pbio_error_t pbsys_host_tx(const uint8_t *data, uint32_t size);
 bool pbsys_host_tx_is_idle(void);
+void pbsys_host_app_data_set_enabled(bool enable);
+pbio_error_t pbsys_host_app_data_rx_write(uint8_t sequence, const uint8_t *data, uint32_t size);
+pbio_error_t pbsys_host_app_data_rx(uint8_t *data, uint32_t *size);
+uint32_t pbsys_host_app_data_tx_get_max_size(void);
+pbio_error_t pbsys_host_app_data_tx(const uint8_t *data, uint32_t size);
 
 #else // PBSYS_CONFIG_HOST
 
@@ -53,6 +58,19 @@ static inline pbio_error_t pbsys_host_tx(const uint8_t *data, uint32_t size) {
 static inline bool pbsys_host_tx_is_idle(void) {
     return false;
 }
+#define pbsys_host_app_data_set_enabled(enable)
+static inline pbio_error_t pbsys_host_app_data_rx_write(uint8_t sequence, const uint8_t *data, uint32_t size) {
+    return PBIO_ERROR_NOT_SUPPORTED;
+}
+static inline pbio_error_t pbsys_host_app_data_rx(uint8_t *data, uint32_t *size) {
+    return PBIO_ERROR_NOT_SUPPORTED;
+}
+static inline uint32_t pbsys_host_app_data_tx_get_max_size(void) {
+    return 0;
+}
+static inline pbio_error_t pbsys_host_app_data_tx(const uint8_t *data, uint32_t size) {
+    return PBIO_ERROR_NOT_SUPPORTED;
+}
 
 #endif // PBSYS_CONFIG_HOST
 
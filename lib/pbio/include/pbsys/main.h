@@ -148,7 +148,7 @@ static inline bool pbsys_main_stdin_event(uint8_t c) {
 }
 
 static inline const char *pbsys_main_get_application_version_hash(void) {
-    return NULL;
+    return "";
 }
 
 
@@ -7,6 +7,11 @@
 #define PBDRV_CONFIG_BUTTON                                 (1)
 #define PBDRV_CONFIG_BUTTON_TEST                            (1)
 
+#define PBDRV_CONFIG_BLOCK_DEVICE                           (1)
+#define PBDRV_CONFIG_BLOCK_DEVICE_TEST                      (1)
+#define PBDRV_CONFIG_BLOCK_DEVICE_TEST_SIZE                 (8 * 1024)
+#define PBDRV_CONFIG_BLOCK_DEVICE_TEST_SIZE_USER            (512)
+
 #define PBDRV_CONFIG_BLUETOOTH                              (1)
 #define PBDRV_CONFIG_BLUETOOTH_BTSTACK                      (1)
 #define PBDRV_CONFIG_BLUETOOTH_BTSTACK_HUB_KIND             0xff
@@ -19,6 +24,9 @@
 #define PBDRV_CONFIG_GPIO                                   (1)
 #define PBDRV_CONFIG_GPIO_VIRTUAL                           (1)
 
+#define PBDRV_CONFIG_IMU                                    (1)
+#define PBDRV_CONFIG_IMU_TEST                               (1)
+
 #define PBDRV_CONFIG_IOPORT                                 (1)
 #define PBDRV_CONFIG_IOPORT_NUM_DEV                         (6)
 
@@ -37,6 +45,9 @@
 #define PBDRV_CONFIG_PWM_TEST                               (1)
 
 #define PBDRV_CONFIG_UART                                   (1)
+#define PBDRV_CONFIG_UART_LUMP_EMULATOR                     (1)
+
+#define PBDRV_CONFIG_VIRTUAL_REPLAY                         (1)
 
 #define PBDRV_CONFIG_HAS_PORT_A                             (1)
 #define PBDRV_CONFIG_HAS_PORT_B                             (1)
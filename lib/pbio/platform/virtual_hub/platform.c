@@ -130,3 +130,16 @@ const pbdrv_motor_driver_virtual_simulation_platform_data_t
         .endstop_angle_positive = INFINITY,
     },
 };
+
+// Motors A and B drive a small robot, like the SPIKE Prime driving base.
+const pbdrv_motor_driver_virtual_simulation_drivebase_platform_data_t
+    pbdrv_motor_driver_virtual_simulation_drivebase_platform_data = {
+    .left_index = 0,
+    .right_index = 1,
+    .wheel_diameter = 56,
+    .axle_track = 112,
+    .mass = 0.5,
+    .inertia = 0.002,
+    .traction_stiffness = 100,
+    .traction_max = 2,
+};
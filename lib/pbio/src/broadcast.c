@@ -0,0 +1,144 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2025 The Pybricks Authors
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <pbio/broadcast.h>
+
+/**
+ * Gets the number of fragments needed to broadcast a payload.
+ *
+ * @param [in]  size        The size of the payload.
+ * @returns                 The number of fragments.
+ */
+uint8_t pbio_broadcast_get_num_fragments(size_t size) {
+    return (size + PBIO_BROADCAST_FRAGMENT_DATA_SIZE - 1) / PBIO_BROADCAST_FRAGMENT_DATA_SIZE;
+}
+
+/**
+ * Gets one fragment of a payload, including its header.
+ *
+ * @param [in]  payload     The payload, up to ::PBIO_BROADCAST_DATA_MAX_SIZE bytes.
+ * @param [in]  size        The size of @p payload.
+ * @param [in]  sequence    Sequence number that is different for each new payload.
+ * @param [in]  index       Index of the fragment.
+ * @param [out] fragment    Buffer of ::PBIO_BROADCAST_ADV_DATA_MAX_SIZE bytes for the fragment.
+ * @returns                 The size of the fragment.
+ */
+size_t pbio_broadcast_get_fragment(const uint8_t *payload, size_t size, uint8_t sequence, uint8_t index, uint8_t *fragment) {
+    size_t offset = index * PBIO_BROADCAST_FRAGMENT_DATA_SIZE;
+    size_t data_size = size - offset < PBIO_BROADCAST_FRAGMENT_DATA_SIZE ? size - offset : PBIO_BROADCAST_FRAGMENT_DATA_SIZE;
+
+    fragment[0] = PBIO_BROADCAST_FRAGMENT_TYPE << 5 | index;
+    fragment[1] = sequence;
+    fragment[2] = pbio_broadcast_get_num_fragments(size);
+    memcpy(&fragment[PBIO_BROADCAST_FRAGMENT_HEADER_SIZE], &payload[offset], data_size);
+    return PBIO_BROADCAST_FRAGMENT_HEADER_SIZE + data_size;
+}
+
+/**
+ * Tests if received data is a fragment of a larger payload.
+ *
+ * @param [in]  data        The received data.
+ * @param [in]  size        The size of @p data.
+ * @returns                 Whether @p data is a fragment.
+ */
+bool pbio_broadcast_is_fragment(const uint8_t *data, size_t size) {
+    return size >= PBIO_BROADCAST_FRAGMENT_HEADER_SIZE && data[0] >> 5 == PBIO_BROADCAST_FRAGMENT_TYPE;
+}
+
+/**
+ * Adds a received fragment to the payload being received.
+ *
+ * Fragments may arrive in any order, and any number of times. If a fragment of
+ * another payload arrives before all fragments are received, the fragments
+ * received so far are dropped.
+ *
+ * @param [in]  reassembly   The fragments received so far.
+ * @param [in]  fragment     The received fragment, including its header.
+ * @param [in]  size         The size of @p fragment.
+ * @param [out] payload      Buffer of ::PBIO_BROADCAST_DATA_MAX_SIZE bytes for the complete payload.
+ * @param [out] payload_size The size of the complete payload.
+ * @returns                  Whether this fragment completed the payload.
+ */
+bool pbio_broadcast_add_fragment(pbio_broadcast_reassembly_t *reassembly, const uint8_t *fragment, size_t size, uint8_t *payload, size_t *payload_size) {
+
+    if (!pbio_broadcast_is_fragment(fragment, size) || size > PBIO_BROADCAST_ADV_DATA_MAX_SIZE) {
+        return false;
+    }
+
+    uint8_t index = fragment[0] & 0x1F;
+    uint8_t sequence = fragment[1];
+    uint8_t count = fragment[2];
+    size_t data_size = size - PBIO_BROADCAST_FRAGMENT_HEADER_SIZE;
+
+    // Only the last fragment may be shorter than the others.
+    if (count > PBIO_BROADCAST_FRAGMENTS_MAX || index >= count ||
+        (index < count - 1 && data_size != PBIO_BROADCAST_FRAGMENT_DATA_SIZE)) {
+        return false;
+    }
+
+    // Start over if this is a new payload.
+    if (sequence != reassembly->sequence || count != reassembly->count) {
+        reassembly->sequence = sequence;
+        reassembly->count = count;
+        reassembly->received = 0;
+    }
+
+    memcpy(&reassembly->data[index * PBIO_BROADCAST_FRAGMENT_DATA_SIZE], &fragment[PBIO_BROADCAST_FRAGMENT_HEADER_SIZE], data_size);
+    if (index == count - 1) {
+        reassembly->last_size = data_size;
+    }
+    reassembly->received |= 1 << index;
+
+    // Wait until all fragments are received.
+    if (reassembly->received != (1 << count) - 1) {
+        return false;
+    }
+
+    *payload_size = (count - 1) * PBIO_BROADCAST_FRAGMENT_DATA_SIZE + reassembly->last_size;
+    memcpy(payload, reassembly->data, *payload_size);
+
+    // Collect the fragments again so that repeated broadcasts of the same
+    // payload are seen as new data, just like unfragmented broadcasts.
+    reassembly->received = 0;
+    return true;
+}
+
+/**
+ * Handles data received on a channel, which may be a fragment.
+ *
+ * @param [in]  received    The last payload received on the channel.
+ * @param [in]  data        The received data.
+ * @param [in]  size        The size of @p data, up to ::PBIO_BROADCAST_ADV_DATA_MAX_SIZE.
+ */
+void pbio_broadcast_receive(pbio_broadcast_received_t *received, const uint8_t *data, size_t size) {
+
+    if (!pbio_broadcast_is_fragment(data, size)) {
+        received->size = size;
+        memcpy(received->data, data, size);
+        received->count++;
+        return;
+    }
+
+    // Fragments are only used once all of them are received.
+    size_t payload_size;
+    if (pbio_broadcast_add_fragment(&received->fragments, data, size, received->data, &payload_size)) {
+        received->size = payload_size;
+        received->count++;
+    }
+}
+
+/**
+ * Tests if a payload was received since the count was taken.
+ *
+ * @param [in]  received    The last payload received on the channel.
+ * @param [in]  count       The value of the count when waiting started.
+ * @returns                 Whether a new payload was received.
+ */
+bool pbio_broadcast_is_received_since(const pbio_broadcast_received_t *received, uint32_t count) {
+    return received->count != count;
+}
@@ -0,0 +1,105 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2025 The Pybricks Authors
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <pbio/clock_sync.h>
+
+/**
+ * Resets the clock synchronization, so it waits for a new first sample.
+ *
+ * @param [in]  sync        The clock synchronization state.
+ */
+void pbio_clock_sync_reset(pbio_clock_sync_t *sync) {
+    memset(sync, 0, sizeof(*sync));
+}
+
+/**
+ * Gets the estimated offset to the leader clock, including drift.
+ *
+ * @param [in]  sync        The clock synchronization state.
+ * @param [in]  now         The local time.
+ * @returns                 The offset to add to @p now to get the leader time.
+ */
+static int32_t pbio_clock_sync_get_offset(const pbio_clock_sync_t *sync, uint32_t now) {
+    return sync->offset + (int64_t)sync->drift_ppm * (int32_t)(now - sync->offset_time) / 1000000;
+}
+
+/**
+ * Updates the clock estimate with a time received from the leader.
+ *
+ * @param [in]  sync        The clock synchronization state.
+ * @param [in]  leader_time The leader time in the received sample.
+ * @param [in]  now         The local time when it was received.
+ */
+void pbio_clock_sync_update(pbio_clock_sync_t *sync, uint32_t leader_time, uint32_t now) {
+    int32_t sample = leader_time - now;
+
+    if (!sync->synced) {
+        sync->offset = sync->first_offset = sample;
+        sync->offset_time = sync->first_time = now;
+        sync->window_start = now;
+        sync->window_valid = false;
+        sync->synced = true;
+        return;
+    }
+
+    if (!sync->window_valid || sample > sync->window_offset) {
+        sync->window_offset = sample;
+        sync->window_offset_time = now;
+        sync->window_valid = true;
+    }
+
+    // A sample ahead of the estimate is more accurate, so use it right away.
+    if (sample > pbio_clock_sync_get_offset(sync, now)) {
+        sync->offset = sample;
+        sync->offset_time = now;
+    }
+
+    if (now - sync->window_start < PBIO_CLOCK_SYNC_WINDOW_MS) {
+        return;
+    }
+
+    // Use the best sample of each window so the estimate can also go down.
+    sync->offset = sync->window_offset;
+    sync->offset_time = sync->window_offset_time;
+    sync->window_valid = false;
+    sync->window_start = now;
+
+    uint32_t elapsed = sync->offset_time - sync->first_time;
+    if (elapsed >= PBIO_CLOCK_SYNC_DRIFT_MIN_TIME_MS) {
+        sync->drift_ppm = (int64_t)(sync->offset - sync->first_offset) * 1000000 / elapsed;
+    }
+}
+
+/**
+ * Gets the estimated time of the leader clock.
+ *
+ * The estimate can go down when a window with later samples is used, but the
+ * time given here never goes back. It stays the same until the estimate has
+ * caught up instead.
+ *
+ * @param [in]  sync        The clock synchronization state.
+ * @param [in]  now         The local time.
+ * @param [out] time        The leader time in milliseconds.
+ * @returns                 @c true if the time is valid, @c false if no
+ *                          sample was received yet.
+ */
+bool pbio_clock_sync_get_time(pbio_clock_sync_t *sync, uint32_t now, uint32_t *time) {
+    if (!sync->synced) {
+        return false;
+    }
+
+    uint32_t estimate = now + pbio_clock_sync_get_offset(sync, now);
+
+    if (sync->time_given && (int32_t)(estimate - sync->last_time) < 0) {
+        estimate = sync->last_time;
+    }
+
+    sync->time_given = true;
+    sync->last_time = estimate;
+    *time = estimate;
+    return true;
+}
@@ -421,6 +421,13 @@ void pbio_imu_init(void) {
         return;
     }
     pbdrv_imu_set_data_handlers(imu_dev, pbio_imu_handle_frame_data_func, pbio_imu_handle_stationary_data_func);
+
+    #if !PBSYS_CONFIG_STORAGE
+    // Settings are never loaded without storage, so use the defaults.
+    static pbio_imu_persistent_settings_t default_settings;
+    pbio_imu_set_default_settings(&default_settings);
+    pbio_imu_apply_loaded_settings(&default_settings);
+    #endif
 }
 
 /**
@@ -30,6 +30,10 @@
 
 #define EV3_UART_MAX_MESSAGE_SIZE   (LUMP_MAX_MSG_SIZE + 3)
 
+// Received data is parsed in bulk. Fits at least one complete message in
+// addition to the incomplete remainder of a previous read.
+#define EV3_UART_RX_DATA_BUF_SIZE   (2 * EV3_UART_MAX_MESSAGE_SIZE)
+
 #define EV3_UART_MAX_DATA_ERR       6
 
 #define EV3_UART_TYPE_MIN           29      // EV3 color sensor
@@ -41,6 +45,17 @@
 #define EV3_UART_DATA_KEEP_ALIVE_TIMEOUT    100 /* msec */
 #define EV3_UART_IO_TIMEOUT                 250 /* msec */
 
+// Time after setting a mode combination during which data of the first mode
+// may still have been sent before the device got the request.
+#define EV3_UART_COMBI_SETUP_TIME           5 /* msec */
+
+// Maximum number of mode combinations stored from LUMP_INFO_MODE_COMBOS.
+#define EV3_UART_MAX_MODE_COMBOS            8
+
+// First payload byte of a LUMP_CMD_WRITE message that sets a mode combination.
+// It is followed by one (mode << 4 | value index) byte per requested value.
+#define EV3_UART_WRITE_COMBI_SET            0x20
+
 enum ev3_uart_info_bit {
     EV3_UART_INFO_BIT_CMD_TYPE,
     EV3_UART_INFO_BIT_CMD_MODES,
@@ -130,6 +145,19 @@ typedef struct {
     uint32_t time;
 } pbdrv_legodev_lump_data_set_t;
 
+typedef struct {
+    /** Modes in the combination, in the order in which their data is reported. */
+    uint8_t modes[LUMP_MAX_EXT_MODE + 1];
+    /** Number of modes in the combination. */
+    uint8_t num_modes;
+    /** Index of the device mode combination that includes all modes. */
+    uint8_t index;
+    /** Total size of the data of all modes. */
+    uint8_t size;
+    /** Whether the device was told to stream this combination. */
+    bool active;
+} pbdrv_legodev_lump_combi_t;
+
 
 // LUMP state for each port.
 struct _pbio_port_lump_dev_t {
@@ -139,6 +167,8 @@ struct _pbio_port_lump_dev_t {
     pbio_os_state_t write_pt;
     /** Buffer to hold messages received from the device. */
     uint8_t *rx_msg;
+    /** Buffer to hold raw data received from the device in data mode. */
+    uint8_t *rx_data;
     /** Buffer to hold messages transmitted to the device. */
     uint8_t *tx_msg;
     /** Data set buffer and status. */
@@ -150,6 +180,8 @@ struct _pbio_port_lump_dev_t {
      * the values could be foreign-endian.
      */
     uint8_t *bin_data;
+    /** Bit flags of device types that stopped sending data at a fast baud rate. */
+    uint32_t slow_baud_types[(UINT8_MAX + 1) / 32];
     /**
      * NB: Everything below is reset to 0 when synchronizing with a new device.
      *     type_id field should remain first.
@@ -168,14 +200,22 @@ struct _pbio_port_lump_dev_t {
     uint8_t ext_mode;
     /** New baud rate that will be set with ev3_uart_change_bitrate. */
     uint32_t new_baud_rate;
+    /** Whether a fast baud rate was set but has not been confirmed by data yet. */
+    bool fast_baud_pending;
     /** Size of the current message being transmitted. */
     uint8_t tx_msg_size;
     /** Size of the current message being received. */
     uint8_t rx_msg_size;
+    /** Number of bytes in rx_data that have not been parsed yet. */
+    uint8_t rx_data_size;
     /** Total number of errors that have occurred. */
     uint32_t err_count;
     /** Flag that indicates that good DATA lump_dev->msg has been received since last watchdog timeout. */
     bool data_rec;
+    /** Time at which bin_data was last updated. */
+    uint32_t data_time;
+    /** Number of times bin_data was updated. */
+    uint32_t data_count;
     /** Angle reported by the device. */
     pbio_angle_t angle;
     #if PBIO_CONFIG_PORT_LUMP_MODE_INFO
@@ -187,6 +227,12 @@ struct _pbio_port_lump_dev_t {
     uint8_t num_modes;
     /**< Information about the current mode. */
     pbio_port_lump_mode_info_t mode_info[(LUMP_MAX_EXT_MODE + 1)];
+    /** Mode combinations supported by the device, as bit flags of modes. */
+    uint16_t mode_combos[EV3_UART_MAX_MODE_COMBOS];
+    /** Number of supported mode combinations. */
+    uint8_t num_mode_combos;
+    /** Mode combination used when the mode is ::PBIO_PORT_LUMP_MODE_COMBI. */
+    pbdrv_legodev_lump_combi_t combi;
     #endif // PBIO_CONFIG_PORT_LUMP_MODE_INFO
 };
 
@@ -202,6 +248,7 @@ static uint8_t bufs[PBIO_CONFIG_PORT_LUMP_NUM_DEV][NUM_BUF][EV3_UART_MAX_MESSAGE
 
 // The following data is really just part of lump_devices, but separate allocation reduces overal code size
 static uint8_t data_read_bufs[PBIO_CONFIG_PORT_LUMP_NUM_DEV][LUMP_MAX_MSG_SIZE] __attribute__((aligned(4)));
+static uint8_t rx_data_bufs[PBIO_CONFIG_PORT_LUMP_NUM_DEV][EV3_UART_RX_DATA_BUF_SIZE];
 static pbdrv_legodev_lump_data_set_t data_set_bufs[PBIO_CONFIG_PORT_LUMP_NUM_DEV];
 
 pbio_port_lump_dev_t *pbio_port_lump_init_instance(uint8_t device_index) {
@@ -211,6 +258,7 @@ pbio_port_lump_dev_t *pbio_port_lump_init_instance(uint8_t device_index) {
     pbio_port_lump_dev_t *lump_dev = &lump_devices[device_index];
     lump_dev->tx_msg = &bufs[device_index][BUF_TX_MSG][0];
     lump_dev->rx_msg = &bufs[device_index][BUF_RX_MSG][0];
+    lump_dev->rx_data = rx_data_bufs[device_index];
     lump_dev->status = PBDRV_LEGODEV_LUMP_STATUS_ERR;
     lump_dev->err_count = 0;
     lump_dev->data_set = &data_set_bufs[device_index];
@@ -223,6 +271,9 @@ static void pbio_port_lump_request_mode(pbio_port_lump_dev_t *lump_dev, uint8_t
     lump_dev->mode_switch.desired_mode = mode;
     lump_dev->mode_switch.time = pbdrv_clock_get_ms();
     lump_dev->mode_switch.requested = true;
+    #if PBIO_CONFIG_PORT_LUMP_MODE_INFO
+    lump_dev->combi.active = false;
+    #endif
     pbio_os_request_poll();
 }
 
@@ -352,15 +403,44 @@ pbio_port_power_requirements_t pbio_port_lump_get_power_requirements(pbio_port_l
     return PBIO_PORT_POWER_REQUIREMENTS_NONE;
 }
 
-static void pbio_port_lump_lump_parse_msg(pbio_port_lump_dev_t *lump_dev) {
+/**
+ * Checks the checksum of a received message.
+ *
+ * @param [in]  lump_dev    The LEGO UART device instance.
+ * @param [in]  msg         The message.
+ * @param [in]  msg_size    The size of the message.
+ * @return                  True if the checksum is valid or can be ignored.
+ */
+static bool pbio_port_lump_msg_checksum_is_valid(pbio_port_lump_dev_t *lump_dev, const uint8_t *msg, uint8_t msg_size) {
+    if (msg_size <= 1) {
+        return true;
+    }
+
+    uint8_t checksum = 0xFF;
+    for (int i = 0; i < msg_size - 1; i++) {
+        checksum ^= msg[i];
+    }
+    if (checksum == msg[msg_size - 1]) {
+        return true;
+    }
+
+    // The LEGO EV3 color sensor sends bad checksums for RGB-RAW data
+    // (mode 4). The check here could be improved if someone can find a
+    // pattern.
+    return lump_dev->status == PBDRV_LEGODEV_LUMP_STATUS_DATA &&
+           lump_dev->type_id == LEGO_DEVICE_TYPE_ID_EV3_COLOR_SENSOR &&
+           msg[0] == (LUMP_MSG_TYPE_DATA | LUMP_MSG_SIZE_8 | 4);
+}
+
+static void pbio_port_lump_lump_parse_msg(pbio_port_lump_dev_t *lump_dev, uint8_t *msg) {
     uint32_t speed;
     uint8_t msg_type, cmd, msg_size, mode, cmd2;
 
-    msg_type = lump_dev->rx_msg[0] & LUMP_MSG_TYPE_MASK;
-    cmd = lump_dev->rx_msg[0] & LUMP_MSG_CMD_MASK;
-    msg_size = ev3_uart_get_msg_size(lump_dev->rx_msg[0]);
+    msg_type = msg[0] & LUMP_MSG_TYPE_MASK;
+    cmd = msg[0] & LUMP_MSG_CMD_MASK;
+    msg_size = ev3_uart_get_msg_size(msg[0]);
     mode = cmd;
-    cmd2 = lump_dev->rx_msg[1];
+    cmd2 = msg[1];
 
     // The original EV3 spec only allowed for up to 8 modes (3-bit number).
     // The Powered UP spec extents this by adding an extra flag to INFO commands.
@@ -373,28 +453,14 @@ static void pbio_port_lump_lump_parse_msg(pbio_port_lump_dev_t *lump_dev) {
         mode += lump_dev->ext_mode;
     }
 
-    if (msg_size > 1) {
-        uint8_t checksum = 0xFF;
-        for (int i = 0; i < msg_size - 1; i++) {
-            checksum ^= lump_dev->rx_msg[i];
-        }
-        if (checksum != lump_dev->rx_msg[msg_size - 1]) {
-            debug_pr("Bad checksum\n");
-            // if INFO messages are done and we are now receiving data, it is
-            // OK to occasionally have a bad checksum
-            if (lump_dev->status == PBDRV_LEGODEV_LUMP_STATUS_DATA) {
-
-                // The LEGO EV3 color sensor sends bad checksums
-                // for RGB-RAW data (mode 4). The check here could be
-                // improved if someone can find a pattern.
-                if (lump_dev->type_id != LEGO_DEVICE_TYPE_ID_EV3_COLOR_SENSOR
-                    || lump_dev->rx_msg[0] != (LUMP_MSG_TYPE_DATA | LUMP_MSG_SIZE_8 | 4)) {
-                    return;
-                }
-            } else {
-                goto err;
-            }
+    if (!pbio_port_lump_msg_checksum_is_valid(lump_dev, msg, msg_size)) {
+        debug_pr("Bad checksum\n");
+        // if INFO messages are done and we are now receiving data, it is
+        // OK to occasionally have a bad checksum
+        if (lump_dev->status == PBDRV_LEGODEV_LUMP_STATUS_DATA) {
+            return;
         }
+        goto err;
     }
 
     switch (msg_type) {
@@ -440,7 +506,7 @@ static void pbio_port_lump_lump_parse_msg(pbio_port_lump_dev_t *lump_dev) {
                     if (msg_size > 5) {
                         // Powered Up devices can have an extended mode message that
                         // includes modes > LUMP_MAX_MODE
-                        lump_dev->num_modes = lump_dev->rx_msg[3] + 1;
+                        lump_dev->num_modes = msg[3] + 1;
                     }
 
                     debug_pr("num_modes: %d\n", lump_dev->num_modes);
@@ -453,7 +519,7 @@ static void pbio_port_lump_lump_parse_msg(pbio_port_lump_dev_t *lump_dev) {
                         goto err;
                     }
                     #endif
-                    speed = pbio_get_uint32_le(lump_dev->rx_msg + 1);
+                    speed = pbio_get_uint32_le(msg + 1);
                     if (speed < EV3_UART_SPEED_MIN || speed > EV3_UART_SPEED_MAX) {
                         debug_pr("Speed is out of range\n");
                         goto err;
@@ -468,7 +534,7 @@ static void pbio_port_lump_lump_parse_msg(pbio_port_lump_dev_t *lump_dev) {
                 case LUMP_CMD_EXT_MODE:
                     // Powered up devices can have modes > LUMP_MAX_MODE. This
                     // command precedes other commands to add the extra 8 to the mode
-                    lump_dev->ext_mode = lump_dev->rx_msg[1];
+                    lump_dev->ext_mode = msg[1];
                     break;
                 case LUMP_CMD_VERSION:
                     #if PBIO_CONFIG_PORT_LUMP_MODE_INFO
@@ -477,8 +543,8 @@ static void pbio_port_lump_lump_parse_msg(pbio_port_lump_dev_t *lump_dev) {
                         goto err;
                     }
                     // TODO: this might be useful someday
-                    debug_pr("fw version: %08" PRIx32 "\n", pbio_get_uint32_le(lump_dev->rx_msg + 1));
-                    debug_pr("hw version: %08" PRIx32 "\n", pbio_get_uint32_le(lump_dev->rx_msg + 5));
+                    debug_pr("fw version: %08" PRIx32 "\n", pbio_get_uint32_le(msg + 1));
+                    debug_pr("hw version: %08" PRIx32 "\n", pbio_get_uint32_le(msg + 5));
                     #endif // LUMP_CMD_VERSION
                     break;
                 default:
@@ -491,7 +557,7 @@ static void pbio_port_lump_lump_parse_msg(pbio_port_lump_dev_t *lump_dev) {
                 case LUMP_INFO_NAME: {
                     size_t name_len = 1;
                     #if PBIO_CONFIG_PORT_LUMP_MODE_INFO
-                    if (lump_dev->rx_msg[2] < 'A' || lump_dev->rx_msg[2] > 'z') {
+                    if (msg[2] < 'A' || msg[2] > 'z') {
                         debug_pr("Invalid name INFO\n");
                         goto err;
                     }
@@ -502,8 +568,8 @@ static void pbio_port_lump_lump_parse_msg(pbio_port_lump_dev_t *lump_dev) {
                     * ensure a null terminator for the string
                     * functions.
                     */
-                    lump_dev->rx_msg[msg_size - 1] = 0;
-                    const char *name = (char *)(lump_dev->rx_msg + 2);
+                    msg[msg_size - 1] = 0;
+                    const char *name = (char *)(msg + 2);
                     name_len = strlen(name);
                     if (name_len > LUMP_MAX_NAME_SIZE) {
                         debug_pr("Name is too long\n");
@@ -518,14 +584,14 @@ static void pbio_port_lump_lump_parse_msg(pbio_port_lump_dev_t *lump_dev) {
 
                     debug_pr("new_mode: %d\n", lump_dev->new_mode);
                     debug_pr("flags: %02X %02X %02X %02X %02X %02X\n",
-                        lump_dev->rx_msg[8 + 0], lump_dev->rx_msg[8 + 1], lump_dev->rx_msg[8 + 2],
-                        lump_dev->rx_msg[8 + 3], lump_dev->rx_msg[8 + 4], lump_dev->rx_msg[8 + 5]);
+                        msg[8 + 0], msg[8 + 1], msg[8 + 2],
+                        msg[8 + 3], msg[8 + 4], msg[8 + 5]);
                     #endif // PBIO_CONFIG_PORT_LUMP_MODE_INFO
 
                     // newer LEGO UART devices send additional 6 mode capability flags
                     if (name_len <= LUMP_MAX_SHORT_NAME_SIZE && msg_size > LUMP_MAX_NAME_SIZE) {
                         // Only the first is used in practice.
-                        lump_dev->capabilities |= lump_dev->rx_msg[8];
+                        lump_dev->capabilities |= msg[8];
                     }
                     break;
                 }
@@ -546,10 +612,10 @@ static void pbio_port_lump_lump_parse_msg(pbio_port_lump_dev_t *lump_dev) {
                     }
 
                     // Mode supports writing if rx_msg[3] is nonzero.
-                    lump_dev->mode_info[mode].writable = lump_dev->rx_msg[3] != 0;
+                    lump_dev->mode_info[mode].writable = msg[3] != 0;
 
-                    debug_pr("mapping: in %02x out %02x\n", lump_dev->rx_msg[2], lump_dev->rx_msg[3]);
-                    debug_pr("mapping: in %02x out %02x\n", lump_dev->rx_msg[2], lump_dev->rx_msg[3]);
+                    debug_pr("mapping: in %02x out %02x\n", msg[2], msg[3]);
+                    debug_pr("mapping: in %02x out %02x\n", msg[2], msg[3]);
                     debug_pr("Writable: %d\n", lump_dev->mode_info[mode].writable);
 
                     break;
@@ -563,8 +629,16 @@ static void pbio_port_lump_lump_parse_msg(pbio_port_lump_dev_t *lump_dev) {
                         goto err;
                     }
 
-                    // REVISIT: this is potentially an array of combos
-                    debug_pr("mode combos: %04x\n", lump_dev->rx_msg[3] << 8 | lump_dev->rx_msg[2]);
+                    // Array of 16-bit mode flags, terminated by 0 if it
+                    // doesn't fill the message.
+                    for (uint8_t i = 2; i + 1 < msg_size - 1 && lump_dev->num_mode_combos < EV3_UART_MAX_MODE_COMBOS; i += 2) {
+                        uint16_t combo = pbio_get_uint16_le(msg + i);
+                        if (!combo) {
+                            break;
+                        }
+                        lump_dev->mode_combos[lump_dev->num_mode_combos++] = combo;
+                        debug_pr("mode combo: %04x\n", combo);
+                    }
 
                     break;
                 case LUMP_INFO_UNK9:
@@ -579,8 +653,8 @@ static void pbio_port_lump_lump_parse_msg(pbio_port_lump_dev_t *lump_dev) {
 
                     // first 3 parameters look like PID constants, 4th is max tacho_rate
                     debug_pr("motor parameters: %" PRIu32 " %" PRIu32 " %" PRIu32 " %" PRIu32 "\n",
-                        pbio_get_uint32_le(lump_dev->rx_msg + 2), pbio_get_uint32_le(lump_dev->rx_msg + 6),
-                        pbio_get_uint32_le(lump_dev->rx_msg + 10), pbio_get_uint32_le(lump_dev->rx_msg + 14));
+                        pbio_get_uint32_le(msg + 2), pbio_get_uint32_le(msg + 6),
+                        pbio_get_uint32_le(msg + 10), pbio_get_uint32_le(msg + 14));
 
                     break;
                 case LUMP_INFO_UNK11:
@@ -602,7 +676,7 @@ static void pbio_port_lump_lump_parse_msg(pbio_port_lump_dev_t *lump_dev) {
                         debug_pr("Received duplicate format INFO\n");
                         goto err;
                     }
-                    lump_dev->mode_info[mode].num_values = lump_dev->rx_msg[2];
+                    lump_dev->mode_info[mode].num_values = msg[2];
                     if (!lump_dev->mode_info[mode].num_values) {
                         debug_pr("Invalid number of data sets\n");
                         goto err;
@@ -615,7 +689,7 @@ static void pbio_port_lump_lump_parse_msg(pbio_port_lump_dev_t *lump_dev) {
                         debug_pr("Did not receive all required INFO\n");
                         goto err;
                     }
-                    lump_dev->mode_info[mode].data_type = lump_dev->rx_msg[3];
+                    lump_dev->mode_info[mode].data_type = msg[3];
                     if (lump_dev->new_mode) {
                         lump_dev->new_mode--;
                     }
@@ -640,9 +714,39 @@ static void pbio_port_lump_lump_parse_msg(pbio_port_lump_dev_t *lump_dev) {
             }
             #endif
 
+            #if PBIO_CONFIG_PORT_LUMP_MODE_INFO
+            // In a mode combination, the data of all modes is reported
+            // together as if it were data for the first mode. The size can't
+            // be used to tell them apart since both may have the same padded
+            // size, so all data of the first mode is used as combined data
+            // once the combination was sent to the device.
+            if (lump_dev->combi.active && mode == lump_dev->combi.modes[0]) {
+                // Data of the first mode by itself may still be on its way
+                // right after the combination was sent, and it may be too
+                // short, so skip it.
+                if (msg_size - 2 >= lump_dev->combi.size &&
+                    (lump_dev->mode == PBIO_PORT_LUMP_MODE_COMBI ||
+                     pbdrv_clock_get_ms() - lump_dev->mode_switch.time > EV3_UART_COMBI_SETUP_TIME)) {
+                    memcpy(lump_dev->bin_data, msg + 1, lump_dev->combi.size);
+                    lump_dev->data_time = pbdrv_clock_get_ms();
+                    lump_dev->data_count++;
+
+                    if (lump_dev->mode != PBIO_PORT_LUMP_MODE_COMBI) {
+                        // First time getting combined data, so register time.
+                        lump_dev->mode_switch.time = pbdrv_clock_get_ms();
+                    }
+                    lump_dev->mode = PBIO_PORT_LUMP_MODE_COMBI;
+                }
+                lump_dev->data_rec = true;
+                break;
+            }
+            #endif
+
             // Data is for requested mode.
             if (mode == lump_dev->mode_switch.desired_mode) {
-                memcpy(lump_dev->bin_data, lump_dev->rx_msg + 1, msg_size - 2);
+                memcpy(lump_dev->bin_data, msg + 1, msg_size - 2);
+                lump_dev->data_time = pbdrv_clock_get_ms();
+                lump_dev->data_count++;
 
                 if (lump_dev->mode != mode) {
                     // First time getting data in this mode, so register time.
@@ -719,6 +823,28 @@ static void ev3_uart_prepare_tx_msg(pbio_port_lump_dev_t *lump_dev, lump_msg_typ
     lump_dev->tx_msg_size = offset + i + 2;
 }
 
+#if PBIO_CONFIG_PORT_LUMP_MODE_INFO
+/**
+ * Prepares the message that makes the device stream all values of the modes
+ * in the requested mode combination.
+ *
+ * @param [in]  lump_dev    The LEGO UART device instance.
+ */
+static void pbio_port_lump_prepare_combi_msg(pbio_port_lump_dev_t *lump_dev) {
+    uint8_t payload[LUMP_MAX_MSG_SIZE];
+    uint8_t len = 0;
+
+    payload[len++] = EV3_UART_WRITE_COMBI_SET | lump_dev->combi.index;
+    for (uint8_t i = 0; i < lump_dev->combi.num_modes; i++) {
+        uint8_t mode = lump_dev->combi.modes[i];
+        for (uint8_t v = 0; v < lump_dev->mode_info[mode].num_values; v++) {
+            payload[len++] = mode << 4 | v;
+        }
+    }
+    ev3_uart_prepare_tx_msg(lump_dev, LUMP_MSG_TYPE_CMD, LUMP_CMD_WRITE, payload, len);
+}
+#endif // PBIO_CONFIG_PORT_LUMP_MODE_INFO
+
 /**
  * The synchronization thread for the LEGO UART device.
  *
@@ -818,6 +944,8 @@ sync:
     #if PBIO_CONFIG_PORT_LUMP_MODE_INFO
     lump_dev->info_flags = EV3_UART_INFO_FLAG_CMD_TYPE;
     lump_dev->num_modes = 1;
+    lump_dev->num_mode_combos = 0;
+    lump_dev->combi.num_modes = 0;
     #endif
     debug_pr("type id: %d\n", lump_dev->type_id);
 
@@ -849,7 +977,7 @@ sync:
         }
 
         // at this point, we have a full lump_dev->msg that can be parsed
-        pbio_port_lump_lump_parse_msg(lump_dev);
+        pbio_port_lump_lump_parse_msg(lump_dev, lump_dev->rx_msg);
     }
 
     // at this point we should have read all of the mode info
@@ -873,6 +1001,27 @@ sync:
     pbdrv_uart_set_baud_rate(uart_dev, lump_dev->new_baud_rate);
     debug_pr("set baud: %" PRIu32 "\n", lump_dev->new_baud_rate);
 
+    // Some devices can go faster than the rate they advertise. Ask for it,
+    // unless this type of device already stopped sending data at that rate
+    // on this port before.
+    if (lego_device_fast_baud_rate(lump_dev->type_id) > lump_dev->new_baud_rate &&
+        !(lump_dev->slow_baud_types[lump_dev->type_id / 32] & (1u << (lump_dev->type_id % 32)))) {
+        lump_dev->new_baud_rate = lego_device_fast_baud_rate(lump_dev->type_id);
+        pbio_set_uint32_le(speed_payload, lump_dev->new_baud_rate);
+        ev3_uart_prepare_tx_msg(lump_dev, LUMP_MSG_TYPE_CMD, LUMP_CMD_SPEED, speed_payload, sizeof(speed_payload));
+        PBIO_OS_AWAIT(state, &lump_dev->write_pt, err = pbdrv_uart_write(&lump_dev->write_pt, uart_dev, lump_dev->tx_msg, lump_dev->tx_msg_size, EV3_UART_IO_TIMEOUT));
+        if (err != PBIO_SUCCESS) {
+            debug_pr("UART Tx error during fast speed.\n");
+            return err;
+        }
+
+        // Give the device the same time to switch as after the ACK.
+        PBIO_OS_AWAIT_MS(state, timer, 10);
+        pbdrv_uart_set_baud_rate(uart_dev, lump_dev->new_baud_rate);
+        lump_dev->fast_baud_pending = true;
+        debug_pr("set fast baud: %" PRIu32 "\n", lump_dev->new_baud_rate);
+    }
+
     // Request switch to default mode for this device if any.
     uint8_t default_mode = 0;
     if (lump_dev->capabilities & LUMP_MODE_FLAGS0_MOTOR_ABS_POS) {
@@ -928,10 +1077,15 @@ pbio_error_t pbio_port_lump_data_send_thread(pbio_os_state_t *state, pbio_port_l
             // make sure we are receiving data
             if (!lump_dev->data_rec) {
                 debug_pr("No data since last keepalive\n");
+                // Fall back to the advertised rate on the next sync.
+                if (lump_dev->fast_baud_pending) {
+                    lump_dev->slow_baud_types[lump_dev->type_id / 32] |= 1u << (lump_dev->type_id % 32);
+                }
                 lump_dev->status = PBDRV_LEGODEV_LUMP_STATUS_ERR;
                 return PBIO_ERROR_TIMEDOUT;
             }
             lump_dev->data_rec = false;
+            lump_dev->fast_baud_pending = false;
             lump_dev->tx_msg[0] = LUMP_SYS_NACK;
             lump_dev->tx_msg_size = 1;
             PBIO_OS_AWAIT(state, &lump_dev->write_pt, err = pbdrv_uart_write(&lump_dev->write_pt, uart_dev, lump_dev->tx_msg, lump_dev->tx_msg_size, EV3_UART_IO_TIMEOUT));
@@ -945,12 +1099,38 @@ pbio_error_t pbio_port_lump_data_send_thread(pbio_os_state_t *state, pbio_port_l
         // Handle requested mode change
         if (lump_dev->mode_switch.requested) {
             lump_dev->mode_switch.requested = false;
-            ev3_uart_prepare_tx_msg(lump_dev, LUMP_MSG_TYPE_CMD, LUMP_CMD_SELECT, &lump_dev->mode_switch.desired_mode, 1);
+            #if PBIO_CONFIG_PORT_LUMP_MODE_INFO
+            // A mode combination is selected with its first mode.
+            if (lump_dev->mode_switch.desired_mode == PBIO_PORT_LUMP_MODE_COMBI) {
+                ev3_uart_prepare_tx_msg(lump_dev, LUMP_MSG_TYPE_CMD, LUMP_CMD_SELECT, &lump_dev->combi.modes[0], 1);
+            } else
+            #endif
+            {
+                ev3_uart_prepare_tx_msg(lump_dev, LUMP_MSG_TYPE_CMD, LUMP_CMD_SELECT, &lump_dev->mode_switch.desired_mode, 1);
+            }
             PBIO_OS_AWAIT(state, &lump_dev->write_pt, err = pbdrv_uart_write(&lump_dev->write_pt, uart_dev, lump_dev->tx_msg, lump_dev->tx_msg_size, EV3_UART_IO_TIMEOUT));
             if (err != PBIO_SUCCESS) {
                 debug_pr("Setting requested mode failed.\n");
                 return err;
             }
+
+            #if PBIO_CONFIG_PORT_LUMP_MODE_INFO
+            // Then all values of all modes in the combination are requested.
+            if (lump_dev->mode_switch.desired_mode == PBIO_PORT_LUMP_MODE_COMBI) {
+                pbio_port_lump_prepare_combi_msg(lump_dev);
+                PBIO_OS_AWAIT(state, &lump_dev->write_pt, err = pbdrv_uart_write(&lump_dev->write_pt, uart_dev, lump_dev->tx_msg, lump_dev->tx_msg_size, EV3_UART_IO_TIMEOUT));
+                if (err != PBIO_SUCCESS) {
+                    debug_pr("Setting mode combination failed.\n");
+                    return err;
+                }
+                // The device now streams the combination, unless another
+                // mode was requested while sending it.
+                lump_dev->combi.active = !lump_dev->mode_switch.requested;
+                if (lump_dev->combi.active) {
+                    lump_dev->mode_switch.time = pbdrv_clock_get_ms();
+                }
+            }
+            #endif
         }
 
         // Handle requested data set
@@ -979,6 +1159,59 @@ pbio_error_t pbio_port_lump_data_send_thread(pbio_os_state_t *state, pbio_port_l
     PBIO_OS_ASYNC_END(PBIO_SUCCESS);
 }
 
+/**
+ * Parses all complete messages in the received data, in place.
+ *
+ * Bytes that can't be the start of a valid data message are skipped one at a
+ * time until the stream is back in sync. An incomplete message at the end is
+ * kept so it can be completed by the next read.
+ *
+ * @param [in]  lump_dev    The LEGO UART device instance.
+ */
+static void pbio_port_lump_parse_data(pbio_port_lump_dev_t *lump_dev) {
+
+    uint8_t *msg = lump_dev->rx_data;
+    uint8_t *end = lump_dev->rx_data + lump_dev->rx_data_size;
+
+    while (msg < end) {
+        uint8_t msg_size = ev3_uart_get_msg_size(msg[0]);
+        if (msg_size < 3 || msg_size > EV3_UART_MAX_MESSAGE_SIZE) {
+            debug_pr("Bad data message size %d\n", msg_size);
+            msg++;
+            continue;
+        }
+
+        uint8_t msg_type = msg[0] & LUMP_MSG_TYPE_MASK;
+        uint8_t cmd = msg[0] & LUMP_MSG_CMD_MASK;
+        if (msg_type != LUMP_MSG_TYPE_DATA && (msg_type != LUMP_MSG_TYPE_CMD ||
+                                               (cmd != LUMP_CMD_WRITE && cmd != LUMP_CMD_EXT_MODE))) {
+            debug_pr("Bad msg type\n");
+            msg++;
+            continue;
+        }
+
+        // Wait for the rest of the message.
+        if (msg + msg_size > end) {
+            break;
+        }
+
+        // A bad checksum means that this was not really a header, so try
+        // again from the next byte.
+        if (!pbio_port_lump_msg_checksum_is_valid(lump_dev, msg, msg_size)) {
+            debug_pr("Bad checksum\n");
+            msg++;
+            continue;
+        }
+
+        pbio_port_lump_lump_parse_msg(lump_dev, msg);
+        msg += msg_size;
+    }
+
+    // Keep the remainder for the next pass.
+    lump_dev->rx_data_size = end - msg;
+    memmove(lump_dev->rx_data, msg, lump_dev->rx_data_size);
+}
+
 /**
  * The receive thread for the LEGO UART device.
  *
@@ -995,42 +1228,25 @@ pbio_error_t pbio_port_lump_data_recv_thread(pbio_os_state_t *state, pbio_port_l
     }
 
     pbio_error_t err;
-
-    // REVISIT: This is not the greatest. We can easily get a buffer overrun and
-    // loose data. For now, the retry after bad message size helps get back into
-    // sync with the data stream.
+    uint8_t size;
 
     PBIO_OS_ASYNC_BEGIN(state);
 
-    while (true) {
-        PBIO_OS_AWAIT(state, &lump_dev->read_pt, err = pbdrv_uart_read(&lump_dev->read_pt, uart_dev, lump_dev->rx_msg, 1, EV3_UART_IO_TIMEOUT));
-        if (err != PBIO_SUCCESS) {
-            debug_pr("UART Rx data header end error\n");
-            return err;
-        }
-
-        lump_dev->rx_msg_size = ev3_uart_get_msg_size(lump_dev->rx_msg[0]);
-        if (lump_dev->rx_msg_size < 3 || lump_dev->rx_msg_size > EV3_UART_MAX_MESSAGE_SIZE) {
-            debug_pr("Bad data message size %d\n", lump_dev->rx_msg_size);
-            continue;
-        }
+    lump_dev->rx_data_size = 0;
 
-        uint8_t msg_type = lump_dev->rx_msg[0] & LUMP_MSG_TYPE_MASK;
-        uint8_t cmd = lump_dev->rx_msg[0] & LUMP_MSG_CMD_MASK;
-        if (msg_type != LUMP_MSG_TYPE_DATA && (msg_type != LUMP_MSG_TYPE_CMD ||
-                                               (cmd != LUMP_CMD_WRITE && cmd != LUMP_CMD_EXT_MODE))) {
-            debug_pr("Bad msg type\n");
-            continue;
-        }
-
-        PBIO_OS_AWAIT(state, &lump_dev->read_pt, err = pbdrv_uart_read(&lump_dev->read_pt, uart_dev, lump_dev->rx_msg + 1, lump_dev->rx_msg_size - 1, EV3_UART_IO_TIMEOUT));
+    while (true) {
+        // Get everything the UART driver has received so far, appended to
+        // the incomplete remainder of the previous pass.
+        PBIO_OS_AWAIT(state, &lump_dev->read_pt, err = pbdrv_uart_read_available(&lump_dev->read_pt, uart_dev,
+            lump_dev->rx_data + lump_dev->rx_data_size, EV3_UART_RX_DATA_BUF_SIZE - lump_dev->rx_data_size, &size, EV3_UART_IO_TIMEOUT));
         if (err != PBIO_SUCCESS) {
             debug_pr("UART Rx data end error\n");
             return err;
         }
+        lump_dev->rx_data_size += size;
 
-        // at this point, we have a full lump_dev->msg that can be parsed
-        pbio_port_lump_lump_parse_msg(lump_dev);
+        // Parse all complete messages in one go.
+        pbio_port_lump_parse_data(lump_dev);
     }
 
     // Unreachable.
@@ -1135,6 +1351,86 @@ pbio_error_t pbio_port_lump_set_mode(pbio_port_lump_dev_t *lump_dev, uint8_t mod
     return PBIO_SUCCESS;
 }
 
+/**
+ * Starts streaming the data of several modes of a LEGO UART device at once.
+ *
+ * Once ready, the data is available with ::pbio_port_lump_get_data for mode
+ * ::PBIO_PORT_LUMP_MODE_COMBI. It holds the values of each mode in the given
+ * order, without padding in between.
+ *
+ * The device keeps streaming the combination until another mode is set with
+ * ::pbio_port_lump_set_mode, which is also how the combination is stopped.
+ *
+ * @param [in]  lump_dev    The LEGO UART device instance.
+ * @param [in]  modes       The modes to combine.
+ * @param [in]  num_modes   The number of modes.
+ * @return                  ::PBIO_SUCCESS on success or if the combination is already set.
+ *                          ::PBIO_ERROR_NO_DEV if the port does not have a device attached.
+ *                          ::PBIO_ERROR_INVALID_ARG if the modes can't be combined.
+ *                          ::PBIO_ERROR_AGAIN if the device is not ready for this operation.
+ *                          ::PBIO_ERROR_NOT_SUPPORTED if mode info is not enabled.
+ */
+pbio_error_t pbio_port_lump_set_combi_mode(pbio_port_lump_dev_t *lump_dev, const uint8_t *modes, uint8_t num_modes) {
+
+    if (!lump_dev) {
+        return PBIO_ERROR_NO_DEV;
+    }
+
+    #if PBIO_CONFIG_PORT_LUMP_MODE_INFO
+
+    // Combination already set or being set, so return success.
+    if (lump_dev->mode_switch.desired_mode == PBIO_PORT_LUMP_MODE_COMBI &&
+        lump_dev->combi.num_modes == num_modes && !memcmp(lump_dev->combi.modes, modes, num_modes)) {
+        return PBIO_SUCCESS;
+    }
+
+    // We can only initiate a mode switch if currently idle (receiving data).
+    pbio_error_t err = pbio_port_lump_is_ready(lump_dev);
+    if (err != PBIO_SUCCESS) {
+        return err;
+    }
+
+    if (num_modes == 0 || num_modes > PBIO_ARRAY_SIZE(lump_dev->combi.modes)) {
+        return PBIO_ERROR_INVALID_ARG;
+    }
+
+    // Modes must exist and each may be used only once. The data and the
+    // request for all values must each fit in one message.
+    uint16_t flags = 0;
+    uint32_t size = 0;
+    uint32_t num_values = 0;
+    for (uint8_t i = 0; i < num_modes; i++) {
+        if (modes[i] >= lump_dev->num_modes || flags & (1 << modes[i])) {
+            return PBIO_ERROR_INVALID_ARG;
+        }
+        flags |= 1 << modes[i];
+        const pbio_port_lump_mode_info_t *info = &lump_dev->mode_info[modes[i]];
+        size += info->num_values * pbio_port_lump_data_size(info->data_type);
+        num_values += info->num_values;
+    }
+    if (size > LUMP_MAX_MSG_SIZE || num_values + 1 > LUMP_MAX_MSG_SIZE) {
+        return PBIO_ERROR_INVALID_ARG;
+    }
+
+    // Find a combination advertised by the device that has all modes.
+    for (uint8_t c = 0; c < lump_dev->num_mode_combos; c++) {
+        if ((lump_dev->mode_combos[c] & flags) != flags) {
+            continue;
+        }
+        memcpy(lump_dev->combi.modes, modes, num_modes);
+        lump_dev->combi.num_modes = num_modes;
+        lump_dev->combi.index = c;
+        lump_dev->combi.size = size;
+        pbio_port_lump_request_mode(lump_dev, PBIO_PORT_LUMP_MODE_COMBI);
+        return PBIO_SUCCESS;
+    }
+    return PBIO_ERROR_INVALID_ARG;
+
+    #else
+    return PBIO_ERROR_NOT_SUPPORTED;
+    #endif // PBIO_CONFIG_PORT_LUMP_MODE_INFO
+}
+
 /**
  * Asserts or gets the device id of a LEGO UART device.
  *
@@ -1199,6 +1495,29 @@ pbio_error_t pbio_port_lump_get_data(pbio_port_lump_dev_t *lump_dev, uint8_t mod
     return pbio_port_lump_is_ready(lump_dev);
 }
 
+/**
+ * Gets when the data returned by ::pbio_port_lump_get_data was received.
+ *
+ * The count increments with every received sample, so comparing it to a
+ * previous value tells whether the data is new.
+ *
+ * @param [in]  lump_dev    The LEGO UART device instance.
+ * @param [out] time        Time in milliseconds at which the data was received.
+ * @param [out] count       Number of samples received since synchronization.
+ * @return                  ::PBIO_SUCCESS on success.
+ *                          ::PBIO_ERROR_NO_DEV if the port does not have a device attached.
+ */
+pbio_error_t pbio_port_lump_get_data_time(pbio_port_lump_dev_t *lump_dev, uint32_t *time, uint32_t *count) {
+
+    if (!lump_dev) {
+        return PBIO_ERROR_NO_DEV;
+    }
+
+    *time = lump_dev->data_time;
+    *count = lump_dev->data_count;
+    return PBIO_SUCCESS;
+}
+
 /**
  * Set data for the current mode.
  *
@@ -1238,7 +1557,8 @@ pbio_error_t pbio_port_lump_set_mode_with_data(pbio_port_lump_dev_t *lump_dev, u
  *
  * @param [in]  lump_dev     The LEGO UART device instance.
  * @param [out] num_modes    The number of modes.
- * @param [out] current_mode The current mode.
+ * @param [out] current_mode The current mode. In a mode combination, this is
+ *                           the first mode of the combination.
  * @param [out] mode_info    The mode information array.
  * @return                   Error code.
  */
@@ -1249,7 +1569,7 @@ pbio_error_t pbio_port_lump_get_info(pbio_port_lump_dev_t *lump_dev, uint8_t *nu
         return err;
     }
     #if PBIO_CONFIG_PORT_LUMP_MODE_INFO
-    *current_mode = lump_dev->mode;
+    *current_mode = lump_dev->mode == PBIO_PORT_LUMP_MODE_COMBI ? lump_dev->combi.modes[0] : lump_dev->mode;
     *num_modes = lump_dev->num_modes;
     *mode_info = lump_dev->mode_info;
     #endif
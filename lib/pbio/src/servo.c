@@ -121,6 +121,16 @@ static pbio_error_t pbio_servo_update(pbio_servo_t *srv) {
         uint32_t stall_duration;
         pbio_servo_is_stalled(srv, &stalled, &stall_duration);
 
+        // Undo the positive direction and zero point to get the motor
+        // shaft angle as the driver reports it.
+        pbio_angle_t raw_angle = state.position;
+        int32_t raw_speed = state.speed;
+        if (srv->tacho.direction == PBIO_DIRECTION_COUNTERCLOCKWISE) {
+            pbio_angle_neg(&raw_angle);
+            raw_speed = -raw_speed;
+        }
+        pbio_angle_sum(&raw_angle, &srv->tacho.zero_angle, &raw_angle);
+
         int32_t log_data[] = {
             // Column 0: Log time (added by logger).
             // Column 1: Current time.
@@ -143,6 +153,10 @@ static pbio_error_t pbio_servo_update(pbio_servo_t *srv) {
             feedforward_torque,
             // Column 10: Observer error feedback voltage torque (mV).
             pbio_observer_get_feedback_voltage(&srv->observer, &state.position),
+            // Column 11: Raw motor shaft angle in degrees, without gears.
+            pbio_angle_to_low_res(&raw_angle, 1000),
+            // Column 12: Raw motor shaft speed in degrees/second, without gears.
+            raw_speed / 1000,
         };
         pbio_logger_add_row(&srv->log, log_data);
     }
@@ -15,6 +15,7 @@
 
 #include <pbdrv/bluetooth.h>
 #include <pbio/error.h>
+#include <pbio/int_math.h>
 #include <pbio/protocol.h>
 #include <pbio/util.h>
 #include <pbsys/host.h>
@@ -24,8 +25,13 @@
 
 #include "storage.h"
 
-// REVISIT: this can be the negotiated MTU - 3 to allow for better throughput
-#define MAX_CHAR_SIZE 20
+// Largest notification payload. Buffers are sized by this, so it is set per
+// platform. The actual size is also limited by pbdrv_bluetooth_get_mtu().
+#define MAX_CHAR_SIZE PBSYS_CONFIG_BLUETOOTH_MAX_CHAR_SIZE
+
+#if MAX_CHAR_SIZE < 20 || MAX_CHAR_SIZE > PBDRV_BLUETOOTH_MAX_MTU_SIZE - 3
+#error PBSYS_CONFIG_BLUETOOTH_MAX_CHAR_SIZE out of range
+#endif
 
 // REVISIT: this needs to be moved to a common place where it can be shared with USB
 static pbsys_host_stdin_event_callback_t stdin_event_callback;
@@ -40,6 +46,20 @@ typedef struct {
 } send_msg_t;
 
 static send_msg_t stdout_msg;
+
+// App data frames are stored in the ring buffers with a one byte size prefix.
+static lwrb_t app_data_rx_ring_buf;
+static lwrb_t app_data_tx_ring_buf;
+static send_msg_t app_data_msg;
+static bool app_data_enabled;
+static bool app_data_rx_sequence_valid;
+static uint8_t app_data_rx_sequence;
+static uint8_t app_data_tx_sequence;
+// The host has to be told about new credits even if there are no frames.
+static bool app_data_rx_update_pending;
+
+// Event type, sequence, ack and credits.
+#define APP_DATA_EVENT_HEADER_SIZE 4
 LIST(send_queue);
 static bool send_busy;
 
@@ -59,8 +79,15 @@ void pbsys_bluetooth_init(void) {
     // enough for one packet received + 1 byte for ring buf pointer
     static uint8_t stdin_buf[PBDRV_BLUETOOTH_MAX_MTU_SIZE - 3 + 1];
 
+    // enough for two packets worth of frames in each direction + 1 byte for
+    // ring buf pointer
+    static uint8_t app_data_rx_buf[MAX_CHAR_SIZE * 2 + 1];
+    static uint8_t app_data_tx_buf[MAX_CHAR_SIZE * 2 + 1];
+
     lwrb_init(&stdout_ring_buf, stdout_buf, PBIO_ARRAY_SIZE(stdout_buf));
     lwrb_init(&stdin_ring_buf, stdin_buf, PBIO_ARRAY_SIZE(stdin_buf));
+    lwrb_init(&app_data_rx_ring_buf, app_data_rx_buf, PBIO_ARRAY_SIZE(app_data_rx_buf));
+    lwrb_init(&app_data_tx_ring_buf, app_data_tx_buf, PBIO_ARRAY_SIZE(app_data_tx_buf));
 
     process_start(&pbsys_bluetooth_process);
 }
@@ -96,6 +123,67 @@ void pbsys_bluetooth_rx_write(const uint8_t *data, uint32_t size) {
     }
 }
 
+/**
+ * Makes sure an app data frames event is sent soon, so the host gets the
+ * current credits even if the program has no frames to send.
+ */
+static void pbsys_bluetooth_app_data_queue_update(void) {
+    if (!pbdrv_bluetooth_is_connected(PBDRV_BLUETOOTH_CONNECTION_PYBRICKS)) {
+        return;
+    }
+
+    app_data_rx_update_pending = true;
+
+    if (!app_data_msg.is_queued) {
+        app_data_msg.context.connection = PBDRV_BLUETOOTH_CONNECTION_PYBRICKS;
+        list_add(send_queue, &app_data_msg);
+        app_data_msg.is_queued = true;
+    }
+
+    pbsys_bluetooth_process_poll();
+}
+
+/**
+ * Queues one app data frame received from the host.
+ *
+ * @param [in]  sequence    The sequence number of the frame.
+ * @param [in]  data        The frame data.
+ * @param [in]  size        The size of @p data in bytes.
+ * @return                  ::PBIO_SUCCESS if the frame was queued, was a
+ *                          duplicate or app data is not enabled,
+ *                          ::PBIO_ERROR_BUSY if the queue is full or
+ *                          ::PBIO_ERROR_INVALID_ARG if the frame is too big.
+ */
+pbio_error_t pbsys_bluetooth_app_data_rx_write(uint8_t sequence, const uint8_t *data, uint32_t size) {
+    // Discard frames if nothing is reading them, like unframed app data.
+    if (!app_data_enabled) {
+        return PBIO_SUCCESS;
+    }
+
+    if (size > UINT8_MAX) {
+        return PBIO_ERROR_INVALID_ARG;
+    }
+
+    // The host resends a frame if it did not get a response, which may
+    // happen even if the frame was received.
+    if (app_data_rx_sequence_valid && sequence == app_data_rx_sequence) {
+        return PBIO_SUCCESS;
+    }
+
+    if (lwrb_get_free(&app_data_rx_ring_buf) < size + 1) {
+        return PBIO_ERROR_BUSY;
+    }
+
+    uint8_t frame_size = size;
+    lwrb_write(&app_data_rx_ring_buf, &frame_size, 1);
+    lwrb_write(&app_data_rx_ring_buf, data, size);
+
+    app_data_rx_sequence = sequence;
+    app_data_rx_sequence_valid = true;
+
+    return PBIO_SUCCESS;
+}
+
 // Public API
 
 /**
@@ -185,12 +273,120 @@ pbio_error_t pbsys_bluetooth_tx(const uint8_t *data, uint32_t *size) {
     }
 
     // poke the process to start tx soon-ish. This way, we can accumulate up to
-    // MAX_CHAR_SIZE bytes before actually transmitting
+    // one full notification worth of bytes before actually transmitting
     pbsys_bluetooth_process_poll();
 
     return *size == full_size ? PBIO_SUCCESS : PBIO_ERROR_AGAIN;
 }
 
+/**
+ * Enables or disables app data frames.
+ *
+ * Enabling or disabling clears any frames that are still queued.
+ *
+ * This is called by the reader of the frames, so it must not reset the ring
+ * buffer while the receive path may be writing to it. Instead, frames are
+ * no longer accepted while the queued frames are skipped, which only moves
+ * the read pointer.
+ *
+ * @param [in]  enable      Whether frames should be accepted.
+ */
+void pbsys_bluetooth_app_data_set_enabled(bool enable) {
+    app_data_enabled = false;
+    lwrb_skip(&app_data_rx_ring_buf, lwrb_get_full(&app_data_rx_ring_buf));
+    app_data_rx_sequence_valid = false;
+    app_data_enabled = enable;
+
+    // All credits are available again.
+    if (enable) {
+        pbsys_bluetooth_app_data_queue_update();
+    }
+}
+
+/**
+ * Reads one app data frame received from the host.
+ *
+ * @param data  [in]        A buffer to receive a copy of the frame. Frames
+ *                          are at most 255 bytes.
+ * @param size  [in, out]   The size of @p data. After return, @p size
+ *                          contains the size of the frame.
+ * @return                  ::PBIO_SUCCESS if a frame was read,
+ *                          ::PBIO_ERROR_AGAIN if no frame is available or
+ *                          ::PBIO_ERROR_INVALID_ARG if @p data is too small.
+ */
+pbio_error_t pbsys_bluetooth_app_data_rx(uint8_t *data, uint32_t *size) {
+    uint8_t frame_size;
+
+    if (lwrb_peek(&app_data_rx_ring_buf, 0, &frame_size, 1) == 0) {
+        return PBIO_ERROR_AGAIN;
+    }
+
+    if (frame_size > *size) {
+        return PBIO_ERROR_INVALID_ARG;
+    }
+
+    lwrb_skip(&app_data_rx_ring_buf, 1);
+    *size = lwrb_read(&app_data_rx_ring_buf, data, frame_size);
+
+    // Reading made room, so give the host more credits.
+    pbsys_bluetooth_app_data_queue_update();
+
+    return PBIO_SUCCESS;
+}
+
+/**
+ * Gets the maximum size of app data frames sent to the host.
+ *
+ * @return                  The size in bytes, based on the negotiated MTU.
+ */
+uint32_t pbsys_bluetooth_app_data_tx_get_max_size(void) {
+    uint32_t max_size = pbio_int_math_min(pbdrv_bluetooth_get_mtu() - 3, MAX_CHAR_SIZE);
+    return pbio_int_math_min(max_size - APP_DATA_EVENT_HEADER_SIZE - 1, UINT8_MAX);
+}
+
+/**
+ * Queues one app data frame to be sent to the host.
+ *
+ * Frames queued while a notification is being sent are combined into one
+ * notification where possible.
+ *
+ * @param data  [in]        The frame data.
+ * @param size  [in]        The size of @p data in bytes.
+ * @return                  ::PBIO_SUCCESS if the frame was queued,
+ *                          ::PBIO_ERROR_AGAIN if the queue is full,
+ *                          ::PBIO_ERROR_INVALID_ARG if the frame is too big
+ *                          or ::PBIO_ERROR_INVALID_OP if there is not an
+ *                          active Bluetooth connection.
+ */
+pbio_error_t pbsys_bluetooth_app_data_tx(const uint8_t *data, uint32_t size) {
+
+    if (!pbdrv_bluetooth_is_connected(PBDRV_BLUETOOTH_CONNECTION_PYBRICKS)) {
+        return PBIO_ERROR_INVALID_OP;
+    }
+
+    if (size > pbsys_bluetooth_app_data_tx_get_max_size()) {
+        return PBIO_ERROR_INVALID_ARG;
+    }
+
+    if (lwrb_get_free(&app_data_tx_ring_buf) < size + 1) {
+        return PBIO_ERROR_AGAIN;
+    }
+
+    uint8_t frame_size = size;
+    lwrb_write(&app_data_tx_ring_buf, &frame_size, 1);
+    lwrb_write(&app_data_tx_ring_buf, data, size);
+
+    if (!app_data_msg.is_queued) {
+        app_data_msg.context.connection = PBDRV_BLUETOOTH_CONNECTION_PYBRICKS;
+        list_add(send_queue, &app_data_msg);
+        app_data_msg.is_queued = true;
+    }
+
+    pbsys_bluetooth_process_poll();
+
+    return PBIO_SUCCESS;
+}
+
 /**
  * Tests if the Tx queue is empty and all data has been sent over the air.
  *
@@ -225,7 +421,8 @@ static pbio_pybricks_error_t handle_receive(pbdrv_bluetooth_connection_t connect
 static void send_done(void) {
     send_msg_t *msg = list_pop(send_queue);
 
-    if (msg == &stdout_msg && lwrb_get_full(&stdout_ring_buf)) {
+    if ((msg == &stdout_msg && lwrb_get_full(&stdout_ring_buf)) ||
+        (msg == &app_data_msg && (lwrb_get_full(&app_data_tx_ring_buf) || app_data_rx_update_pending))) {
         // If there is more buffered data to send, put the message back in the queue
         list_add(send_queue, msg);
     } else {
@@ -248,6 +445,10 @@ static void reset_all(void) {
 
     lwrb_reset(&stdin_ring_buf);
     lwrb_reset(&stdout_ring_buf);
+    lwrb_reset(&app_data_rx_ring_buf);
+    lwrb_reset(&app_data_tx_ring_buf);
+    app_data_rx_sequence_valid = false;
+    app_data_rx_update_pending = false;
 }
 
 static PT_THREAD(pbsys_bluetooth_monitor_status(struct pt *pt)) {
@@ -369,11 +570,31 @@ PROCESS_THREAD(pbsys_bluetooth_process, ev, data) {
 
                     if (msg == &stdout_msg) {
                         msg->payload[0] = PBIO_PYBRICKS_EVENT_WRITE_STDOUT;
-                        // REVISIT: use negotiated MTU instead of minimum safe size
-                        msg->context.size = lwrb_read(&stdout_ring_buf, &msg->payload[1], PBIO_ARRAY_SIZE(msg->payload) - 1) + 1;
+                        // Pack as much as fits in one notification at the
+                        // negotiated MTU to reduce the number of packets.
+                        size_t max_size = MIN(pbdrv_bluetooth_get_mtu() - 3u, PBIO_ARRAY_SIZE(msg->payload));
+                        msg->context.size = lwrb_read(&stdout_ring_buf, &msg->payload[1], max_size - 1) + 1;
                         assert(msg->context.size > 1);
                     }
 
+                    if (msg == &app_data_msg) {
+                        // Combine as many whole frames as fit. This may be
+                        // no frames at all if only the credits changed.
+                        app_data_rx_update_pending = false;
+                        size_t max_size = MIN(pbdrv_bluetooth_get_mtu() - 3u, PBIO_ARRAY_SIZE(msg->payload));
+                        msg->payload[0] = PBIO_PYBRICKS_EVENT_WRITE_APP_DATA_FRAMES;
+                        msg->payload[1] = app_data_tx_sequence;
+                        msg->payload[2] = app_data_rx_sequence;
+                        msg->payload[3] = MIN(lwrb_get_free(&app_data_rx_ring_buf), UINT8_MAX);
+                        msg->context.size = APP_DATA_EVENT_HEADER_SIZE;
+                        uint8_t frame_size;
+                        while (lwrb_peek(&app_data_tx_ring_buf, 0, &frame_size, 1)
+                               && msg->context.size + 1 + frame_size <= max_size) {
+                            msg->context.size += lwrb_read(&app_data_tx_ring_buf, &msg->payload[msg->context.size], 1 + frame_size);
+                            app_data_tx_sequence++;
+                        }
+                    }
+
                     msg->context.data = &msg->payload[0];
                     send_busy = true;
                     pbdrv_bluetooth_send(&msg->context);
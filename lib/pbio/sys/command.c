@@ -98,6 +98,17 @@ pbio_pybricks_error_t pbsys_command(const uint8_t *data, uint32_t size) {
             const uint8_t *data_to_write = &data[3];
             return pbio_pybricks_error_from_pbio_error(write_app_data_callback(offset, data_size, data_to_write));
         }
+
+        case PBIO_PYBRICKS_COMMAND_WRITE_APP_DATA_FRAME:
+            // Requires at least the message type and sequence number.
+            if (size < 2) {
+                return PBIO_PYBRICKS_ERROR_VALUE_NOT_ALLOWED;
+            }
+            #if PBSYS_CONFIG_HOST
+            return pbio_pybricks_error_from_pbio_error(pbsys_host_app_data_rx_write(data[1], &data[2], size - 2));
+            #else
+            return PBIO_PYBRICKS_ERROR_OK;
+            #endif
         default:
             return PBIO_PYBRICKS_ERROR_INVALID_COMMAND;
     }
@@ -93,4 +93,26 @@ bool pbsys_host_tx_is_idle(void) {
     return pbsys_bluetooth_tx_is_idle();
 }
 
+// App data frames are currently only supported over Bluetooth.
+
+void pbsys_host_app_data_set_enabled(bool enable) {
+    pbsys_bluetooth_app_data_set_enabled(enable);
+}
+
+pbio_error_t pbsys_host_app_data_rx_write(uint8_t sequence, const uint8_t *data, uint32_t size) {
+    return pbsys_bluetooth_app_data_rx_write(sequence, data, size);
+}
+
+pbio_error_t pbsys_host_app_data_rx(uint8_t *data, uint32_t *size) {
+    return pbsys_bluetooth_app_data_rx(data, size);
+}
+
+uint32_t pbsys_host_app_data_tx_get_max_size(void) {
+    return pbsys_bluetooth_app_data_tx_get_max_size();
+}
+
+pbio_error_t pbsys_host_app_data_tx(const uint8_t *data, uint32_t size) {
+    return pbsys_bluetooth_app_data_tx(data, size);
+}
+
 #endif // PBSYS_CONFIG_HOST
@@ -129,6 +129,46 @@ static pbsys_storage_data_map_t *map = &pbsys_user_ram_data_map.data_map;
 static bool data_map_is_loaded = false;
 static bool data_map_write_on_shutdown = false;
 
+/**
+ * Program data on memory mapped storage, or NULL if program data is in RAM.
+ *
+ * If storage is memory mapped, the program data is not loaded into RAM on
+ * boot. Programs are executed in place instead, which leaves all of the RAM
+ * for the application heap. Program data is only copied into RAM when a new
+ * program is received, or just before saving data on shutdown.
+ */
+static const uint8_t *mapped_program_data;
+
+/**
+ * Range of the data map that changed since it was loaded, in bytes from the
+ * start of the map. Only the storage blocks that overlap with this range are
+ * erased and written on shutdown, so unchanged blocks don't wear out.
+ */
+static uint32_t dirty_start = UINT32_MAX;
+static uint32_t dirty_end = 0;
+
+/**
+ * Size of the data on storage as found on boot. If less data is saved on
+ * shutdown, the remainder is erased too.
+ */
+static uint32_t stored_data_size;
+
+/**
+ * Marks part of the data map as changed so it is saved on shutdown.
+ *
+ * @param [in]  start   Offset of the first changed byte in the data map.
+ * @param [in]  end     Offset just past the last changed byte.
+ */
+static void pbsys_storage_mark_dirty(uint32_t start, uint32_t end) {
+    if (start < dirty_start) {
+        dirty_start = start;
+    }
+    if (end > dirty_end) {
+        dirty_end = end;
+    }
+    data_map_write_on_shutdown = true;
+}
+
 /**
  * Gets program size or the total size of the sequentially stored slots.
  *
@@ -167,11 +207,11 @@ pbsys_storage_settings_t *pbsys_storage_settings_get_settings(void) {
 }
 
 /**
- * Requests that storage (program, user data, settings) will be saved some
- * time before shutdown. Should be called by functions that change data.
+ * Requests that the settings will be saved some time before shutdown. Should
+ * be called by functions that change the settings.
  */
 void pbsys_storage_request_write(void) {
-    data_map_write_on_shutdown = true;
+    pbsys_storage_mark_dirty(0, sizeof(pbsys_storage_data_map_t));
 }
 
 /**
@@ -192,6 +232,7 @@ void pbsys_storage_reset_storage(void) {
     // The program data itself is not overwritten with zeros because the user
     // may be calling this while a program using this data is running.
     memset(map, 0, sizeof(pbsys_storage_data_map_t));
+    mapped_program_data = NULL;
 
     // Apply default settings.
     pbsys_storage_settings_set_defaults(&map->settings);
@@ -216,27 +257,44 @@ pbio_error_t pbsys_storage_set_user_data(uint32_t offset, const uint8_t *data, u
     if (offset + size > sizeof(map->user_data)) {
         return PBIO_ERROR_INVALID_ARG;
     }
-    // Update data and write size to request write on poweroff.
+    // Update data and request write of the changed part on poweroff.
     memcpy(map->user_data + offset, data, size);
-    pbsys_storage_request_write();
+    offset += offsetof(pbsys_storage_data_map_t, user_data);
+    pbsys_storage_mark_dirty(offset, offset + size);
     return PBIO_SUCCESS;
 }
 
 /**
  * Gets pointer to user data, settings, or program.
  *
+ * If programs are executed in place, program data is read from storage.
+ * Settings are in RAM in that case, so a range that includes both can't
+ * be read at once.
+ *
  * @param [in]  offset  Offset from the base address.
  * @param [in]  data    The data reference.
  * @param [in]  size    Data size.
  * @returns             ::PBIO_ERROR_INVALID_ARG if reading out of range.
+ *                      ::PBIO_ERROR_NOT_SUPPORTED if reading both settings
+ *                      and program data while programs are executed in place.
  *                      Otherwise, ::PBIO_SUCCESS.
  */
 pbio_error_t pbsys_storage_get_user_data(uint32_t offset, uint8_t **data, uint32_t size) {
     // User is allowed to read beyond user storage to include settings and
     // program data of all slots.
-    if (offset + size > (map->program_data - map->user_data) + pbsys_storage_get_used_program_data_size()) {
+    uint32_t program_offset = map->program_data - map->user_data;
+    if (offset + size > program_offset + pbsys_storage_get_used_program_data_size()) {
         return PBIO_ERROR_INVALID_ARG;
     }
+
+    if (mapped_program_data && offset + size > program_offset) {
+        if (offset < program_offset) {
+            return PBIO_ERROR_NOT_SUPPORTED;
+        }
+        *data = (uint8_t *)mapped_program_data + offset - program_offset;
+        return PBIO_SUCCESS;
+    }
+
     *data = map->user_data + offset;
     return PBIO_SUCCESS;
 }
@@ -275,8 +333,30 @@ static void pbsys_storage_update_checksum(void) {
 }
 #endif // PBSYS_CONFIG_STORAGE_OVERLAPS_BOOTLOADER_CHECKSUM
 
+/**
+ * Tries to access the loaded program data in place on the storage device.
+ *
+ * This is only done for hubs with one slot, since receiving a program
+ * overwrites all program data in that case.
+ *
+ * @returns             True if program data is memory mapped, false if it
+ *                      must be read into RAM.
+ */
+static bool pbsys_storage_map_program_data(void) {
+    #if PBSYS_CONFIG_STORAGE_NUM_SLOTS == 1
+    uint32_t size = pbsys_storage_get_used_program_data_size();
+    return size > 0 && pbdrv_block_device_get_mapped_data(
+        offsetof(pbsys_storage_data_map_t, program_data), size, &mapped_program_data) == PBIO_SUCCESS;
+    #else
+    return false;
+    #endif
+}
+
 static pbio_error_t pbsys_storage_prepare_receive(void) {
 
+    // New program data is always received in RAM.
+    mapped_program_data = NULL;
+
     #if PBSYS_CONFIG_STORAGE_NUM_SLOTS == 1
     map->slot_info[incoming_slot].size = 0;
     map->slot_info[incoming_slot].offset = 0;
@@ -326,6 +406,8 @@ static pbio_error_t pbsys_storage_prepare_receive(void) {
 
     // Now move those remaining programs backwards into the "freed" space.
     memmove(map->program_data + destination, map->program_data + source, remaining_programs_size);
+    pbsys_storage_mark_dirty(offsetof(pbsys_storage_data_map_t, program_data) + destination,
+        offsetof(pbsys_storage_data_map_t, program_data) + destination + remaining_programs_size);
 
     // The active slot is now at the end, and ready to receive programs.
     map->slot_info[incoming_slot].size = 0;
@@ -371,8 +453,11 @@ pbio_error_t pbsys_storage_set_program_size(uint32_t new_size) {
     // Set information for the incoming slot.
     map->slot_info[incoming_slot].size = new_size;
 
-    // Program download complete, so request saving on poweroff.
+    // Program download complete, so request saving it and the updated slot
+    // information on poweroff.
     pbsys_storage_request_write();
+    pbsys_storage_mark_dirty(offsetof(pbsys_storage_data_map_t, program_data) + map->slot_info[incoming_slot].offset,
+        offsetof(pbsys_storage_data_map_t, program_data) + map->slot_info[incoming_slot].offset + new_size);
 
     return PBIO_SUCCESS;
 }
@@ -423,12 +508,16 @@ void pbsys_storage_get_program_data(pbsys_main_program_t *program) {
     //
     uint8_t slot = program->id < PBSYS_CONFIG_STORAGE_NUM_SLOTS ? program->id : pbsys_hmi_get_selected_program_slot();
 
+    // Program data is executed in place if possible.
+    const uint8_t *program_data = mapped_program_data ? mapped_program_data : map->program_data;
+
     // Only requested slot is available to user.
-    program->code_start = map->program_data + map->slot_info[slot].offset;
-    program->code_end = map->program_data + map->slot_info[slot].offset + map->slot_info[slot].size;
+    program->code_start = (uint8_t *)program_data + map->slot_info[slot].offset;
+    program->code_end = (uint8_t *)program_data + map->slot_info[slot].offset + map->slot_info[slot].size;
 
-    // User ram starts after the last slot.
-    program->user_ram_start = map->program_data + pbsys_storage_get_used_program_data_size();
+    // User ram starts after the last slot, or right away if programs are
+    // executed in place.
+    program->user_ram_start = map->program_data + (mapped_program_data ? 0 : pbsys_storage_get_used_program_data_size());
     program->user_ram_end = ((void *)&pbsys_user_ram_data_map) + sizeof(pbsys_user_ram_data_map);
 }
 
@@ -460,11 +549,26 @@ PROCESS_THREAD(pbsys_storage_process, ev, data) {
 
     PROCESS_BEGIN();
 
+    // Nothing changed since loading.
+    dirty_start = UINT32_MAX;
+    dirty_end = 0;
+    data_map_write_on_shutdown = false;
+
     // Read size of stored data.
     PROCESS_PT_SPAWN(&pt, pbdrv_block_device_read(&pt, 0, (uint8_t *)map, sizeof(map->saved_data_size), &err));
 
-    // Read the available data into RAM.
-    PROCESS_PT_SPAWN(&pt, pbdrv_block_device_read(&pt, 0, (uint8_t *)map, map->saved_data_size, &err));
+    // Read the settings and program metadata into RAM.
+    if (map->saved_data_size >= sizeof(pbsys_storage_data_map_t)) {
+        PROCESS_PT_SPAWN(&pt, pbdrv_block_device_read(&pt, 0, (uint8_t *)map, sizeof(pbsys_storage_data_map_t), &err));
+    } else {
+        err = PBIO_ERROR_FAILED;
+    }
+
+    // Read the program data into RAM, unless it can be executed in place.
+    if (err == PBIO_SUCCESS && map->saved_data_size > sizeof(pbsys_storage_data_map_t) && !pbsys_storage_map_program_data()) {
+        PROCESS_PT_SPAWN(&pt, pbdrv_block_device_read(&pt, sizeof(pbsys_storage_data_map_t),
+            map->program_data, map->saved_data_size - sizeof(pbsys_storage_data_map_t), &err));
+    }
 
     bool is_bad_version = strncmp(map->stored_firmware_hash, pbsys_main_get_application_version_hash(), sizeof(map->stored_firmware_hash));
 
@@ -472,6 +576,13 @@ PROCESS_THREAD(pbsys_storage_process, ev, data) {
     // otherwise reset storage.
     if (err != PBIO_SUCCESS || is_bad_version) {
         pbsys_storage_reset_storage();
+        #if PBSYS_CONFIG_STORAGE_OVERLAPS_BOOTLOADER_CHECKSUM
+        // The bootloader checksum expects everything after the saved data
+        // to be erased, so erase everything that may have been stored.
+        stored_data_size = PBSYS_CONFIG_STORAGE_ROM_SIZE;
+        #endif
+    } else {
+        stored_data_size = map->saved_data_size;
     }
 
     // Apply loaded settings as necesary.
@@ -490,14 +601,38 @@ PROCESS_THREAD(pbsys_storage_process, ev, data) {
     // Write data to storage if it was updated.
     if (data_map_write_on_shutdown) {
 
+        // Changed blocks are erased before writing, so program data that was
+        // executed in place has to be copied into RAM first. No program is running now,
+        // so this RAM is free.
+        if (mapped_program_data) {
+            PROCESS_PT_SPAWN(&pt, pbdrv_block_device_read(&pt, sizeof(pbsys_storage_data_map_t),
+                map->program_data, pbsys_storage_get_used_program_data_size(), &err));
+            mapped_program_data = NULL;
+            if (err != PBIO_SUCCESS) {
+                // Don't erase the stored programs if they can't be saved again.
+                pbsys_init_busy_down();
+                PROCESS_EXIT();
+            }
+        }
+
         map->saved_data_size = sizeof(pbsys_storage_data_map_t) + pbsys_storage_get_used_program_data_size();
 
         #if PBSYS_CONFIG_STORAGE_OVERLAPS_BOOTLOADER_CHECKSUM
+        // Checksum complement is in the header, so it is always written.
         pbsys_storage_update_checksum();
+        pbsys_storage_mark_dirty(0, sizeof(pbsys_storage_data_map_t));
         #endif
 
-        // Write the data.
-        PROCESS_PT_SPAWN(&pt, pbdrv_block_device_store(&pt, (uint8_t *)map, map->saved_data_size, &err));
+        // Size is in the header, and data beyond the new size gets erased.
+        if (map->saved_data_size != stored_data_size) {
+            pbsys_storage_mark_dirty(0, sizeof(map->saved_data_size));
+        }
+        if (stored_data_size > map->saved_data_size) {
+            pbsys_storage_mark_dirty(map->saved_data_size, stored_data_size);
+        }
+
+        // Write only the data that changed.
+        PROCESS_PT_SPAWN(&pt, pbdrv_block_device_store(&pt, (uint8_t *)map, map->saved_data_size, dirty_start, dirty_end, &err));
     }
 
     // Deinitialization done.
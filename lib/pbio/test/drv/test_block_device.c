@@ -0,0 +1,84 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2024 The Pybricks Authors
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <contiki.h>
+#include <tinytest.h>
+#include <tinytest_macros.h>
+
+#include <pbdrv/block_device.h>
+#include <pbio/error.h>
+#include <test-pbio.h>
+
+#include "../drv/block_device/block_device_test.h"
+
+#define BLOCK_SIZE (1024)
+
+static uint8_t data[PBDRV_CONFIG_BLOCK_DEVICE_TEST_SIZE];
+static uint8_t read_back[PBDRV_CONFIG_BLOCK_DEVICE_TEST_SIZE];
+
+static PT_THREAD(test_block_device_store_changed_blocks(struct pt *pt)) {
+    static struct pt child;
+    static pbio_error_t err;
+
+    PT_BEGIN(pt);
+
+    // Load what is stored and nothing was erased yet.
+    PT_SPAWN(pt, &child, pbdrv_block_device_read(&child, 0, data, sizeof(data), &err));
+    tt_want_uint_op(err, ==, PBIO_SUCCESS);
+    for (uint32_t offset = 0; offset < sizeof(data); offset += BLOCK_SIZE) {
+        tt_want_uint_op(pbdrv_block_device_test_get_erase_count(offset), ==, 0);
+    }
+
+    // Nothing is written if nothing changed.
+    PT_SPAWN(pt, &child, pbdrv_block_device_store(&child, data, 4 * BLOCK_SIZE, 0, 0, &err));
+    tt_want_uint_op(err, ==, PBIO_SUCCESS);
+    tt_want_uint_op(pbdrv_block_device_test_get_erase_count(0), ==, 0);
+
+    // Change data in the second block, so only that block is rewritten.
+    memset(data + BLOCK_SIZE + 100, 0x12, 8);
+    PT_SPAWN(pt, &child, pbdrv_block_device_store(&child, data, 4 * BLOCK_SIZE, BLOCK_SIZE + 100, BLOCK_SIZE + 108, &err));
+    tt_want_uint_op(err, ==, PBIO_SUCCESS);
+    tt_want_uint_op(pbdrv_block_device_test_get_erase_count(0), ==, 0);
+    tt_want_uint_op(pbdrv_block_device_test_get_erase_count(BLOCK_SIZE), ==, 1);
+    tt_want_uint_op(pbdrv_block_device_test_get_erase_count(2 * BLOCK_SIZE), ==, 0);
+
+    PT_SPAWN(pt, &child, pbdrv_block_device_read(&child, 0, read_back, 4 * BLOCK_SIZE, &err));
+    tt_want_uint_op(err, ==, PBIO_SUCCESS);
+    tt_want(memcmp(data, read_back, 4 * BLOCK_SIZE) == 0);
+
+    // A range across a block boundary rewrites both blocks.
+    PT_SPAWN(pt, &child, pbdrv_block_device_store(&child, data, 4 * BLOCK_SIZE, 2 * BLOCK_SIZE - 4, 2 * BLOCK_SIZE + 4, &err));
+    tt_want_uint_op(err, ==, PBIO_SUCCESS);
+    tt_want_uint_op(pbdrv_block_device_test_get_erase_count(BLOCK_SIZE), ==, 2);
+    tt_want_uint_op(pbdrv_block_device_test_get_erase_count(2 * BLOCK_SIZE), ==, 1);
+
+    // Shrinking the data erases what is beyond the new size.
+    memset(data + 2 * BLOCK_SIZE + 100, 0x34, 8);
+    PT_SPAWN(pt, &child, pbdrv_block_device_store(&child, data, 2 * BLOCK_SIZE + 108, 2 * BLOCK_SIZE + 100, 4 * BLOCK_SIZE, &err));
+    tt_want_uint_op(err, ==, PBIO_SUCCESS);
+    tt_want_uint_op(pbdrv_block_device_test_get_erase_count(2 * BLOCK_SIZE), ==, 2);
+    tt_want_uint_op(pbdrv_block_device_test_get_erase_count(3 * BLOCK_SIZE), ==, 1);
+    tt_want_uint_op(pbdrv_block_device_test_get_erase_count(4 * BLOCK_SIZE), ==, 0);
+
+    PT_SPAWN(pt, &child, pbdrv_block_device_read(&child, 0, read_back, 4 * BLOCK_SIZE, &err));
+    tt_want_uint_op(err, ==, PBIO_SUCCESS);
+    tt_want(memcmp(data, read_back, 2 * BLOCK_SIZE + 108) == 0);
+    for (uint32_t offset = 2 * BLOCK_SIZE + 108; offset < 4 * BLOCK_SIZE; offset++) {
+        tt_want_uint_op(read_back[offset], ==, 0xFF);
+    }
+
+    // Writing beyond the end of storage is not allowed.
+    PT_SPAWN(pt, &child, pbdrv_block_device_store(&child, data, sizeof(data), 0, sizeof(data) + 1, &err));
+    tt_want_uint_op(err, ==, PBIO_ERROR_INVALID_ARG);
+
+    PT_END(pt);
+}
+
+struct testcase_t pbdrv_block_device_tests[] = {
+    PBIO_PT_THREAD_TEST(test_block_device_store_changed_blocks),
+    END_OF_TESTCASES
+};
@@ -196,6 +196,30 @@ uint32_t pbio_test_bluetooth_get_pybricks_service_notification_count(void) {
     return pybricks_service_notification_count;
 }
 
+// Last notification of each Pybricks service event type.
+#define PYBRICKS_SERVICE_NUM_EVENTS 4
+static uint8_t pybricks_service_event[PYBRICKS_SERVICE_NUM_EVENTS][HCI_ACL_PAYLOAD_SIZE];
+static uint16_t pybricks_service_event_size[PYBRICKS_SERVICE_NUM_EVENTS];
+
+/**
+ * Takes the last notification of the given event type that the hub sent on
+ * the Pybricks service command characteristic.
+ *
+ * @param [in]  event   The event type, which is the first byte of the value.
+ * @param [out] data    Buffer of at least HCI_ACL_PAYLOAD_SIZE bytes for the
+ *                      value, including the event type.
+ * @return              The size of the value or 0 if no new notification of
+ *                      this type was sent since the last call.
+ */
+uint32_t pbio_test_bluetooth_take_pybricks_service_event(uint8_t event, uint8_t *data) {
+    assert(event < PYBRICKS_SERVICE_NUM_EVENTS);
+
+    uint32_t size = pybricks_service_event_size[event];
+    memcpy(data, pybricks_service_event[event], size);
+    pybricks_service_event_size[event] = 0;
+    return size;
+}
+
 void pbio_test_bluetooth_send_pybricks_command(const uint8_t *data, uint32_t size) {
     // Pybricks command/event characteristic value (comes from header file generated by .gatt)
     const uint16_t attribute_handle = 0x000d;
@@ -466,13 +490,16 @@ static void handle_send(const uint8_t *buffer, uint16_t length) {
                             switch (attr_handle) {
                                 case 0x000d:
                                     pybricks_service_notification_count++;
+                                    if (size && value[0] < PYBRICKS_SERVICE_NUM_EVENTS) {
+                                        memcpy(pybricks_service_event[value[0]], value, size);
+                                        pybricks_service_event_size[value[0]] = size;
+                                    }
                                     break;
                                 case 0x0013:
                                     uart_service_notification_count++;
                                     break;
                             }
 
-                            (void)value;
                             log_debug("ATT_HANDLE_VALUE_NOTIFICATION: attr_handle: %04x, size: %u", attr_handle, size);
                         }
                         break;
@@ -0,0 +1,140 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2025 The Pybricks Authors
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <contiki.h>
+#include <tinytest.h>
+#include <tinytest_macros.h>
+
+#include <pbdrv/battery.h>
+#include <pbdrv/button.h>
+#include <pbio/button.h>
+#include <pbio/control.h>
+#include <pbio/logger.h>
+#include <pbio/port_interface.h>
+#include <pbio/servo.h>
+#include <test-pbio.h>
+
+#include "../drv/clock/clock_test.h"
+#include "../drv/virtual_replay.h"
+
+#define LOG_NUM_COLS (PBIO_SERVO_LOGGER_NUM_COLS + PBIO_LOGGER_NUM_DEFAULT_COLS)
+#define LOG_NUM_ROWS (300)
+
+static void write_trace(const char *dir, const char *name, const int32_t *data, uint32_t num_rows, uint32_t num_cols) {
+    char path[256];
+    snprintf(path, sizeof(path), "%s/%s", dir, name);
+    FILE *file = fopen(path, "w");
+    for (uint32_t row = 0; row < num_rows; row++) {
+        for (uint32_t col = 0; col < num_cols; col++) {
+            fprintf(file, col + 1 < num_cols ? "%d, " : "%d\n", data[row * num_cols + col]);
+        }
+    }
+    fclose(file);
+}
+
+static void remove_trace(const char *dir, const char *name) {
+    char path[256];
+    snprintf(path, sizeof(path), "%s/%s", dir, name);
+    remove(path);
+}
+
+static PT_THREAD(test_virtual_replay_traces(struct pt *pt)) {
+
+    static struct timer timer;
+    static pbio_servo_t *srv;
+    static pbio_port_t *port;
+    static int32_t log_data[LOG_NUM_ROWS * LOG_NUM_COLS];
+    static uint32_t num_rows;
+    static char dir[] = "/tmp/pbio-replay-XXXXXX";
+
+    static int32_t angle;
+    static int32_t speed;
+    static uint16_t voltage;
+    static pbio_button_flags_t pressed;
+
+    PT_BEGIN(pt);
+
+    // Give simulator some time to start reporting data.
+    pbio_test_sleep_ms(&timer, 100);
+
+    // Motor with gears and reversed direction, so the logged angle is not the
+    // angle of the motor shaft.
+    lego_device_type_id_t id = LEGO_DEVICE_TYPE_ID_ANY_ENCODED_MOTOR;
+    tt_uint_op(pbio_port_get_port(PBIO_PORT_ID_A, &port), ==, PBIO_SUCCESS);
+    tt_uint_op(pbio_port_get_servo(port, &id, &srv), ==, PBIO_SUCCESS);
+    tt_uint_op(pbio_servo_setup(srv, LEGO_DEVICE_TYPE_ID_SPIKE_M_MOTOR, PBIO_DIRECTION_COUNTERCLOCKWISE, 3000, true, 0), ==, PBIO_SUCCESS);
+
+    // Record a move.
+    pbio_logger_start(&srv->log, log_data, LOG_NUM_ROWS, LOG_NUM_COLS, 1);
+    tt_uint_op(pbio_servo_run_angle(srv, 300, 90, PBIO_CONTROL_ON_COMPLETION_COAST), ==, PBIO_SUCCESS);
+    pbio_test_sleep_until(pbio_control_is_done(&srv->control));
+    pbio_logger_stop(&srv->log);
+    num_rows = pbio_logger_get_num_rows_used(&srv->log);
+    tt_want_uint_op(num_rows, >, 100);
+
+    // Move somewhere else, so the replay has to bring it back.
+    tt_uint_op(pbio_servo_run_target(srv, 300, -90, PBIO_CONTROL_ON_COMPLETION_COAST), ==, PBIO_SUCCESS);
+    pbio_test_sleep_until(pbio_control_is_done(&srv->control));
+
+    {
+        static const int32_t battery[] = {
+            0, 7000,
+            50, 6500,
+        };
+        static const int32_t button[] = {
+            0, 0,
+            50, PBIO_BUTTON_CENTER,
+        };
+        tt_assert(mkdtemp(dir));
+        write_trace(dir, "A.txt", log_data, num_rows, LOG_NUM_COLS);
+        write_trace(dir, "battery.txt", battery, 2, 2);
+        write_trace(dir, "button.txt", button, 2, 2);
+        setenv("PBIO_VIRTUAL_REPLAY", dir, 1);
+        pbdrv_virtual_replay_init();
+
+        // Traces are loaded on init, so the files are no longer needed.
+        remove_trace(dir, "A.txt");
+        remove_trace(dir, "battery.txt");
+        remove_trace(dir, "button.txt");
+        rmdir(dir);
+    }
+
+    tt_want_int_op(pbdrv_battery_get_voltage_now(&voltage), ==, PBIO_SUCCESS);
+    tt_want_uint_op(voltage, ==, 7000);
+    tt_want_int_op(pbdrv_button_is_pressed(&pressed), ==, PBIO_SUCCESS);
+    tt_want_uint_op(pressed, ==, 0);
+
+    // Halfway through the move, the motor is where it was when recorded.
+    pbio_test_sleep_ms(&timer, log_data[num_rows / 2 * LOG_NUM_COLS]);
+    tt_uint_op(pbio_servo_get_state_user(srv, &angle, &speed), ==, PBIO_SUCCESS);
+    tt_want(pbio_test_int_is_close(angle, log_data[num_rows / 2 * LOG_NUM_COLS + 2], 2));
+
+    tt_want_int_op(pbdrv_battery_get_voltage_now(&voltage), ==, PBIO_SUCCESS);
+    tt_want_uint_op(voltage, ==, 6500);
+    tt_want_int_op(pbdrv_button_is_pressed(&pressed), ==, PBIO_SUCCESS);
+    tt_want_uint_op(pressed, ==, PBIO_BUTTON_CENTER);
+
+    // After the end of the trace, the motor stays at the last recorded angle.
+    pbio_test_sleep_ms(&timer, log_data[(num_rows - 1) * LOG_NUM_COLS]);
+    tt_uint_op(pbio_servo_get_state_user(srv, &angle, &speed), ==, PBIO_SUCCESS);
+    tt_want(pbio_test_int_is_close(angle, log_data[(num_rows - 1) * LOG_NUM_COLS + 2], 2));
+
+    // Without traces, the simulation continues as usual.
+    unsetenv("PBIO_VIRTUAL_REPLAY");
+    pbdrv_virtual_replay_init();
+    tt_want_int_op(pbdrv_battery_get_voltage_now(&voltage), ==, PBIO_SUCCESS);
+    tt_want_uint_op(voltage, ==, 7200);
+
+end:
+    PT_END(pt);
+}
+
+struct testcase_t pbdrv_virtual_replay_tests[] = {
+    PBIO_PT_THREAD_TEST_WITH_PBIO(test_virtual_replay_traces),
+    END_OF_TESTCASES
+};
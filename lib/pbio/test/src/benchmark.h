@@ -0,0 +1,29 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2025 The Pybricks Authors
+
+// Helpers for benchmarks that live next to the tests of the code they
+// measure. See test_benchmark.c.
+
+#ifndef _PBIO_TEST_BENCHMARK_H_
+#define _PBIO_TEST_BENCHMARK_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+#include <pbio/error.h>
+#include <pbio/os.h>
+
+typedef struct {
+    const char *name;
+    uint32_t iterations;
+    struct timespec start;
+    int perf_fd;
+} benchmark_t;
+
+void benchmark_start(benchmark_t *bench, const char *name);
+bool benchmark_end(benchmark_t *bench);
+
+pbio_error_t bench_lump(pbio_os_state_t *state, void *context);
+
+#endif // _PBIO_TEST_BENCHMARK_H_
@@ -0,0 +1,285 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2025 The Pybricks Authors
+
+// Benchmarks of code that runs on every control loop or sensor sample.
+//
+// These are off by default. Run them with:
+//
+//     ./test-pbio.sh +src/benchmark/..
+//
+// or with `make -C lib/pbio/test benchmark`.
+//
+// Each benchmark appends a line with its name, the time per operation (ns)
+// and the number of instructions per operation to benchmark.txt in the
+// results directory. Instructions are counted with perf events where the
+// kernel allows it, otherwise the count is 0.
+//
+// Each benchmark is compared to its line in lib/pbio/test/benchmark_baseline.txt,
+// or in the file given by PBIO_TEST_BENCHMARK_BASELINE. It fails if it needs
+// more than 10% more instructions than its baseline, or more than 50% more
+// time if instructions are not counted. Times depend on the machine, so copy
+// a new benchmark.txt over the baseline when moving to another machine, when
+// a slowdown is expected, or when the benchmarks change.
+// PBIO_TEST_BENCHMARK_ITERATIONS sets the number of operations per benchmark.
+//
+// Benchmarks that need the test doubles of other tests live next to those
+// tests and are declared in benchmark.h, like those in test_lump.c.
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+
+#include <contiki.h>
+#include <tinytest.h>
+#include <tinytest_macros.h>
+
+#include <pbio/angle.h>
+#include <pbio/color.h>
+#include <pbio/config.h>
+#include <pbio/control.h>
+#include <pbio/imu.h>
+#include <pbio/observer.h>
+#include <pbio/port_interface.h>
+#include <pbio/servo.h>
+#include <pbio/trajectory.h>
+#include <test-pbio.h>
+
+#include "../drv/clock/clock_test.h"
+#include "../drv/imu/imu.h"
+#include "../drv/imu/imu_test.h"
+#include "benchmark.h"
+
+#define BENCHMARK_DEFAULT_ITERATIONS (1000000)
+
+// Keeps the compiler from optimizing away benchmarked results.
+static volatile int32_t benchmark_sink;
+
+static uint32_t benchmark_get_iterations(void) {
+    const char *iterations = getenv("PBIO_TEST_BENCHMARK_ITERATIONS");
+    return iterations ? strtoul(iterations, NULL, 0) : BENCHMARK_DEFAULT_ITERATIONS;
+}
+
+void benchmark_start(benchmark_t *bench, const char *name) {
+    bench->name = name;
+    bench->iterations = benchmark_get_iterations();
+
+    struct perf_event_attr attr = {
+        .type = PERF_TYPE_HARDWARE,
+        .size = sizeof(attr),
+        .config = PERF_COUNT_HW_INSTRUCTIONS,
+        .disabled = 1,
+        .exclude_kernel = 1,
+        .exclude_hv = 1,
+    };
+    bench->perf_fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    if (bench->perf_fd != -1) {
+        ioctl(bench->perf_fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(bench->perf_fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &bench->start);
+}
+
+// Finds the baseline of the given benchmark, if any.
+static bool benchmark_get_baseline(const char *name, double *ns, double *instructions) {
+    const char *path = getenv("PBIO_TEST_BENCHMARK_BASELINE");
+    if (!path) {
+        path = PBIO_TEST_BENCHMARK_BASELINE_FILE;
+    }
+
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        return false;
+    }
+
+    char line_name[64];
+    bool found = false;
+    while (fscanf(f, "%63s %lf %lf", line_name, ns, instructions) == 3) {
+        if (!strcmp(line_name, name)) {
+            found = true;
+            break;
+        }
+    }
+    fclose(f);
+    return found;
+}
+
+bool benchmark_end(benchmark_t *bench) {
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    uint64_t instructions = 0;
+    if (bench->perf_fd != -1) {
+        ioctl(bench->perf_fd, PERF_EVENT_IOC_DISABLE, 0);
+        if (read(bench->perf_fd, &instructions, sizeof(instructions)) != sizeof(instructions)) {
+            instructions = 0;
+        }
+        close(bench->perf_fd);
+    }
+
+    double elapsed = (end.tv_sec - bench->start.tv_sec) * 1e9 + (end.tv_nsec - bench->start.tv_nsec);
+    double ns = elapsed / bench->iterations;
+    double instructions_per_op = (double)instructions / bench->iterations;
+
+    printf("\n    %s: %.1f ns/op, %.0f instructions/op ", bench->name, ns, instructions_per_op);
+
+    FILE *f = fopen("benchmark.txt", "a");
+    if (f) {
+        fprintf(f, "%s %.1f %.0f\n", bench->name, ns, instructions_per_op);
+        fclose(f);
+    }
+
+    double baseline_ns;
+    double baseline_instructions;
+    if (!benchmark_get_baseline(bench->name, &baseline_ns, &baseline_instructions)) {
+        return true;
+    }
+
+    // Instruction counts are reproducible, so prefer those.
+    if (instructions_per_op > 0 && baseline_instructions > 0) {
+        return instructions_per_op <= baseline_instructions * 1.1;
+    }
+    return ns <= baseline_ns * 1.5;
+}
+
+static void bench_trajectory_get_reference(void *env) {
+    pbio_trajectory_command_t command = {
+        .time_start = 0,
+        .position_start = { .rotations = 0, .millidegrees = 0 },
+        .position_end = { .rotations = 27, .millidegrees = 280000 },
+        .speed_start = 0,
+        .speed_target = 1000000,
+        .speed_max = 1000000,
+        .acceleration = 2000000,
+        .deceleration = 2000000,
+        .continue_running = false,
+    };
+
+    pbio_trajectory_t trj;
+    tt_int_op(pbio_trajectory_new_angle_command(&trj, &command), ==, PBIO_SUCCESS);
+
+    // Sweep over the whole trajectory, including all phases.
+    uint32_t duration = trj.t3 + 1000 * PBIO_TRAJECTORY_TICKS_PER_MS;
+
+    benchmark_t bench;
+    benchmark_start(&bench, "trajectory_get_reference");
+    for (uint32_t i = 0; i < bench.iterations; i++) {
+        pbio_trajectory_reference_t ref;
+        pbio_trajectory_get_reference(&trj, i % duration, &ref);
+        benchmark_sink = ref.speed;
+    }
+    tt_want(benchmark_end(&bench));
+end:;
+}
+
+static void bench_color_rgb_to_hsv(void *env) {
+    benchmark_t bench;
+    benchmark_start(&bench, "color_rgb_to_hsv");
+    for (uint32_t i = 0; i < bench.iterations; i++) {
+        pbio_color_rgb_t rgb = { .r = i, .g = i >> 8, .b = i >> 16 };
+        pbio_color_hsv_t hsv;
+        pbio_color_rgb_to_hsv(&rgb, &hsv);
+        benchmark_sink = hsv.h;
+    }
+    tt_want(benchmark_end(&bench));
+}
+
+static void bench_color_hsv_to_rgb(void *env) {
+    benchmark_t bench;
+    benchmark_start(&bench, "color_hsv_to_rgb");
+    for (uint32_t i = 0; i < bench.iterations; i++) {
+        pbio_color_hsv_t hsv = { .h = i % 360, .s = i % 101, .v = (i >> 8) % 101 };
+        pbio_color_rgb_t rgb;
+        pbio_color_hsv_to_rgb(&hsv, &rgb);
+        benchmark_sink = rgb.r;
+    }
+    tt_want(benchmark_end(&bench));
+}
+
+// Calibration and attitude fusion in pbio/imu, as done for every IMU sample.
+static void bench_imu_fusion(void *env) {
+    pbdrv_imu_init();
+    pbio_imu_init();
+
+    benchmark_t bench;
+    benchmark_start(&bench, "imu_fusion");
+    for (uint32_t i = 0; i < bench.iterations; i++) {
+        // Raw samples of a hub that is flat and slowly turning about z.
+        int16_t data[] = { 14, -28, (int16_t)(i % 2000) - 1000, 4 + i % 3, -8, 4097 };
+        pbio_test_imu_handle_frame_data(data);
+    }
+    benchmark_sink = pbio_imu_get_heading(PBIO_IMU_HEADING_TYPE_3D);
+    tt_want(benchmark_end(&bench));
+}
+
+static PT_THREAD(bench_servo(struct pt *pt)) {
+
+    static pbio_servo_t *srv;
+    static pbio_port_t *port;
+    static uint32_t delay;
+
+    PT_BEGIN(pt);
+
+    // Give simulator some time to start reporting data.
+    for (delay = 0; delay < 100; delay++) {
+        pbio_test_clock_tick(1);
+        PT_YIELD(pt);
+    }
+
+    lego_device_type_id_t id = LEGO_DEVICE_TYPE_ID_ANY_ENCODED_MOTOR;
+    tt_uint_op(pbio_port_get_port(PBIO_PORT_ID_A, &port), ==, PBIO_SUCCESS);
+    tt_uint_op(pbio_port_get_servo(port, &id, &srv), ==, PBIO_SUCCESS);
+    tt_uint_op(pbio_servo_setup(srv, LEGO_DEVICE_TYPE_ID_SPIKE_M_MOTOR, PBIO_DIRECTION_CLOCKWISE, 1000, true, 0), ==, PBIO_SUCCESS);
+    tt_uint_op(pbio_servo_run_forever(srv, 500), ==, PBIO_SUCCESS);
+
+    // The servo update as done by the motor process on every control loop.
+    // The simulated motor does not move during the benchmark, so this also
+    // covers stall detection.
+    {
+        benchmark_t bench;
+        benchmark_start(&bench, "servo_update_all");
+        for (uint32_t i = 0; i < bench.iterations; i++) {
+            pbio_test_clock_tick(PBIO_CONFIG_CONTROL_LOOP_TIME_MS);
+            pbio_servo_update_all();
+        }
+        tt_want(benchmark_end(&bench));
+    }
+
+    // Just the observer, with a measured angle that moves at constant speed.
+    {
+        pbio_angle_t angle = { .rotations = 0, .millidegrees = 0 };
+        uint32_t time = pbio_control_get_time_ticks();
+
+        benchmark_t bench;
+        benchmark_start(&bench, "observer_update");
+        for (uint32_t i = 0; i < bench.iterations; i++) {
+            time += PBIO_CONFIG_CONTROL_LOOP_TIME_MS * PBIO_TRAJECTORY_TICKS_PER_MS;
+            pbio_angle_add_mdeg(&angle, 2500);
+            pbio_observer_update(&srv->observer, time, &angle, PBIO_DCMOTOR_ACTUATION_VOLTAGE, 4000);
+        }
+        benchmark_sink = srv->observer.speed;
+        tt_want(benchmark_end(&bench));
+    }
+
+end:
+
+    PT_END(pt);
+}
+
+struct testcase_t pbio_benchmark_tests[] = {
+    { "trajectory_get_reference", bench_trajectory_get_reference, TT_FORK | TT_OFF_BY_DEFAULT, NULL, NULL },
+    { "color_rgb_to_hsv", bench_color_rgb_to_hsv, TT_FORK | TT_OFF_BY_DEFAULT, NULL, NULL },
+    { "color_hsv_to_rgb", bench_color_hsv_to_rgb, TT_FORK | TT_OFF_BY_DEFAULT, NULL, NULL },
+    { "imu_fusion", bench_imu_fusion, TT_FORK | TT_OFF_BY_DEFAULT, NULL, NULL },
+    { "servo", pbio_test_run_thread_with_pbio_processes, TT_FORK | TT_OFF_BY_DEFAULT, &pbio_test_setup, bench_servo },
+    { "lump", pbio_test_run_thread_with_pbio_os_processes, TT_FORK | TT_OFF_BY_DEFAULT, &pbio_test_setup, bench_lump },
+    END_OF_TESTCASES
+};
@@ -0,0 +1,223 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2025 The Pybricks Authors
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <pbio/broadcast.h>
+#include <test-pbio.h>
+
+#include <tinytest.h>
+#include <tinytest_macros.h>
+
+#define FRAGMENT_MAX_SIZE (PBIO_BROADCAST_ADV_DATA_MAX_SIZE)
+
+static uint8_t payload[PBIO_BROADCAST_DATA_MAX_SIZE];
+static uint8_t fragments[PBIO_BROADCAST_FRAGMENTS_MAX][FRAGMENT_MAX_SIZE];
+static size_t fragment_sizes[PBIO_BROADCAST_FRAGMENTS_MAX];
+
+static uint8_t make_fragments(size_t size, uint8_t sequence) {
+    for (size_t i = 0; i < size; i++) {
+        payload[i] = sequence + i;
+    }
+    uint8_t count = pbio_broadcast_get_num_fragments(size);
+    for (uint8_t i = 0; i < count; i++) {
+        fragment_sizes[i] = pbio_broadcast_get_fragment(payload, size, sequence, i, fragments[i]);
+    }
+    return count;
+}
+
+static bool add(pbio_broadcast_reassembly_t *reassembly, uint8_t index, uint8_t *received, size_t *received_size) {
+    return pbio_broadcast_add_fragment(reassembly, fragments[index], fragment_sizes[index], received, received_size);
+}
+
+static void test_encode(void *env) {
+
+    tt_want_uint_op(pbio_broadcast_get_num_fragments(1), ==, 1);
+    tt_want_uint_op(pbio_broadcast_get_num_fragments(PBIO_BROADCAST_FRAGMENT_DATA_SIZE), ==, 1);
+    tt_want_uint_op(pbio_broadcast_get_num_fragments(PBIO_BROADCAST_FRAGMENT_DATA_SIZE + 1), ==, 2);
+    tt_want_uint_op(pbio_broadcast_get_num_fragments(PBIO_BROADCAST_DATA_MAX_SIZE), ==, PBIO_BROADCAST_FRAGMENTS_MAX);
+
+    // Largest payload fills all fragments.
+    tt_want_uint_op(make_fragments(PBIO_BROADCAST_DATA_MAX_SIZE, 9), ==, 4);
+    for (uint8_t i = 0; i < 4; i++) {
+        tt_want_uint_op(fragment_sizes[i], ==, FRAGMENT_MAX_SIZE);
+        tt_want_uint_op(fragments[i][0], ==, 0xE0 | i);
+        tt_want_uint_op(fragments[i][1], ==, 9);
+        tt_want_uint_op(fragments[i][2], ==, 4);
+        tt_want(pbio_broadcast_is_fragment(fragments[i], fragment_sizes[i]));
+        tt_want_int_op(memcmp(&fragments[i][PBIO_BROADCAST_FRAGMENT_HEADER_SIZE],
+            &payload[i * PBIO_BROADCAST_FRAGMENT_DATA_SIZE], PBIO_BROADCAST_FRAGMENT_DATA_SIZE), ==, 0);
+    }
+
+    // Only the last fragment is shorter.
+    tt_want_uint_op(make_fragments(50, 200), ==, 3);
+    tt_want_uint_op(fragment_sizes[0], ==, FRAGMENT_MAX_SIZE);
+    tt_want_uint_op(fragment_sizes[1], ==, FRAGMENT_MAX_SIZE);
+    tt_want_uint_op(fragment_sizes[2], ==, PBIO_BROADCAST_FRAGMENT_HEADER_SIZE + 50 - 2 * PBIO_BROADCAST_FRAGMENT_DATA_SIZE);
+    tt_want_uint_op(fragments[2][0], ==, 0xE2);
+    tt_want_uint_op(fragments[2][2], ==, 3);
+    tt_want_uint_op(fragments[2][PBIO_BROADCAST_FRAGMENT_HEADER_SIZE], ==, payload[2 * PBIO_BROADCAST_FRAGMENT_DATA_SIZE]);
+
+    // Regular broadcast data is not a fragment. The first byte of that is an
+    // encoded object with a type code of at most 6.
+    static const uint8_t data[] = { 0xC2, 0x01, 0x02 };
+    tt_want(!pbio_broadcast_is_fragment(data, sizeof(data)));
+    tt_want(!pbio_broadcast_is_fragment(fragments[0], 2));
+}
+
+static void test_reassemble(void *env) {
+    pbio_broadcast_reassembly_t reassembly = { 0 };
+    uint8_t received[PBIO_BROADCAST_DATA_MAX_SIZE];
+    size_t received_size = 0;
+
+    // In order.
+    make_fragments(50, 1);
+    tt_want(!add(&reassembly, 0, received, &received_size));
+    tt_want(!add(&reassembly, 1, received, &received_size));
+    tt_want(add(&reassembly, 2, received, &received_size));
+    tt_want_uint_op(received_size, ==, 50);
+    tt_want_int_op(memcmp(received, payload, 50), ==, 0);
+
+    // Out of order, with duplicates.
+    make_fragments(PBIO_BROADCAST_DATA_MAX_SIZE, 2);
+    tt_want(!add(&reassembly, 3, received, &received_size));
+    tt_want(!add(&reassembly, 1, received, &received_size));
+    tt_want(!add(&reassembly, 3, received, &received_size));
+    tt_want(!add(&reassembly, 0, received, &received_size));
+    tt_want(add(&reassembly, 2, received, &received_size));
+    tt_want_uint_op(received_size, ==, PBIO_BROADCAST_DATA_MAX_SIZE);
+    tt_want_int_op(memcmp(received, payload, PBIO_BROADCAST_DATA_MAX_SIZE), ==, 0);
+
+    // The same payload broadcast again is received again once complete.
+    tt_want(!add(&reassembly, 0, received, &received_size));
+    tt_want(!add(&reassembly, 1, received, &received_size));
+    tt_want(!add(&reassembly, 2, received, &received_size));
+    tt_want(add(&reassembly, 3, received, &received_size));
+}
+
+static void test_lost_fragment(void *env) {
+    pbio_broadcast_reassembly_t reassembly = { 0 };
+    uint8_t received[PBIO_BROADCAST_DATA_MAX_SIZE];
+    size_t received_size = 0;
+
+    // Fragment 1 of the first payload is lost.
+    make_fragments(60, 5);
+    tt_want(!add(&reassembly, 0, received, &received_size));
+    tt_want(!add(&reassembly, 2, received, &received_size));
+
+    // Fragments of the next payload must not be mixed with the old ones.
+    make_fragments(60, 6);
+    tt_want(!add(&reassembly, 1, received, &received_size));
+    tt_want(!add(&reassembly, 2, received, &received_size));
+    tt_want(add(&reassembly, 0, received, &received_size));
+    tt_want_uint_op(received_size, ==, 60);
+    tt_want_int_op(memcmp(received, payload, 60), ==, 0);
+
+    // Same sequence number but a different number of fragments is also a new
+    // payload, as can happen when the sender restarts.
+    make_fragments(60, 7);
+    tt_want(!add(&reassembly, 0, received, &received_size));
+    tt_want(!add(&reassembly, 1, received, &received_size));
+    make_fragments(30, 7);
+    tt_want(!add(&reassembly, 1, received, &received_size));
+    tt_want(add(&reassembly, 0, received, &received_size));
+    tt_want_uint_op(received_size, ==, 30);
+    tt_want_int_op(memcmp(received, payload, 30), ==, 0);
+}
+
+static void test_malformed(void *env) {
+    pbio_broadcast_reassembly_t reassembly = { 0 };
+    uint8_t received[PBIO_BROADCAST_DATA_MAX_SIZE];
+    size_t received_size = 0;
+    uint8_t fragment[FRAGMENT_MAX_SIZE] = { 0 };
+
+    // Index beyond the number of fragments.
+    fragment[0] = 0xE2;
+    fragment[1] = 1;
+    fragment[2] = 2;
+    tt_want(!pbio_broadcast_add_fragment(&reassembly, fragment, sizeof(fragment), received, &received_size));
+
+    // Too many fragments.
+    fragment[0] = 0xE0;
+    fragment[2] = PBIO_BROADCAST_FRAGMENTS_MAX + 1;
+    tt_want(!pbio_broadcast_add_fragment(&reassembly, fragment, sizeof(fragment), received, &received_size));
+
+    // No fragments.
+    fragment[2] = 0;
+    tt_want(!pbio_broadcast_add_fragment(&reassembly, fragment, sizeof(fragment), received, &received_size));
+
+    // Short fragment that is not the last one.
+    fragment[2] = 2;
+    tt_want(!pbio_broadcast_add_fragment(&reassembly, fragment, sizeof(fragment) - 1, received, &received_size));
+
+    // A single fragment of any size completes the payload.
+    fragment[2] = 1;
+    fragment[3] = 42;
+    tt_want(pbio_broadcast_add_fragment(&reassembly, fragment, 4, received, &received_size));
+    tt_want_uint_op(received_size, ==, 1);
+    tt_want_uint_op(received[0], ==, 42);
+
+    // Malformed fragments did not leave anything behind.
+    make_fragments(40, 1);
+    tt_want(!add(&reassembly, 0, received, &received_size));
+    tt_want(add(&reassembly, 1, received, &received_size));
+    tt_want_uint_op(received_size, ==, 40);
+    tt_want_int_op(memcmp(received, payload, 40), ==, 0);
+}
+
+static void test_receive_count(void *env) {
+    pbio_broadcast_received_t received = { 0 };
+
+    // Two tasks start waiting at different times on the same channel.
+    uint32_t first = received.count;
+    static const uint8_t data[] = { 0x00, 0x61, 42 };
+    pbio_broadcast_receive(&received, data, sizeof(data));
+    uint32_t second = received.count;
+    tt_want(pbio_broadcast_is_received_since(&received, first));
+    tt_want(!pbio_broadcast_is_received_since(&received, second));
+    tt_want_uint_op(received.size, ==, sizeof(data));
+    tt_want_int_op(memcmp(received.data, data, sizeof(data)), ==, 0);
+
+    // Waiting again does not affect tasks that were already waiting, and the
+    // same data received again is new data too.
+    uint32_t third = received.count;
+    pbio_broadcast_receive(&received, data, sizeof(data));
+    tt_want(pbio_broadcast_is_received_since(&received, first));
+    tt_want(pbio_broadcast_is_received_since(&received, second));
+    tt_want(pbio_broadcast_is_received_since(&received, third));
+
+    // Fragments only count once the payload is complete.
+    uint32_t fourth = received.count;
+    uint8_t count = make_fragments(70, 3);
+    for (uint8_t i = 0; i < count - 1; i++) {
+        pbio_broadcast_receive(&received, fragments[i], fragment_sizes[i]);
+        tt_want(!pbio_broadcast_is_received_since(&received, fourth));
+    }
+
+    // The last payload stays intact until the new one is complete.
+    tt_want_uint_op(received.size, ==, sizeof(data));
+    tt_want_int_op(memcmp(received.data, data, sizeof(data)), ==, 0);
+
+    pbio_broadcast_receive(&received, fragments[count - 1], fragment_sizes[count - 1]);
+    tt_want(pbio_broadcast_is_received_since(&received, fourth));
+    tt_want_uint_op(received.count, ==, fourth + 1);
+    tt_want_uint_op(received.size, ==, 70);
+    tt_want_int_op(memcmp(received.data, payload, 70), ==, 0);
+
+    // The count wraps around.
+    received.count = UINT32_MAX;
+    pbio_broadcast_receive(&received, data, sizeof(data));
+    tt_want(pbio_broadcast_is_received_since(&received, UINT32_MAX));
+    tt_want(!pbio_broadcast_is_received_since(&received, 0));
+}
+
+struct testcase_t pbio_broadcast_tests[] = {
+    PBIO_TEST(test_encode),
+    PBIO_TEST(test_reassemble),
+    PBIO_TEST(test_lost_fragment),
+    PBIO_TEST(test_malformed),
+    PBIO_TEST(test_receive_count),
+    END_OF_TESTCASES
+};
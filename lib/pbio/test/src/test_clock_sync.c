@@ -0,0 +1,113 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2025 The Pybricks Authors
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <pbio/clock_sync.h>
+#include <test-pbio.h>
+
+#include <tinytest.h>
+#include <tinytest_macros.h>
+
+static uint32_t get_time(pbio_clock_sync_t *sync, uint32_t now) {
+    uint32_t time = 0;
+    tt_want(pbio_clock_sync_get_time(sync, now, &time));
+    return time;
+}
+
+static void test_offset(void *env) {
+    pbio_clock_sync_t sync;
+    pbio_clock_sync_reset(&sync);
+
+    // No time until the first sample is received.
+    uint32_t time;
+    tt_want(!pbio_clock_sync_get_time(&sync, 1000, &time));
+
+    // The first sample sets the offset.
+    pbio_clock_sync_update(&sync, 5000, 1000);
+    tt_want_uint_op(get_time(&sync, 1000), ==, 5000);
+    tt_want_uint_op(get_time(&sync, 1500), ==, 5500);
+
+    // Offsets are also valid when either clock wraps around.
+    pbio_clock_sync_reset(&sync);
+    pbio_clock_sync_update(&sync, 100, UINT32_MAX - 99);
+    tt_want_uint_op(get_time(&sync, UINT32_MAX - 99), ==, 100);
+    tt_want_uint_op(get_time(&sync, 100), ==, 300);
+
+    pbio_clock_sync_reset(&sync);
+    pbio_clock_sync_update(&sync, UINT32_MAX - 99, 100);
+    tt_want_uint_op(get_time(&sync, 300), ==, 100);
+}
+
+static void test_best_sample(void *env) {
+    pbio_clock_sync_t sync;
+    pbio_clock_sync_reset(&sync);
+
+    pbio_clock_sync_update(&sync, 10000, 0);
+
+    // Samples that arrived late don't lower the estimate within a window.
+    pbio_clock_sync_update(&sync, 10090, 100);
+    tt_want_uint_op(get_time(&sync, 100), ==, 10100);
+
+    // A sample ahead of the estimate is used right away.
+    pbio_clock_sync_update(&sync, 10205, 200);
+    tt_want_uint_op(get_time(&sync, 200), ==, 10205);
+    tt_want_uint_op(get_time(&sync, 300), ==, 10305);
+}
+
+static void test_monotonic(void *env) {
+    pbio_clock_sync_t sync;
+    pbio_clock_sync_reset(&sync);
+
+    pbio_clock_sync_update(&sync, 10000, 0);
+
+    // All samples in the next window arrive 10 ms later than the first.
+    for (uint32_t now = 100; now < PBIO_CLOCK_SYNC_WINDOW_MS; now += 100) {
+        pbio_clock_sync_update(&sync, now + 9990, now);
+    }
+    tt_want_uint_op(get_time(&sync, 999), ==, 10999);
+
+    // At the end of the window, the estimate goes down by 10 ms, but the time
+    // stays the same until the estimate catches up.
+    pbio_clock_sync_update(&sync, 10990, PBIO_CLOCK_SYNC_WINDOW_MS);
+    tt_want_uint_op(get_time(&sync, 1000), ==, 10999);
+    tt_want_uint_op(get_time(&sync, 1005), ==, 10999);
+    tt_want_uint_op(get_time(&sync, 1009), ==, 10999);
+    tt_want_uint_op(get_time(&sync, 1010), ==, 11000);
+    tt_want_uint_op(get_time(&sync, 1020), ==, 11010);
+
+    // Resetting also forgets the last time.
+    pbio_clock_sync_reset(&sync);
+    pbio_clock_sync_update(&sync, 500, 0);
+    tt_want_uint_op(get_time(&sync, 0), ==, 500);
+}
+
+static void test_drift(void *env) {
+    pbio_clock_sync_t sync;
+    pbio_clock_sync_reset(&sync);
+
+    // The leader clock runs 1000 ppm faster. Samples arrive every 100 ms, with
+    // a varying delay of up to 20 ms.
+    uint32_t now;
+    for (now = 0; now <= 2 * PBIO_CLOCK_SYNC_DRIFT_MIN_TIME_MS; now += 100) {
+        uint32_t delay = (now / 100 * 7) % 21;
+        pbio_clock_sync_update(&sync, 5000 + now - delay + now / 1000, now);
+    }
+
+    tt_want_int_op(abs(sync.drift_ppm - 1000), <, 100);
+
+    // Without new samples, the estimate keeps following the leader.
+    now += 10000;
+    int32_t error = get_time(&sync, now) - (5000 + now + now / 1000);
+    tt_want_int_op(abs(error), <=, 2);
+}
+
+struct testcase_t pbio_clock_sync_tests[] = {
+    PBIO_TEST(test_offset),
+    PBIO_TEST(test_best_sample),
+    PBIO_TEST(test_monotonic),
+    PBIO_TEST(test_drift),
+    END_OF_TESTCASES
+};
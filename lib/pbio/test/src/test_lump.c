@@ -14,6 +14,7 @@
 #include <tinytest.h>
 #include <tinytest_macros.h>
 
+#include <pbdrv/clock.h>
 #include <pbdrv/uart.h>
 #include <pbio/main.h>
 #include <pbio/os.h>
@@ -21,6 +22,8 @@
 #include <test-pbio.h>
 
 #include "../drv/clock/clock_test.h"
+#include "../drv/uart/lump_emulator.h"
+#include "benchmark.h"
 
 // TODO: submit this upstream
 #ifndef tt_want_float_op
@@ -34,6 +37,8 @@ struct _pbdrv_uart_dev_t {
     uint8_t *rx_msg;
     uint8_t rx_msg_length;
     pbio_error_t rx_msg_result;
+    bool rx_msg_any_length;
+    uint8_t rx_msg_received;
     uint8_t *tx_msg;
     pbio_os_timer_t tx_timer;
     uint8_t tx_msg_length;
@@ -55,11 +60,22 @@ static void simulate_uart_complete_irq(void) {
 pbio_error_t simulate_rx_msg(pbio_os_state_t *state, const uint8_t *msg, uint8_t length) {
     PBIO_OS_ASYNC_BEGIN(state);
 
-    // First uartdev reads one byte header
     PBIO_OS_AWAIT_UNTIL(state, ({
         pbio_test_clock_tick(1);
         test_uart.rx_msg_result == PBIO_ERROR_AGAIN;
     }));
+
+    // In data mode, uartdev reads everything that is available at once
+    if (test_uart.rx_msg_any_length) {
+        tt_uint_op(test_uart.rx_msg_length, >=, length);
+        memcpy(test_uart.rx_msg, msg, length);
+        test_uart.rx_msg_received = length;
+        test_uart.rx_msg_result = PBIO_SUCCESS;
+        simulate_uart_complete_irq();
+        return PBIO_SUCCESS;
+    }
+
+    // Otherwise uartdev first reads one byte header
     tt_uint_op(test_uart.rx_msg_length, ==, 1);
     memcpy(test_uart.rx_msg, msg, 1);
     test_uart.rx_msg_result = PBIO_SUCCESS;
@@ -215,6 +231,12 @@ static pbio_error_t test_boost_color_distance_sensor(pbio_os_state_t *state, voi
     // mode 6 DATA message captured from BOOST Color and Distance Sensor
     static const uint8_t msg85[] = { 0x46, 0x00, 0xB9 }; // extended mode info
     static const uint8_t msg86[] = { 0xC0 | 0x18 | 0x06, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x21 }; // mode 6 data
+    static const uint8_t msg86b[] = {
+        0x00, // noise
+        0xC0 | 0x18 | 0x06, 0x09, 0x00, 0x09, 0x00, 0x09, 0x00, 0x00, 0x00, 0x22, // mode 6 data with bad checksum
+        0x46, 0x00, 0xB9, // extended mode info
+        0xC0 | 0x18 | 0x06, 0x01, 0x00, 0x02, 0x00, 0x03, 0x00, 0x00, 0x00, 0x21, // mode 6 data
+    };
 
     static const uint8_t msg87[] = { 0x43, 0x01, 0xBD }; // set mode 1
     static const uint8_t msg88[] = { 0xC1, 0x00, 0x3E }; // mode 1 data
@@ -223,6 +245,10 @@ static pbio_error_t test_boost_color_distance_sensor(pbio_os_state_t *state, voi
     static const uint8_t msg90[] = { 0x46, 0x08, 0xB1 }; // extended mode info
     static const uint8_t msg91[] = { 0xD0, 0x00, 0x00, 0x00, 0x00, 0x2F }; // mode 8 data
 
+    static const uint8_t msg92[] = { 0x5C, 0x20, 0x60, 0x61, 0x62, 0x10, 0x00, 0x00, 0x00, 0xF0 }; // set mode combination 0 with modes 6 and 1
+    static const uint8_t msg93[] = { 0xDE, 0x01, 0x00, 0x02, 0x00, 0x03, 0x00, 0x2A, 0x00, 0x0B }; // combined data
+    static const uint8_t msg94[] = { 0xDE, 0x04, 0x00, 0x05, 0x00, 0x06, 0x00, 0x00, 0x00, 0x26 }; // mode 6 data
+
     // used in SIMULATE_RX/TX_MSG macros
     static pbio_os_state_t child;
 
@@ -363,6 +389,10 @@ static pbio_error_t test_boost_color_distance_sensor(pbio_os_state_t *state, voi
         SIMULATE_TX_MSG(msg84);
     }
 
+    // receive several messages in one read, where only the good ones are used
+    SIMULATE_RX_MSG(msg86b);
+    PBIO_OS_AWAIT_ONCE_AND_POLL(state);
+
     // Wait for default mode to complete
     PBIO_OS_AWAIT_WHILE(state, ({
         pbio_test_clock_tick(1);
@@ -371,6 +401,14 @@ static pbio_error_t test_boost_color_distance_sensor(pbio_os_state_t *state, voi
 
     tt_uint_op(err, ==, PBIO_SUCCESS);
 
+    {
+        int16_t *rgbi;
+        tt_uint_op(pbio_port_lump_get_data(lump_dev, LEGO_DEVICE_MODE_PUP_COLOR_DISTANCE_SENSOR__RGB_I, (void **)&rgbi), ==, PBIO_SUCCESS);
+        tt_want_int_op(rgbi[0], ==, 1);
+        tt_want_int_op(rgbi[1], ==, 2);
+        tt_want_int_op(rgbi[2], ==, 3);
+    }
+
     type_id = LEGO_DEVICE_TYPE_ID_ANY_LUMP_UART;
     tt_uint_op(pbio_port_lump_assert_type_id(lump_dev, &type_id), ==, PBIO_SUCCESS);
     tt_uint_op(pbio_port_lump_get_info(lump_dev, &num_modes, &current_mode, &mode_info), ==, PBIO_SUCCESS);
@@ -478,6 +516,82 @@ static pbio_error_t test_boost_color_distance_sensor(pbio_os_state_t *state, voi
     tt_uint_op(pbio_port_lump_get_info(lump_dev, &num_modes, &current_mode, &mode_info), ==, PBIO_SUCCESS);
     tt_uint_op(current_mode, ==, 8);
 
+    // Stream the data of modes 6 and 1 together. Mode 8 is not in the
+    // combinations advertised by the sensor.
+    static const uint8_t combi_bad[] = { 6, 8 };
+    tt_uint_op(pbio_port_lump_set_combi_mode(lump_dev, combi_bad, PBIO_ARRAY_SIZE(combi_bad)), ==, PBIO_ERROR_INVALID_ARG);
+    static const uint8_t combi[] = { 6, 1 };
+    tt_uint_op(pbio_port_lump_set_combi_mode(lump_dev, combi, PBIO_ARRAY_SIZE(combi)), ==, PBIO_SUCCESS);
+
+    static uint32_t time_before, count_before;
+    tt_uint_op(pbio_port_lump_get_data_time(lump_dev, &time_before, &count_before), ==, PBIO_SUCCESS);
+
+    // The combination is selected with its first mode, then set up. Data of
+    // the first mode by itself has the same size as the combined data, but
+    // it must not be used as such before the combination is set up, nor if
+    // it was sent just before the device got the combination.
+    SIMULATE_TX_MSG(msg83b);
+    SIMULATE_RX_MSG(msg85);
+    SIMULATE_RX_MSG(msg94);
+    SIMULATE_TX_MSG(msg92);
+    SIMULATE_RX_MSG(msg85);
+    SIMULATE_RX_MSG(msg94);
+    tt_uint_op(pbio_port_lump_is_ready(lump_dev), ==, PBIO_ERROR_AGAIN);
+    static uint32_t setup_time;
+    setup_time = pbdrv_clock_get_ms();
+    PBIO_OS_AWAIT_UNTIL(state, ({
+        pbio_test_clock_tick(1);
+        pbdrv_clock_get_ms() - setup_time >= 10;
+    }));
+
+    SIMULATE_RX_MSG(msg85);
+    SIMULATE_RX_MSG(msg93);
+
+    PBIO_OS_AWAIT_WHILE(state, ({
+        pbio_test_clock_tick(1);
+        (err = pbio_port_lump_is_ready(lump_dev)) == PBIO_ERROR_AGAIN;
+    }));
+    tt_uint_op(err, ==, PBIO_SUCCESS);
+
+    {
+        uint8_t *data;
+        tt_uint_op(pbio_port_lump_get_data(lump_dev, PBIO_PORT_LUMP_MODE_COMBI, (void **)&data), ==, PBIO_SUCCESS);
+        tt_want_int_op(pbio_get_uint16_le(data + 0), ==, 1);
+        tt_want_int_op(pbio_get_uint16_le(data + 2), ==, 2);
+        tt_want_int_op(pbio_get_uint16_le(data + 4), ==, 3);
+        tt_want_int_op(data[6], ==, 42);
+
+        // Exactly one new sample, received after the previous one.
+        uint32_t time, count;
+        tt_uint_op(pbio_port_lump_get_data_time(lump_dev, &time, &count), ==, PBIO_SUCCESS);
+        tt_want_uint_op(count, ==, count_before + 1);
+        tt_want_uint_op(time, >, time_before);
+        tt_want_uint_op(time, <=, pbdrv_clock_get_ms());
+    }
+
+    // In a combination, the first mode is reported as the current mode.
+    tt_uint_op(pbio_port_lump_get_info(lump_dev, &num_modes, &current_mode, &mode_info), ==, PBIO_SUCCESS);
+    tt_uint_op(current_mode, ==, 6);
+
+    // Selecting a single mode ends the combination.
+    tt_uint_op(pbio_port_lump_set_mode(lump_dev, 6), ==, PBIO_SUCCESS);
+    SIMULATE_TX_MSG(msg84); // keep alive is due first
+    SIMULATE_TX_MSG(msg83b);
+    SIMULATE_RX_MSG(msg94);
+
+    PBIO_OS_AWAIT_WHILE(state, ({
+        pbio_test_clock_tick(1);
+        (err = pbio_port_lump_is_ready(lump_dev)) == PBIO_ERROR_AGAIN;
+    }));
+    tt_uint_op(err, ==, PBIO_SUCCESS);
+
+    {
+        uint8_t *data;
+        tt_uint_op(pbio_port_lump_get_data(lump_dev, 6, (void **)&data), ==, PBIO_SUCCESS);
+        tt_want_int_op(pbio_get_uint16_le(data + 0), ==, 4);
+        tt_want_int_op(pbio_get_uint16_le(data + 2), ==, 5);
+        tt_want_int_op(pbio_get_uint16_le(data + 4), ==, 6);
+    }
 
 end:
 
@@ -1075,6 +1189,411 @@ static pbio_error_t test_technic_xl_motor(pbio_os_state_t *state, void *context)
 
 
 
+end:
+    PBIO_OS_ASYNC_END(PBIO_SUCCESS);
+}
+
+static pbdrv_lump_emulator_t emulator;
+
+/**
+ * Connects the emulated device to the test UART. This takes the place of the
+ * UART driver and its IRQ handlers, so it should be called on every tick.
+ */
+static void simulate_emulator_uart(void) {
+
+    // Nothing happens on the line if no device is plugged in.
+    if (!emulator.device) {
+        return;
+    }
+
+    if (test_uart.tx_msg && test_uart.tx_msg_result == PBIO_ERROR_AGAIN) {
+        pbdrv_lump_emulator_write(&emulator, test_uart.baud, test_uart.tx_msg, test_uart.tx_msg_length);
+        test_uart.tx_msg_result = PBIO_SUCCESS;
+        simulate_uart_complete_irq();
+    }
+
+    // Always check what is available, so bytes sent at the wrong baud rate
+    // are lost even if nothing is being read.
+    uint32_t available = pbdrv_lump_emulator_get_available(&emulator, test_uart.baud);
+
+    if (!test_uart.rx_msg || test_uart.rx_msg_result != PBIO_ERROR_AGAIN) {
+        return;
+    }
+
+    // In data mode, everything that is available is read at once.
+    if (test_uart.rx_msg_any_length && available) {
+        test_uart.rx_msg_received = pbdrv_lump_emulator_read(&emulator, test_uart.baud, test_uart.rx_msg, test_uart.rx_msg_length);
+        test_uart.rx_msg_result = PBIO_SUCCESS;
+        simulate_uart_complete_irq();
+        return;
+    }
+
+    // Otherwise the read completes when the requested size is received.
+    if (!test_uart.rx_msg_any_length && available >= test_uart.rx_msg_length) {
+        pbdrv_lump_emulator_read(&emulator, test_uart.baud, test_uart.rx_msg, test_uart.rx_msg_length);
+        test_uart.rx_msg_result = PBIO_SUCCESS;
+        simulate_uart_complete_irq();
+    }
+}
+
+#define EMULATOR_AWAIT_UNTIL(condition) PBIO_OS_AWAIT_UNTIL(state, ({ \
+        pbio_test_clock_tick(1); \
+        simulate_emulator_uart(); \
+        (condition); \
+    }))
+
+/**
+ * Connects an emulated device to port D and checks that the hub gets the
+ * same device info as given in the emulator tables.
+ */
+static pbio_error_t emulate_device(pbio_os_state_t *state, const pbdrv_lump_emulator_device_t *device, pbio_port_lump_dev_t **lump_dev) {
+
+    static pbio_port_t *port;
+    static lego_device_type_id_t type_id;
+    static pbio_port_lump_mode_info_t *mode_info;
+    static uint8_t current_mode;
+    static uint8_t num_modes;
+    static uint32_t start;
+    static pbio_error_t err;
+
+    PBIO_OS_ASYNC_BEGIN(state);
+
+    tt_uint_op(pbio_port_get_port(PBIO_PORT_ID_D, &port), ==, PBIO_SUCCESS);
+
+    // Plug in the device when the hub starts looking for one.
+    PBIO_OS_AWAIT_UNTIL(state, ({
+        pbio_test_clock_tick(1);
+        test_uart.baud == 115200;
+    }));
+    pbdrv_lump_emulator_init(&emulator, device);
+
+    // Syncing at 2400 baud takes a few seconds for devices with many modes.
+    start = pbdrv_clock_get_ms();
+    type_id = device->type_id;
+    EMULATOR_AWAIT_UNTIL((err = pbio_port_get_lump_device(port, &type_id, lump_dev)) != PBIO_ERROR_AGAIN ||
+        pbdrv_clock_get_ms() - start > 10000);
+    tt_uint_op(err, ==, PBIO_SUCCESS);
+    tt_uint_op(emulator.num_syncs, ==, 1);
+
+    tt_uint_op(pbio_port_lump_get_info(*lump_dev, &num_modes, &current_mode, &mode_info), ==, PBIO_SUCCESS);
+    tt_uint_op(num_modes, ==, device->num_modes);
+    for (uint8_t i = 0; i < num_modes; i++) {
+        tt_want_str_op(mode_info[i].name, ==, device->modes[i].name);
+        tt_want_uint_op(mode_info[i].num_values, ==, device->modes[i].num_values);
+        tt_want_uint_op(mode_info[i].data_type, ==, device->modes[i].data_type);
+        tt_want_uint_op(mode_info[i].writable, ==, device->modes[i].writable);
+    }
+
+    // Wait for the default mode to be set, if any.
+    EMULATOR_AWAIT_UNTIL(pbio_port_lump_is_ready(*lump_dev) == PBIO_SUCCESS);
+    tt_uint_op(emulator.mode, ==, current_mode);
+
+end:
+    PBIO_OS_ASYNC_END(PBIO_SUCCESS);
+}
+
+#define EMULATE_DEVICE(device) do { \
+        PBIO_OS_AWAIT(state, &child, err = emulate_device(&child, (device), &lump_dev)); \
+        tt_assert_msg(err == PBIO_SUCCESS, #device); \
+} while (0)
+
+/** Emulated devices and the baud rate they should end up using. */
+static const struct {
+    const pbdrv_lump_emulator_device_t *device;
+    uint32_t baud_rate;
+} emulated_devices[] = {
+    // This device syncs at 2400 baud.
+    { &pbdrv_lump_emulator_color_distance_sensor, 115200 },
+    { &pbdrv_lump_emulator_spike_color_sensor, 115200 },
+    { &pbdrv_lump_emulator_spike_ultrasonic_sensor, 115200 },
+    { &pbdrv_lump_emulator_spike_force_sensor, 115200 },
+    // This device is asked to go faster than the advertised rate.
+    { &pbdrv_lump_emulator_technic_m_angular_motor, 230400 },
+};
+
+static pbio_error_t test_emulated_devices(pbio_os_state_t *state, void *context) {
+
+    static pbio_os_state_t child;
+    static pbio_port_lump_dev_t *lump_dev;
+    static pbio_error_t err;
+    static uint32_t i;
+    static uint32_t time;
+    static uint32_t count;
+
+    PBIO_OS_ASYNC_BEGIN(state);
+
+    for (i = 0; i < PBIO_ARRAY_SIZE(emulated_devices); i++) {
+        EMULATE_DEVICE(emulated_devices[i].device);
+        tt_want_uint_op(test_uart.baud, ==, emulated_devices[i].baud_rate);
+        tt_want_uint_op(emulator.baud_rate, ==, emulated_devices[i].baud_rate);
+
+        // Samples are counted from the last sync, not from the previous
+        // device, which sent more samples than this one so far.
+        pbio_port_lump_get_data_time(lump_dev, &time, &count);
+        tt_want_uint_op(count, <, 50);
+        EMULATOR_AWAIT_UNTIL(pbio_port_lump_get_data_time(lump_dev, &time, &count) == PBIO_SUCCESS && count >= 50);
+
+        // Unplug the device and wait for the hub to notice.
+        emulator.device = NULL;
+        EMULATOR_AWAIT_UNTIL(pbio_port_lump_is_ready(lump_dev) != PBIO_SUCCESS);
+    }
+
+end:
+    PBIO_OS_ASYNC_END(PBIO_SUCCESS);
+}
+
+static pbio_error_t test_emulated_fast_baud_not_supported(pbio_os_state_t *state, void *context) {
+
+    static pbdrv_lump_emulator_device_t device;
+    static pbio_port_t *port;
+    static pbio_port_lump_dev_t *lump_dev;
+    static lego_device_type_id_t type_id;
+    static uint32_t start;
+    static pbio_error_t err;
+
+    PBIO_OS_ASYNC_BEGIN(state);
+
+    // This motor type is asked to go faster, but this one ignores it.
+    device = pbdrv_lump_emulator_technic_m_angular_motor;
+    device.max_baud_rate = 115200;
+
+    tt_uint_op(pbio_port_get_port(PBIO_PORT_ID_D, &port), ==, PBIO_SUCCESS);
+    PBIO_OS_AWAIT_UNTIL(state, ({
+        pbio_test_clock_tick(1);
+        test_uart.baud == 115200;
+    }));
+    pbdrv_lump_emulator_init(&emulator, &device);
+
+    // The hub gets no data at the faster rate, so it syncs again and stays
+    // at the advertised rate.
+    start = pbdrv_clock_get_ms();
+    EMULATOR_AWAIT_UNTIL(emulator.num_syncs == 2 || pbdrv_clock_get_ms() - start > 10000);
+    tt_uint_op(emulator.num_syncs, ==, 2);
+
+    type_id = device.type_id;
+    EMULATOR_AWAIT_UNTIL((err = pbio_port_get_lump_device(port, &type_id, &lump_dev)) != PBIO_ERROR_AGAIN ||
+        pbdrv_clock_get_ms() - start > 10000);
+    tt_uint_op(err, ==, PBIO_SUCCESS);
+    EMULATOR_AWAIT_UNTIL(pbio_port_lump_is_ready(lump_dev) == PBIO_SUCCESS);
+
+    // The connection stays up at 115200 baud.
+    start = pbdrv_clock_get_ms();
+    EMULATOR_AWAIT_UNTIL(pbdrv_clock_get_ms() - start >= 2000);
+    tt_want_uint_op(test_uart.baud, ==, 115200);
+    tt_want_uint_op(emulator.baud_rate, ==, 115200);
+    tt_want_uint_op(emulator.num_syncs, ==, 2);
+    tt_want_uint_op(pbio_port_lump_is_ready(lump_dev), ==, PBIO_SUCCESS);
+
+end:
+    PBIO_OS_ASYNC_END(PBIO_SUCCESS);
+}
+
+static pbio_error_t test_emulated_mode_switch_and_bad_data(pbio_os_state_t *state, void *context) {
+
+    static pbio_os_state_t child;
+    static pbio_port_lump_dev_t *lump_dev;
+    static pbio_error_t err;
+    static uint32_t start;
+    static uint32_t hub_count_start;
+    static uint32_t good_count_start;
+    static uint32_t time;
+    static uint32_t count;
+    static uint8_t mode;
+
+    PBIO_OS_ASYNC_BEGIN(state);
+
+    EMULATE_DEVICE(&pbdrv_lump_emulator_spike_color_sensor);
+
+    // Every tenth data message has a bad checksum from now on.
+    emulator.corrupt_interval = 10;
+
+    // Cycle through all modes, including those above LUMP_MAX_MODE.
+    for (mode = 0; mode < pbdrv_lump_emulator_spike_color_sensor.num_modes; mode++) {
+        start = pbdrv_clock_get_ms();
+        pbio_port_lump_get_data_time(lump_dev, &time, &hub_count_start);
+        tt_uint_op(pbio_port_lump_set_mode(lump_dev, mode), ==, PBIO_SUCCESS);
+
+        // The device sends data right after switching, so the hub should get
+        // data of the new mode within two data intervals, even if the first
+        // data message is bad.
+        EMULATOR_AWAIT_UNTIL(({
+            pbio_port_lump_get_data_time(lump_dev, &time, &count);
+            count != hub_count_start;
+        }));
+        tt_uint_op(pbdrv_clock_get_ms() - start, <=, 2 * emulator.data_interval);
+
+        EMULATOR_AWAIT_UNTIL(pbio_port_lump_is_ready(lump_dev) == PBIO_SUCCESS);
+        tt_uint_op(emulator.mode, ==, mode);
+
+        // Only data messages with a good checksum should be counted.
+        pbio_port_lump_get_data_time(lump_dev, &time, &hub_count_start);
+        good_count_start = emulator.num_data_sent - emulator.num_data_corrupted;
+        start = pbdrv_clock_get_ms();
+        EMULATOR_AWAIT_UNTIL(pbdrv_clock_get_ms() - start >= 500);
+        pbio_port_lump_get_data_time(lump_dev, &time, &count);
+
+        tt_int_op(count - hub_count_start, >=, emulator.num_data_sent - emulator.num_data_corrupted - good_count_start - 1);
+        tt_int_op(count - hub_count_start, <=, emulator.num_data_sent - emulator.num_data_corrupted - good_count_start + 1);
+    }
+
+    tt_uint_op(emulator.num_data_corrupted, >, 0);
+    tt_uint_op(emulator.num_syncs, ==, 1);
+
+    // Data for writable modes should reach the device.
+    static const uint8_t light[] = { 10, 20, 30 };
+    tt_uint_op(pbio_port_lump_set_mode_with_data(lump_dev, 3, light, sizeof(light)), ==, PBIO_SUCCESS);
+    EMULATOR_AWAIT_UNTIL(pbio_port_lump_is_ready(lump_dev) == PBIO_SUCCESS);
+    tt_int_op(memcmp(emulator.data[3], light, sizeof(light)), ==, 0);
+
+end:
+    PBIO_OS_ASYNC_END(PBIO_SUCCESS);
+}
+
+static pbio_error_t test_emulated_data_rate(pbio_os_state_t *state, void *context) {
+
+    static pbio_os_state_t child;
+    static pbio_port_lump_dev_t *lump_dev;
+    static pbio_error_t err;
+    static uint32_t start;
+    static uint32_t hub_count_start;
+    static uint32_t good_count_start;
+    static uint32_t time;
+    static uint32_t count;
+
+    PBIO_OS_ASYNC_BEGIN(state);
+
+    EMULATE_DEVICE(&pbdrv_lump_emulator_spike_color_sensor);
+
+    // Data messages follow each other with hardly any time in between, so
+    // the hub must find the start of the next message right after a bad one.
+    emulator.data_interval = 1;
+    emulator.corrupt_interval = 7;
+
+    pbio_port_lump_get_data_time(lump_dev, &time, &hub_count_start);
+    good_count_start = emulator.num_data_sent - emulator.num_data_corrupted;
+    start = pbdrv_clock_get_ms();
+    EMULATOR_AWAIT_UNTIL(pbdrv_clock_get_ms() - start >= 2000);
+    pbio_port_lump_get_data_time(lump_dev, &time, &count);
+
+    // No good data is dropped by the hub.
+    tt_uint_op(emulator.num_data_sent - emulator.num_data_corrupted - good_count_start, >=, 1500);
+    tt_int_op(count - hub_count_start, >=, emulator.num_data_sent - emulator.num_data_corrupted - good_count_start - 1);
+    tt_int_op(count - hub_count_start, <=, emulator.num_data_sent - emulator.num_data_corrupted - good_count_start);
+    tt_uint_op(emulator.num_bytes_dropped, ==, 0);
+    tt_uint_op(emulator.num_syncs, ==, 1);
+
+end:
+    PBIO_OS_ASYNC_END(PBIO_SUCCESS);
+}
+
+static pbio_error_t test_emulated_combi_mode(pbio_os_state_t *state, void *context) {
+
+    static pbio_os_state_t child;
+    static pbio_port_lump_dev_t *lump_dev;
+    static pbio_error_t err;
+    static uint32_t start;
+    static uint32_t time;
+    static uint32_t count;
+    static uint32_t last_count;
+    static uint8_t *data;
+
+    PBIO_OS_ASYNC_BEGIN(state);
+
+    EMULATE_DEVICE(&pbdrv_lump_emulator_color_distance_sensor);
+
+    // RGB values in mode 6 and proximity in mode 1.
+    static const uint8_t rgb[] = { 1, 0, 2, 0, 3, 0 };
+    memcpy(emulator.data[6], rgb, sizeof(rgb));
+    emulator.data[1][0] = 42;
+
+    // Data of mode 6 by itself has the same padded size as the combined
+    // data, so stream it first to make sure it is not taken as such.
+    tt_uint_op(pbio_port_lump_set_mode(lump_dev, 6), ==, PBIO_SUCCESS);
+    EMULATOR_AWAIT_UNTIL(pbio_port_lump_is_ready(lump_dev) == PBIO_SUCCESS);
+
+    static const uint8_t combi[] = { 6, 1 };
+    pbio_port_lump_get_data_time(lump_dev, &time, &last_count);
+    tt_uint_op(pbio_port_lump_set_combi_mode(lump_dev, combi, PBIO_ARRAY_SIZE(combi)), ==, PBIO_SUCCESS);
+
+    // All data taken as combined data has the values of both modes, also
+    // while waiting for stale data to be discarded.
+    start = pbdrv_clock_get_ms();
+    while (pbdrv_clock_get_ms() - start < 200) {
+        EMULATOR_AWAIT_UNTIL(({
+            pbio_port_lump_get_data_time(lump_dev, &time, &count);
+            count != last_count || pbdrv_clock_get_ms() - start >= 200;
+        }));
+        last_count = count;
+        err = pbio_port_lump_get_data(lump_dev, PBIO_PORT_LUMP_MODE_COMBI, (void **)&data);
+        if (err == PBIO_ERROR_INVALID_OP) {
+            continue;
+        }
+        tt_int_op(memcmp(data, rgb, sizeof(rgb)), ==, 0);
+        tt_uint_op(data[6], ==, 42);
+    }
+    tt_uint_op(pbio_port_lump_is_ready(lump_dev), ==, PBIO_SUCCESS);
+    tt_uint_op(emulator.mode, ==, 6);
+    tt_uint_op(emulator.combi_num_values, >=, 4);
+
+    // Selecting a single mode ends the combination on both sides.
+    tt_uint_op(pbio_port_lump_set_mode(lump_dev, 1), ==, PBIO_SUCCESS);
+    EMULATOR_AWAIT_UNTIL(pbio_port_lump_is_ready(lump_dev) == PBIO_SUCCESS);
+    tt_uint_op(emulator.mode, ==, 1);
+    tt_uint_op(emulator.combi_num_values, ==, 0);
+    tt_uint_op(pbio_port_lump_get_data(lump_dev, 1, (void **)&data), ==, PBIO_SUCCESS);
+    tt_uint_op(data[0], ==, 42);
+
+end:
+    PBIO_OS_ASYNC_END(PBIO_SUCCESS);
+}
+
+/**
+ * Benchmarks of the hub side of the LUMP protocol, talking to an emulated
+ * device. Times include the emulated device and one pass of the event loop
+ * for each simulated millisecond. Registered in test_benchmark.c.
+ */
+pbio_error_t bench_lump(pbio_os_state_t *state, void *context) {
+
+    static pbio_os_state_t child;
+    static pbio_port_lump_dev_t *lump_dev;
+    static pbio_error_t err;
+    static benchmark_t bench;
+    static uint32_t time;
+    static uint32_t count_start;
+    static uint32_t count;
+    static uint32_t i;
+
+    PBIO_OS_ASYNC_BEGIN(state);
+
+    EMULATE_DEVICE(&pbdrv_lump_emulator_spike_color_sensor);
+
+    // Receiving the data of the largest mode, as fast as the line allows.
+    // Each message takes a few simulated milliseconds, so do fewer than
+    // the other benchmarks to stay within the test timeout.
+    tt_uint_op(pbio_port_lump_set_mode(lump_dev, 5), ==, PBIO_SUCCESS);
+    EMULATOR_AWAIT_UNTIL(pbio_port_lump_is_ready(lump_dev) == PBIO_SUCCESS);
+    emulator.data_interval = 2;
+    pbio_port_lump_get_data_time(lump_dev, &time, &count_start);
+    benchmark_start(&bench, "lump_data");
+    bench.iterations /= 10;
+    EMULATOR_AWAIT_UNTIL(({
+        pbio_port_lump_get_data_time(lump_dev, &time, &count);
+        count - count_start >= bench.iterations;
+    }));
+    tt_want(benchmark_end(&bench));
+
+    // Switching back and forth between two modes, until data of the new
+    // mode is received.
+    emulator.data_interval = pbdrv_lump_emulator_spike_color_sensor.data_interval;
+    benchmark_start(&bench, "lump_mode_switch");
+    bench.iterations /= 100;
+    for (i = 0; i < bench.iterations; i++) {
+        tt_uint_op(pbio_port_lump_set_mode(lump_dev, i % 2), ==, PBIO_SUCCESS);
+        EMULATOR_AWAIT_UNTIL(pbio_port_lump_is_ready(lump_dev) == PBIO_SUCCESS);
+    }
+    tt_want(benchmark_end(&bench));
+    tt_uint_op(emulator.num_syncs, ==, 1);
+
 end:
     PBIO_OS_ASYNC_END(PBIO_SUCCESS);
 }
@@ -1084,6 +1603,11 @@ struct testcase_t pbio_port_lump_tests[] = {
     PBIO_PT_THREAD_TEST_WITH_PBIO_OS(test_boost_interactive_motor),
     PBIO_PT_THREAD_TEST_WITH_PBIO_OS(test_technic_large_motor),
     PBIO_PT_THREAD_TEST_WITH_PBIO_OS(test_technic_xl_motor),
+    PBIO_PT_THREAD_TEST_WITH_PBIO_OS(test_emulated_devices),
+    PBIO_PT_THREAD_TEST_WITH_PBIO_OS(test_emulated_fast_baud_not_supported),
+    PBIO_PT_THREAD_TEST_WITH_PBIO_OS(test_emulated_mode_switch_and_bad_data),
+    PBIO_PT_THREAD_TEST_WITH_PBIO_OS(test_emulated_data_rate),
+    PBIO_PT_THREAD_TEST_WITH_PBIO_OS(test_emulated_combi_mode),
     END_OF_TESTCASES
 };
 
@@ -1100,6 +1624,10 @@ void pbdrv_uart_set_baud_rate(pbdrv_uart_dev_t *uart_dev, uint32_t baud) {
 }
 
 void pbdrv_uart_flush(pbdrv_uart_dev_t *uart_dev) {
+    // Like the real drivers, clear operations left by exited processes.
+    uart_dev->rx_msg = NULL;
+    uart_dev->rx_msg_any_length = false;
+    uart_dev->tx_msg = NULL;
 }
 
 extern bool pbio_lump_dev_test_process_auto_start;
@@ -1134,6 +1662,32 @@ pbio_error_t pbdrv_uart_read(pbio_os_state_t *state, pbdrv_uart_dev_t *uart_dev,
     PBIO_OS_ASYNC_END(uart_dev->rx_msg_result);
 }
 
+pbio_error_t pbdrv_uart_read_available(pbio_os_state_t *state, pbdrv_uart_dev_t *uart_dev, uint8_t *msg, uint8_t length, uint8_t *size, uint32_t timeout) {
+
+    PBIO_OS_ASYNC_BEGIN(state);
+
+    PBIO_OS_AWAIT_WHILE(state, uart_dev->rx_msg);
+
+    uart_dev->rx_msg = msg;
+    uart_dev->rx_msg_length = length;
+    uart_dev->rx_msg_any_length = true;
+    uart_dev->rx_msg_received = 0;
+    uart_dev->rx_msg_result = PBIO_ERROR_AGAIN;
+    pbio_os_timer_set(&uart_dev->rx_timer, timeout);
+
+    // Completes as soon as any data was received
+    PBIO_OS_AWAIT_WHILE(state, uart_dev->rx_msg_result == PBIO_ERROR_AGAIN && !pbio_os_timer_is_expired(&uart_dev->rx_timer));
+    if (pbio_os_timer_is_expired(&uart_dev->rx_timer)) {
+        uart_dev->rx_msg_result = PBIO_ERROR_TIMEDOUT;
+    }
+
+    uart_dev->rx_msg = NULL;
+    uart_dev->rx_msg_any_length = false;
+    *size = uart_dev->rx_msg_received;
+
+    PBIO_OS_ASYNC_END(uart_dev->rx_msg_result);
+}
+
 pbio_error_t pbdrv_uart_write(pbio_os_state_t *state, pbdrv_uart_dev_t *uart_dev, uint8_t *msg, uint8_t length, uint32_t timeout) {
 
     PBIO_OS_ASYNC_BEGIN(state);
@@ -3,6 +3,7 @@
 
 #include <stdbool.h>
 #include <stdio.h>
+#include <string.h>
 
 #include <btstack.h>
 #include <contiki.h>
@@ -103,6 +104,166 @@ static PT_THREAD(test_bluetooth(struct pt *pt)) {
         pbio_test_bluetooth_get_pybricks_service_notification_count() != count;
     }));
 
+    // app data frames are read in order and a resent frame is only queued once
+    pbsys_bluetooth_app_data_set_enabled(true);
+
+    static const uint8_t test_frame_1[] = { PBIO_PYBRICKS_COMMAND_WRITE_APP_DATA_FRAME, 0, 1, 2 };
+    static const uint8_t test_frame_2[] = { PBIO_PYBRICKS_COMMAND_WRITE_APP_DATA_FRAME, 1, 3 };
+    pbio_test_bluetooth_send_pybricks_command(test_frame_1, sizeof(test_frame_1));
+    pbio_test_bluetooth_send_pybricks_command(test_frame_1, sizeof(test_frame_1));
+    pbio_test_bluetooth_send_pybricks_command(test_frame_2, sizeof(test_frame_2));
+
+    PT_WAIT_UNTIL(pt, ({
+        pbio_test_clock_tick(1);
+        size = PBIO_ARRAY_SIZE(rx_data);
+        pbsys_bluetooth_app_data_rx(rx_data, &size) == PBIO_SUCCESS;
+    }));
+
+    tt_want_uint_op(size, ==, 2);
+    tt_want_uint_op(rx_data[0], ==, 1);
+    tt_want_uint_op(rx_data[1], ==, 2);
+
+    PT_WAIT_UNTIL(pt, ({
+        pbio_test_clock_tick(1);
+        size = PBIO_ARRAY_SIZE(rx_data);
+        pbsys_bluetooth_app_data_rx(rx_data, &size) == PBIO_SUCCESS;
+    }));
+
+    tt_want_uint_op(size, ==, 1);
+    tt_want_uint_op(rx_data[0], ==, 3);
+
+    size = PBIO_ARRAY_SIZE(rx_data);
+    tt_want_int_op(pbsys_bluetooth_app_data_rx(rx_data, &size), ==, PBIO_ERROR_AGAIN);
+
+    // reading frames gives the host its credits back, even though there are
+    // no frames to send to the host
+    static uint8_t event[HCI_ACL_PAYLOAD_SIZE];
+    static uint32_t event_size;
+
+    PT_WAIT_UNTIL(pt, ({
+        pbio_test_clock_tick(1);
+        event_size = pbio_test_bluetooth_take_pybricks_service_event(PBIO_PYBRICKS_EVENT_WRITE_APP_DATA_FRAMES, event);
+        event_size == 4 && event[3] == 40;
+    }));
+
+    tt_want_uint_op(event[2], ==, 1);
+
+    // frames sent to the host before the process runs are combined into one
+    // notification with a header and a size before each frame
+
+    static const uint8_t tx_frame_1[] = { 4, 5 };
+    static const uint8_t tx_frame_2[] = { 6 };
+    tt_want_int_op(pbsys_bluetooth_app_data_tx(tx_frame_1, sizeof(tx_frame_1)), ==, PBIO_SUCCESS);
+    tt_want_int_op(pbsys_bluetooth_app_data_tx(tx_frame_2, sizeof(tx_frame_2)), ==, PBIO_SUCCESS);
+
+    PT_WAIT_UNTIL(pt, ({
+        pbio_test_clock_tick(1);
+        event_size = pbio_test_bluetooth_take_pybricks_service_event(PBIO_PYBRICKS_EVENT_WRITE_APP_DATA_FRAMES, event);
+    }));
+
+    {
+        static const uint8_t expected[] = {
+            PBIO_PYBRICKS_EVENT_WRITE_APP_DATA_FRAMES,
+            0, // sequence of first frame
+            1, // last accepted host sequence
+            40, // credits: whole receive queue is free
+            2, 4, 5,
+            1, 6,
+        };
+        tt_want_uint_op(event_size, ==, sizeof(expected));
+        tt_want_int_op(memcmp(event, expected, sizeof(expected)), ==, 0);
+    }
+
+    // credits go down as the receive queue fills up until the host gets BUSY
+    static const uint8_t rx_frame[9];
+    tt_want_int_op(pbsys_bluetooth_app_data_rx_write(2, rx_frame, sizeof(rx_frame)), ==, PBIO_SUCCESS);
+    tt_want_int_op(pbsys_bluetooth_app_data_rx_write(3, rx_frame, sizeof(rx_frame)), ==, PBIO_SUCCESS);
+    tt_want_int_op(pbsys_bluetooth_app_data_rx_write(4, rx_frame, sizeof(rx_frame)), ==, PBIO_SUCCESS);
+    tt_want_int_op(pbsys_bluetooth_app_data_tx(tx_frame_2, sizeof(tx_frame_2)), ==, PBIO_SUCCESS);
+
+    PT_WAIT_UNTIL(pt, ({
+        pbio_test_clock_tick(1);
+        event_size = pbio_test_bluetooth_take_pybricks_service_event(PBIO_PYBRICKS_EVENT_WRITE_APP_DATA_FRAMES, event);
+    }));
+
+    tt_want_uint_op(event_size, ==, 6);
+    tt_want_uint_op(event[1], ==, 2);
+    tt_want_uint_op(event[2], ==, 4);
+    tt_want_uint_op(event[3], ==, 10);
+
+    tt_want_int_op(pbsys_bluetooth_app_data_rx_write(5, rx_frame, sizeof(rx_frame)), ==, PBIO_SUCCESS);
+    tt_want_int_op(pbsys_bluetooth_app_data_rx_write(6, rx_frame, sizeof(rx_frame)), ==, PBIO_ERROR_BUSY);
+    tt_want_int_op(pbsys_bluetooth_app_data_tx(tx_frame_2, sizeof(tx_frame_2)), ==, PBIO_SUCCESS);
+
+    PT_WAIT_UNTIL(pt, ({
+        pbio_test_clock_tick(1);
+        event_size = pbio_test_bluetooth_take_pybricks_service_event(PBIO_PYBRICKS_EVENT_WRITE_APP_DATA_FRAMES, event);
+    }));
+
+    tt_want_uint_op(event[1], ==, 3);
+    tt_want_uint_op(event[2], ==, 5);
+    tt_want_uint_op(event[3], ==, 0);
+
+    // reading a frame makes room for the frame that was refused
+    size = PBIO_ARRAY_SIZE(rx_data);
+    tt_want_int_op(pbsys_bluetooth_app_data_rx(rx_data, &size), ==, PBIO_SUCCESS);
+    tt_want_uint_op(size, ==, sizeof(rx_frame));
+    tt_want_int_op(pbsys_bluetooth_app_data_rx_write(6, rx_frame, sizeof(rx_frame)), ==, PBIO_SUCCESS);
+
+    // frames to the host that don't fit in one notification are refused, and
+    // the transmit queue only has room for two of the biggest frames
+    static uint8_t tx_frame_max[15];
+    tt_want_uint_op(pbsys_bluetooth_app_data_tx_get_max_size(), ==, sizeof(tx_frame_max));
+    tt_want_int_op(pbsys_bluetooth_app_data_tx(tx_frame_max, sizeof(tx_frame_max) + 1), ==, PBIO_ERROR_INVALID_ARG);
+
+    tx_frame_max[0] = 1;
+    tt_want_int_op(pbsys_bluetooth_app_data_tx(tx_frame_max, sizeof(tx_frame_max)), ==, PBIO_SUCCESS);
+    tx_frame_max[0] = 2;
+    tt_want_int_op(pbsys_bluetooth_app_data_tx(tx_frame_max, sizeof(tx_frame_max)), ==, PBIO_SUCCESS);
+    tx_frame_max[0] = 3;
+    tt_want_int_op(pbsys_bluetooth_app_data_tx(tx_frame_max, sizeof(tx_frame_max)), ==, PBIO_ERROR_AGAIN);
+
+    // each biggest frame fills a notification on its own
+    PT_WAIT_UNTIL(pt, ({
+        pbio_test_clock_tick(1);
+        event_size = pbio_test_bluetooth_take_pybricks_service_event(PBIO_PYBRICKS_EVENT_WRITE_APP_DATA_FRAMES, event);
+    }));
+
+    tt_want_uint_op(event_size, ==, 4 + 1 + sizeof(tx_frame_max));
+    tt_want_uint_op(event[1], ==, 4);
+    tt_want_uint_op(event[2], ==, 6);
+    tt_want_uint_op(event[4], ==, sizeof(tx_frame_max));
+    tt_want_uint_op(event[5], ==, 1);
+
+    PT_WAIT_UNTIL(pt, ({
+        pbio_test_clock_tick(1);
+        event_size = pbio_test_bluetooth_take_pybricks_service_event(PBIO_PYBRICKS_EVENT_WRITE_APP_DATA_FRAMES, event);
+    }));
+
+    tt_want_uint_op(event_size, ==, 4 + 1 + sizeof(tx_frame_max));
+    tt_want_uint_op(event[1], ==, 5);
+    tt_want_uint_op(event[5], ==, 2);
+
+    // once sent, there is room again
+    tx_frame_max[0] = 3;
+    tt_want_int_op(pbsys_bluetooth_app_data_tx(tx_frame_max, sizeof(tx_frame_max)), ==, PBIO_SUCCESS);
+
+    PT_WAIT_UNTIL(pt, ({
+        pbio_test_clock_tick(1);
+        event_size = pbio_test_bluetooth_take_pybricks_service_event(PBIO_PYBRICKS_EVENT_WRITE_APP_DATA_FRAMES, event);
+    }));
+
+    tt_want_uint_op(event[1], ==, 6);
+    tt_want_uint_op(event[5], ==, 3);
+
+    // disabling discards queued frames from the host
+    pbsys_bluetooth_app_data_set_enabled(false);
+    pbsys_bluetooth_app_data_set_enabled(true);
+    size = PBIO_ARRAY_SIZE(rx_data);
+    tt_want_int_op(pbsys_bluetooth_app_data_rx(rx_data, &size), ==, PBIO_ERROR_AGAIN);
+
+    pbsys_bluetooth_app_data_set_enabled(false);
+
     PT_END(pt);
 }
 
@@ -0,0 +1,197 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2025 The Pybricks Authors
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <contiki.h>
+#include <tinytest.h>
+#include <tinytest_macros.h>
+
+#include <pbio/error.h>
+#include <pbsys/main.h>
+#include <pbsys/storage.h>
+#include <test-pbio.h>
+
+#include "../../drv/block_device/block_device_test.h"
+#include "../../sys/core.h"
+#include "../../sys/storage.h"
+
+#define BLOCK_SIZE (1024)
+#define NUM_BLOCKS (PBDRV_CONFIG_BLOCK_DEVICE_TEST_SIZE / BLOCK_SIZE)
+
+// Spans a few blocks, after the header in the first block.
+#define PROGRAM_SIZE (2500)
+
+// The program is stored just after the user data, settings and slot info.
+#define PROGRAM_OFFSET (PBSYS_CONFIG_STORAGE_USER_DATA_SIZE + 8 + sizeof(pbsys_storage_settings_t) + 8)
+
+static uint8_t program[PROGRAM_SIZE];
+static const uint8_t user_data[] = { 0x12, 0x34, 0x56, 0x78 };
+static uint32_t erase_count[NUM_BLOCKS];
+
+static void make_program(uint8_t seed) {
+    for (uint32_t i = 0; i < sizeof(program); i++) {
+        program[i] = i * seed;
+    }
+}
+
+static void store_program(void) {
+    tt_want_uint_op(pbsys_storage_set_program_size(0), ==, PBIO_SUCCESS);
+    tt_want_uint_op(pbsys_storage_set_program_data(0, program, sizeof(program)), ==, PBIO_SUCCESS);
+    tt_want_uint_op(pbsys_storage_set_program_size(sizeof(program)), ==, PBIO_SUCCESS);
+}
+
+/**
+ * Saves the data and loads it again, like restarting the hub.
+ */
+static PT_THREAD(reload(struct pt *pt)) {
+    PT_BEGIN(pt);
+
+    for (uint32_t block = 0; block < NUM_BLOCKS; block++) {
+        erase_count[block] = pbdrv_block_device_test_get_erase_count(block * BLOCK_SIZE);
+    }
+
+    pbsys_storage_deinit();
+    PT_WAIT_WHILE(pt, pbsys_init_busy());
+
+    pbsys_storage_init();
+    PT_WAIT_WHILE(pt, pbsys_init_busy());
+
+    PT_END(pt);
+}
+
+/**
+ * Checks that the last reload rewrote only blocks @p first to @p last.
+ */
+static void want_rewritten_blocks(uint32_t first, uint32_t last) {
+    for (uint32_t block = 0; block < NUM_BLOCKS; block++) {
+        uint32_t expected = erase_count[block] + (block >= first && block <= last);
+        tt_want_uint_op(pbdrv_block_device_test_get_erase_count(block * BLOCK_SIZE), ==, expected);
+    }
+}
+
+static void want_user_data(void) {
+    uint8_t *data;
+    tt_want_uint_op(pbsys_storage_get_user_data(10, &data, sizeof(user_data)), ==, PBIO_SUCCESS);
+    tt_want(memcmp(data, user_data, sizeof(user_data)) == 0);
+}
+
+static void want_program(void) {
+    pbsys_main_program_t info = { .id = 0 };
+    pbsys_storage_get_program_data(&info);
+    tt_want_uint_op((uint8_t *)info.code_end - (uint8_t *)info.code_start, ==, sizeof(program));
+    tt_want(memcmp(info.code_start, program, sizeof(program)) == 0);
+}
+
+/**
+ * Loads storage and saves a program and user data as the starting point.
+ */
+static PT_THREAD(load_initial_data(struct pt *pt)) {
+    static struct pt child;
+
+    PT_BEGIN(pt);
+
+    pbsys_storage_init();
+    PT_WAIT_WHILE(pt, pbsys_init_busy());
+
+    make_program(3);
+    store_program();
+    tt_want_uint_op(pbsys_storage_set_user_data(10, user_data, sizeof(user_data)), ==, PBIO_SUCCESS);
+
+    PT_SPAWN(pt, &child, reload(&child));
+    want_user_data();
+    want_program();
+
+    PT_END(pt);
+}
+
+static PT_THREAD(test_storage_user_data(struct pt *pt)) {
+    static struct pt child;
+    static const uint8_t new_data[] = { 0xAB, 0xCD };
+
+    PT_BEGIN(pt);
+
+    PT_SPAWN(pt, &child, load_initial_data(&child));
+
+    // Nothing is written if nothing changed.
+    PT_SPAWN(pt, &child, reload(&child));
+    want_rewritten_blocks(1, 0);
+
+    // Changing user data rewrites only the first block.
+    tt_want_uint_op(pbsys_storage_set_user_data(100, new_data, sizeof(new_data)), ==, PBIO_SUCCESS);
+    PT_SPAWN(pt, &child, reload(&child));
+    want_rewritten_blocks(0, 0);
+
+    uint8_t *data;
+    tt_want_uint_op(pbsys_storage_get_user_data(100, &data, sizeof(new_data)), ==, PBIO_SUCCESS);
+    tt_want(memcmp(data, new_data, sizeof(new_data)) == 0);
+    want_user_data();
+    want_program();
+
+    // User data can't be written beyond the user data area.
+    tt_want_uint_op(pbsys_storage_set_user_data(PBSYS_CONFIG_STORAGE_USER_DATA_SIZE - 1, new_data, sizeof(new_data)), ==, PBIO_ERROR_INVALID_ARG);
+
+    PT_END(pt);
+}
+
+static PT_THREAD(test_storage_settings(struct pt *pt)) {
+    static struct pt child;
+    static uint32_t flags;
+
+    PT_BEGIN(pt);
+
+    PT_SPAWN(pt, &child, load_initial_data(&child));
+
+    // Changing settings rewrites only the first block.
+    pbsys_storage_settings_get_settings()->flags ^= PBSYS_STORAGE_SETTINGS_FLAGS_BLUETOOTH_ENABLED;
+    flags = pbsys_storage_settings_get_settings()->flags;
+    pbsys_storage_request_write();
+    PT_SPAWN(pt, &child, reload(&child));
+    want_rewritten_blocks(0, 0);
+
+    tt_want_uint_op(pbsys_storage_settings_get_settings()->flags, ==, flags);
+    want_user_data();
+    want_program();
+
+    PT_END(pt);
+}
+
+static PT_THREAD(test_storage_program_data(struct pt *pt)) {
+    static struct pt child;
+
+    PT_BEGIN(pt);
+
+    PT_SPAWN(pt, &child, load_initial_data(&child));
+
+    // A new program rewrites the header and the blocks with the program.
+    make_program(5);
+    store_program();
+    PT_SPAWN(pt, &child, reload(&child));
+    want_rewritten_blocks(0, (PROGRAM_OFFSET + PROGRAM_SIZE - 1) / BLOCK_SIZE);
+
+    want_user_data();
+    want_program();
+
+    // The program is executed in place now, but it can still be read from
+    // just after the user data, settings and slot info.
+    uint32_t program_offset = PROGRAM_OFFSET;
+    uint8_t *data;
+    tt_want_uint_op(pbsys_storage_get_user_data(program_offset, &data, sizeof(program)), ==, PBIO_SUCCESS);
+    tt_want(memcmp(data, program, sizeof(program)) == 0);
+
+    // Reading the program together with the settings is not possible.
+    tt_want_uint_op(pbsys_storage_get_user_data(program_offset - 4, &data, 8), ==, PBIO_ERROR_NOT_SUPPORTED);
+    tt_want_uint_op(pbsys_storage_get_user_data(program_offset, &data, sizeof(program) + 1), ==, PBIO_ERROR_INVALID_ARG);
+
+    PT_END(pt);
+}
+
+struct testcase_t pbsys_storage_tests[] = {
+    PBIO_PT_THREAD_TEST(test_storage_user_data),
+    PBIO_PT_THREAD_TEST(test_storage_settings),
+    PBIO_PT_THREAD_TEST(test_storage_program_data),
+    END_OF_TESTCASES
+};
@@ -143,10 +143,15 @@ struct testcase_setup_t pbio_test_setup = {
     .cleanup_fn = cleanup,
 };
 
+extern struct testcase_t pbdrv_block_device_tests[];
 extern struct testcase_t pbdrv_bluetooth_tests[];
 extern struct testcase_t pbdrv_pwm_tests[];
+extern struct testcase_t pbdrv_virtual_replay_tests[];
 extern struct testcase_t pbio_angle_tests[];
 extern struct testcase_t pbio_battery_tests[];
+extern struct testcase_t pbio_benchmark_tests[];
+extern struct testcase_t pbio_broadcast_tests[];
+extern struct testcase_t pbio_clock_sync_tests[];
 extern struct testcase_t pbio_color_tests[];
 extern struct testcase_t pbio_drivebase_tests[];
 extern struct testcase_t pbio_light_animation_tests[];
@@ -160,11 +165,17 @@ extern struct testcase_t pbio_trajectory_tests[];
 extern struct testcase_t pbio_util_tests[];
 extern struct testcase_t pbsys_bluetooth_tests[];
 extern struct testcase_t pbsys_status_tests[];
+extern struct testcase_t pbsys_storage_tests[];
 static struct testgroup_t test_groups[] = {
+    { "drv/block_device/", pbdrv_block_device_tests },
     { "drv/bluetooth/", pbdrv_bluetooth_tests },
     { "drv/pwm/", pbdrv_pwm_tests },
+    { "drv/virtual_replay/", pbdrv_virtual_replay_tests },
     { "src/angle/", pbio_angle_tests },
     { "src/battery/", pbio_battery_tests },
+    { "src/benchmark/", pbio_benchmark_tests },
+    { "src/broadcast/", pbio_broadcast_tests },
+    { "src/clock_sync/", pbio_clock_sync_tests },
     { "src/color/", pbio_color_tests },
     { "src/drivebase/", pbio_drivebase_tests },
     { "src/light/", pbio_light_animation_tests },
@@ -178,6 +189,7 @@ static struct testgroup_t test_groups[] = {
     { "src/util/", pbio_util_tests, },
     { "sys/bluetooth/", pbsys_bluetooth_tests, },
     { "sys/status/", pbsys_status_tests, },
+    { "sys/storage/", pbsys_storage_tests, },
     END_OF_GROUPS
 };
 
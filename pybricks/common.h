@@ -31,6 +31,7 @@ void pb_package_pybricks_deinit(void);
 #if PYBRICKS_PY_COMMON_BLE
 mp_obj_t pb_type_BLE_new(mp_obj_t broadcast_channel_in, mp_obj_t observe_channels_in);
 void pb_type_ble_start_cleanup(void);
+bool pb_type_ble_get_synced_time(uint32_t *time);
 #endif
 
 #if PYBRICKS_PY_COMMON_CHARGER
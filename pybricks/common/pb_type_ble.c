@@ -10,6 +10,9 @@
 #include <string.h>
 
 #include <pbdrv/bluetooth.h>
+#include <pbio/broadcast.h>
+#include <pbio/clock_sync.h>
+#include <pbio/os.h>
 
 #include <pbsys/config.h>
 #include <pbsys/storage_settings.h>
@@ -21,6 +24,7 @@
 
 #include <pybricks/common.h>
 #include <pybricks/tools.h>
+#include <pybricks/tools/pb_type_awaitable.h>
 #include <pybricks/util_mp/pb_kwarg_helper.h>
 #include <pybricks/util_pb/pb_error.h>
 
@@ -34,19 +38,48 @@
 #define RSSI_FILTER_WINDOW_MS (512)
 
 #define OBSERVED_DATA_TIMEOUT_MS (1000)
-#define OBSERVED_DATA_MAX_SIZE (31 /* max adv data size */ - 5 /* overhead */)
+#define OBSERVED_DATA_MAX_SIZE (PBIO_BROADCAST_ADV_DATA_MAX_SIZE)
+
+// Payloads that do not fit in one advertisement are split into fragments,
+// which are broadcast one after the other.
+#define BROADCAST_DATA_MAX_SIZE (PBIO_BROADCAST_DATA_MAX_SIZE)
+
+// Fragments have to stay on air for at least one advertising interval of the
+// slowest Bluetooth driver, or observers may never see some of them.
+#define BROADCAST_INTERVAL_MIN_MS (100)
+
+// The time sync leader includes its clock in front of the broadcast payload.
+#define BROADCAST_TIME_HEADER_SIZE (1 + sizeof(uint32_t))
 
 typedef struct {
     uint32_t timestamp;
     uint8_t channel;
     int8_t rssi;
-    uint8_t size;
-    uint8_t data[OBSERVED_DATA_MAX_SIZE];
+    /** Last payload received on this channel. */
+    pbio_broadcast_received_t received;
 } observed_data_t;
 
 // pointer to dynamically allocated memory - needed for driver callback
 static observed_data_t *observed_data;
 static uint8_t num_observed_data;
+// Maps channel number to index in observed_data plus one, or 0 if the channel
+// is not observed. This avoids searching the table for each advertisement.
+static uint8_t *observed_data_index;
+
+/**
+ * State of the clock synchronization with a leader hub.
+ */
+typedef struct {
+    /** This hub is the leader and shares its own clock. */
+    bool leader;
+    /** This hub follows the clock received on @p channel. */
+    bool follower;
+    uint8_t channel;
+    /** Estimate of the leader clock, if following. */
+    pbio_clock_sync_t clock;
+} time_sync_t;
+
+static time_sync_t time_sync;
 
 static pbio_task_t broadcast_task;
 static pbio_task_t toggle_observe_task;
@@ -54,6 +87,7 @@ static pbio_task_t toggle_observe_task;
 typedef struct {
     mp_obj_base_t base;
     mp_obj_t broadcast_channel;
+    uint8_t observed_data_index[UINT8_MAX + 1];
     observed_data_t observed_data[];
 } pb_obj_BLE_t;
 
@@ -78,6 +112,8 @@ typedef enum {
     PB_BLE_BROADCAST_DATA_TYPE_STR = 5,
     /** The Python @c bytes type. */
     PB_BLE_BROADCAST_DATA_TYPE_BYTES = 6,
+    /** Indicator that this advertisement is one fragment of a larger payload. See pbio/broadcast.h. */
+    PB_BLE_BROADCAST_DATA_TYPE_FRAGMENT = PBIO_BROADCAST_FRAGMENT_TYPE,
 } pb_ble_broadcast_data_type_t;
 
 #define MFG_SPECIFIC 0xFF
@@ -91,15 +127,11 @@ typedef enum {
  *                          is not allocated in the table.
  */
 static observed_data_t *lookup_observed_data(uint8_t channel) {
-    for (size_t i = 0; i < num_observed_data; i++) {
-        observed_data_t *data = &observed_data[i];
-
-        if (data->channel == channel) {
-            return data;
-        }
+    if (!observed_data_index || !observed_data_index[channel]) {
+        return NULL;
     }
 
-    return NULL;
+    return &observed_data[observed_data_index[channel] - 1];
 }
 
 /**
@@ -138,9 +170,24 @@ static void handle_observe_event(pbdrv_bluetooth_ad_type_t event_type, const uin
         // Update moving RSSI average based on time difference.
         ch_data->rssi = (ch_data->rssi * (RSSI_FILTER_WINDOW_MS - diff) + rssi * diff) / RSSI_FILTER_WINDOW_MS;
 
+        uint8_t size = data[0] - 4;
+        const uint8_t *payload = &data[5];
+
+        if (size > OBSERVED_DATA_MAX_SIZE) {
+            return;
+        }
+
+        // Take the time from the leader and strip it from the data.
+        if (size >= BROADCAST_TIME_HEADER_SIZE && payload[0] == (PB_BLE_BROADCAST_DATA_TYPE_SINGLE_OBJECT << 5 | sizeof(uint32_t))) {
+            if (time_sync.follower && channel == time_sync.channel) {
+                pbio_clock_sync_update(&time_sync.clock, pbio_get_uint32_le(&payload[1]), ch_data->timestamp);
+            }
+            size -= BROADCAST_TIME_HEADER_SIZE;
+            payload += BROADCAST_TIME_HEADER_SIZE;
+        }
+
         // Extract user broadcast data from signal.
-        ch_data->size = data[0] - 4;
-        memcpy(ch_data->data, &data[5], OBSERVED_DATA_MAX_SIZE);
+        pbio_broadcast_receive(&ch_data->received, payload, size);
     }
 }
 
@@ -158,8 +205,8 @@ static void handle_observe_event(pbdrv_bluetooth_ad_type_t event_type, const uin
 static size_t pb_module_ble_append(uint8_t *dst, size_t index, const void *src, size_t size, pb_ble_broadcast_data_type_t type) {
     size_t next_index = index + size + 1;
 
-    if (next_index > OBSERVED_DATA_MAX_SIZE) {
-        mp_raise_ValueError(MP_ERROR_TEXT("payload limited to 26 bytes"));
+    if (next_index > BROADCAST_DATA_MAX_SIZE) {
+        mp_raise_ValueError(MP_ERROR_TEXT("payload limited to 92 bytes"));
     }
 
     dst[index] = type << 5 | size;
@@ -242,12 +289,155 @@ static size_t pb_module_ble_encode(void *dst, size_t index, mp_obj_t arg) {
     MP_UNREACHABLE
 }
 
+typedef struct {
+    pbdrv_bluetooth_value_t v;
+    uint8_t d[5 + OBSERVED_DATA_MAX_SIZE];
+} broadcast_value_t;
+
+// Advertising data for each fragment of the current broadcast.
+static broadcast_value_t broadcast_values[PBIO_BROADCAST_FRAGMENTS_MAX];
+static uint8_t broadcast_num_fragments;
+static uint8_t broadcast_sequence;
+static uint32_t broadcast_interval;
+static pbio_os_process_t broadcast_process;
+static bool broadcast_process_started;
+static uint8_t broadcast_payload[BROADCAST_DATA_MAX_SIZE];
+static size_t broadcast_payload_size;
+
+/**
+ * Sets the current time in an advertisement of the time sync leader.
+ *
+ * @param [in]  value       The advertisement with a time header.
+ */
+static void pb_module_ble_set_broadcast_time(broadcast_value_t *value) {
+    pbio_set_uint32_le(&value->d[6], mp_hal_ticks_ms());
+}
+
+/**
+ * Sets the advertising data for one broadcast advertisement.
+ *
+ * @param [in]  value       The value to set.
+ * @param [in]  channel     The broadcast channel.
+ * @param [in]  header      Fragment or time sync header.
+ * @param [in]  header_size The size of @p header, or 0 if there is none.
+ * @param [in]  data        The encoded payload.
+ * @param [in]  size        The size of @p data.
+ */
+static void pb_module_ble_set_broadcast_value(broadcast_value_t *value, uint8_t channel, const uint8_t *header, size_t header_size, const uint8_t *data, size_t size) {
+    value->v.size = header_size + size + 5;
+    value->d[0] = header_size + size + 4; // length
+    value->d[1] = MFG_SPECIFIC;
+    pbio_set_uint16_le(&value->d[2], LEGO_CID);
+    value->d[4] = channel;
+    memcpy(&value->d[5], header, header_size);
+    memcpy(&value->d[5 + header_size], data, size);
+}
+
+/**
+ * Process that broadcasts each fragment of a fragmented payload in turn.
+ *
+ * The first fragment is broadcast by pb_module_ble_broadcast(). This process
+ * stops once the payload is no longer fragmented, unless this hub is the time
+ * sync leader. Then it keeps refreshing the time in the broadcast.
+ *
+ * Only one advertisement update is queued at a time. The interval starts once
+ * the previous update is done, so slow radios are not flooded with updates.
+ */
+static pbio_error_t pb_module_ble_broadcast_process_thread(pbio_os_state_t *state, void *context) {
+    static pbio_os_timer_t timer;
+    static pbio_task_t task;
+    static uint8_t index;
+
+    PBIO_OS_ASYNC_BEGIN(state);
+
+    index = 0;
+
+    for (;;) {
+        PBIO_OS_AWAIT_MS(state, &timer, broadcast_interval);
+
+        // Don't queue another update while a new payload is being broadcast.
+        PBIO_OS_AWAIT_WHILE(state, broadcast_task.status == PBIO_ERROR_AGAIN);
+
+        // A single advertisement without time never changes, so there is
+        // nothing to update.
+        if (broadcast_num_fragments == 0 || (broadcast_num_fragments == 1 && !time_sync.leader)) {
+            break;
+        }
+
+        index = (index + 1) % broadcast_num_fragments;
+        if (time_sync.leader) {
+            pb_module_ble_set_broadcast_time(&broadcast_values[index]);
+        }
+        pbdrv_bluetooth_start_broadcasting(&task, &broadcast_values[index].v);
+        PBIO_OS_AWAIT_WHILE(state, task.status == PBIO_ERROR_AGAIN);
+    }
+
+    PBIO_OS_ASYNC_END(PBIO_SUCCESS);
+}
+
+/**
+ * Prepares the advertisements for the encoded broadcast payload and starts
+ * broadcasting the first one.
+ *
+ * @param [in]  self    The BLE object.
+ * @returns             Awaitable for broadcasting the first advertisement.
+ * @throws ValueError   If the payload is too big to include the time.
+ */
+static mp_obj_t pb_module_ble_broadcast_start(pb_obj_BLE_t *self) {
+    uint8_t channel = mp_obj_get_int(self->broadcast_channel);
+    size_t size = broadcast_payload_size;
+
+    if (time_sync.leader) {
+        // The time is refreshed before each advertisement, so it has to fit
+        // in one advertisement along with the payload.
+        if (size + BROADCAST_TIME_HEADER_SIZE > OBSERVED_DATA_MAX_SIZE) {
+            mp_raise_ValueError(MP_ERROR_TEXT("payload limited to 21 bytes when sharing time"));
+        }
+        uint8_t header[BROADCAST_TIME_HEADER_SIZE] = { PB_BLE_BROADCAST_DATA_TYPE_SINGLE_OBJECT << 5 | sizeof(uint32_t) };
+        broadcast_num_fragments = 1;
+        pb_module_ble_set_broadcast_value(&broadcast_values[0], channel, header, sizeof(header), broadcast_payload, size);
+        pb_module_ble_set_broadcast_time(&broadcast_values[0]);
+    } else if (size <= OBSERVED_DATA_MAX_SIZE) {
+        // Fits in one advertisement, so it can be read by older firmware too.
+        broadcast_num_fragments = 1;
+        pb_module_ble_set_broadcast_value(&broadcast_values[0], channel, NULL, 0, broadcast_payload, size);
+    } else {
+        broadcast_num_fragments = pbio_broadcast_get_num_fragments(size);
+        broadcast_sequence++;
+        for (uint8_t i = 0; i < broadcast_num_fragments; i++) {
+            uint8_t fragment[OBSERVED_DATA_MAX_SIZE];
+            size_t fragment_size = pbio_broadcast_get_fragment(broadcast_payload, size, broadcast_sequence, i, fragment);
+            pb_module_ble_set_broadcast_value(&broadcast_values[i], channel, NULL, 0, fragment, fragment_size);
+        }
+    }
+
+    // Broadcast the remaining fragments or refresh the time in the
+    // background. If it is still running, it continues with the new data.
+    if (broadcast_num_fragments > 1 || time_sync.leader) {
+        if (!broadcast_process_started) {
+            pbio_os_process_start(&broadcast_process, pb_module_ble_broadcast_process_thread, NULL);
+            broadcast_process_started = true;
+        } else if (broadcast_process.err != PBIO_ERROR_AGAIN) {
+            pbio_os_process_init(&broadcast_process, NULL);
+        }
+    }
+
+    pbdrv_bluetooth_start_broadcasting(&broadcast_task, &broadcast_values[0].v);
+    return pb_module_tools_pbio_task_wait_or_await(&broadcast_task);
+}
+
 /**
  * Sets the broadcast advertising data and enables broadcasting on the Bluetooth
  * radio if it is not already enabled.
  *
  * The data can be one object of the allowed types, or a tuple/list thereof.
  *
+ * If the encoded data does not fit in one advertisement, it is split into
+ * fragments that are broadcast in turn, each for @p interval milliseconds.
+ *
+ * Broadcasting the same data again does not restart the broadcast, so it is
+ * cheap to call this in a loop with data that rarely changes.
+ *
  * @param [in]  n_args   The number of args.
  * @param [in]  pos_args The args passed in Python code.
  * @param [in]  kw_args  The kwargs passed in Python code.
@@ -258,7 +448,8 @@ static size_t pb_module_ble_encode(void *dst, size_t index, mp_obj_t arg) {
 static mp_obj_t pb_module_ble_broadcast(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
     PB_PARSE_ARGS_METHOD(n_args, pos_args, kw_args,
         pb_obj_BLE_t, self,
-        PB_ARG_REQUIRED(data));
+        PB_ARG_REQUIRED(data),
+        PB_ARG_DEFAULT_INT(interval, 100));
     // On Move Hub, nothing is broadcast if it is called while the
     // move hub is connected to Pybricks Code. Also, broadcasting interferes
     // with observing even when not connected to Pybricks Code.
@@ -269,15 +460,18 @@ static mp_obj_t pb_module_ble_broadcast(size_t n_args, const mp_obj_t *pos_args,
 
     // Stop broadcasting if data is None.
     if (data_in == mp_const_none) {
+        broadcast_num_fragments = 0;
         static pbio_task_t stop_broadcasting_task;
         pbdrv_bluetooth_stop_broadcasting(&stop_broadcasting_task);
         return pb_module_tools_pbio_task_wait_or_await(&stop_broadcasting_task);
     }
 
-    static struct {
-        pbdrv_bluetooth_value_t v;
-        uint8_t d[5 + OBSERVED_DATA_MAX_SIZE];
-    } value;
+    mp_int_t interval = mp_obj_get_int(interval_in);
+    if (interval < BROADCAST_INTERVAL_MIN_MS) {
+        mp_raise_ValueError(MP_ERROR_TEXT("interval must be at least 100 ms"));
+    }
+
+    uint8_t payload[BROADCAST_DATA_MAX_SIZE];
 
     // Get either one or several data objects ready for transmission.
     mp_obj_t *objs;
@@ -288,7 +482,7 @@ static mp_obj_t pb_module_ble_broadcast(size_t n_args, const mp_obj_t *pos_args,
         mp_obj_get_array(data_in, &n_objs, &objs);
     } else {
         // Set first type to indicate single object.
-        value.d[5] = PB_BLE_BROADCAST_DATA_TYPE_SINGLE_OBJECT << 5;
+        payload[0] = PB_BLE_BROADCAST_DATA_TYPE_SINGLE_OBJECT << 5;
         // The one and only value is included directly after.
         index = 1;
         n_objs = 1;
@@ -297,17 +491,21 @@ static mp_obj_t pb_module_ble_broadcast(size_t n_args, const mp_obj_t *pos_args,
 
     // Encode all objects.
     for (size_t i = 0; i < n_objs; i++) {
-        index = pb_module_ble_encode(&value.d[5], index, objs[i]);
+        index = pb_module_ble_encode(payload, index, objs[i]);
     }
 
-    value.v.size = index + 5;
-    value.d[0] = index + 4; // length
-    value.d[1] = MFG_SPECIFIC;
-    pbio_set_uint16_le(&value.d[2], LEGO_CID);
-    value.d[4] = mp_obj_get_int(self->broadcast_channel);
+    // Nothing to update if this is already being broadcast.
+    uint8_t channel = mp_obj_get_int(self->broadcast_channel);
+    if (broadcast_num_fragments != 0 && broadcast_values[0].d[4] == channel &&
+        broadcast_interval == (uint32_t)interval && broadcast_payload_size == index &&
+        memcmp(broadcast_payload, payload, index) == 0) {
+        return pb_module_tools_pbio_task_wait_or_await(&broadcast_task);
+    }
 
-    pbdrv_bluetooth_start_broadcasting(&broadcast_task, &value.v);
-    return pb_module_tools_pbio_task_wait_or_await(&broadcast_task);
+    memcpy(broadcast_payload, payload, index);
+    broadcast_payload_size = index;
+    broadcast_interval = interval;
+    return pb_module_ble_broadcast_start(self);
 }
 static MP_DEFINE_CONST_FUN_OBJ_KW(pb_module_ble_broadcast_obj, 1, pb_module_ble_broadcast);
 
@@ -321,8 +519,8 @@ static MP_DEFINE_CONST_FUN_OBJ_KW(pb_module_ble_broadcast_obj, 1, pb_module_ble_
  * @throws RuntimeError     If the data was invalid and could not be decoded.
  */
 static mp_obj_t pb_module_ble_decode(const observed_data_t *data, size_t *index) {
-    uint8_t size = data->data[*index] & 0x1F;
-    pb_ble_broadcast_data_type_t data_type = data->data[*index] >> 5;
+    uint8_t size = data->received.data[*index] & 0x1F;
+    pb_ble_broadcast_data_type_t data_type = data->received.data[*index] >> 5;
 
     (*index)++;
 
@@ -335,19 +533,19 @@ static mp_obj_t pb_module_ble_decode(const observed_data_t *data, size_t *index)
             return mp_const_false;
         case PB_BLE_BROADCAST_DATA_TYPE_INT:
             if (size == sizeof(int8_t)) {
-                int8_t int8_value = data->data[*index];
+                int8_t int8_value = data->received.data[*index];
                 (*index) += sizeof(int8_value);
                 return MP_OBJ_NEW_SMALL_INT(int8_value);
             }
 
             if (size == sizeof(int16_t)) {
-                int16_t int16_value = pbio_get_uint16_le(&data->data[*index]);
+                int16_t int16_value = pbio_get_uint16_le(&data->received.data[*index]);
                 (*index) += sizeof(int16_value);
                 return MP_OBJ_NEW_SMALL_INT(int16_value);
             }
 
             if (size == sizeof(int32_t)) {
-                int32_t int32_value = pbio_get_uint32_le(&data->data[*index]);
+                int32_t int32_value = pbio_get_uint32_le(&data->received.data[*index]);
                 (*index) += sizeof(int32_value);
                 return mp_obj_new_int(int32_value);
             }
@@ -361,7 +559,7 @@ static mp_obj_t pb_module_ble_decode(const observed_data_t *data, size_t *index)
                 float f;
                 uint32_t u;
             } float_value;
-            float_value.u = pbio_get_uint32_le(&data->data[*index]);
+            float_value.u = pbio_get_uint32_le(&data->received.data[*index]);
             (*index) += sizeof(float_value);
             return mp_obj_new_float_from_f(float_value.f);
         }
@@ -370,13 +568,13 @@ static mp_obj_t pb_module_ble_decode(const observed_data_t *data, size_t *index)
             #endif
 
         case PB_BLE_BROADCAST_DATA_TYPE_STR: {
-            const char *str_data = (void *)&data->data[*index];
+            const char *str_data = (void *)&data->received.data[*index];
             (*index) += size;
             return mp_obj_new_str(str_data, size);
         }
 
         case PB_BLE_BROADCAST_DATA_TYPE_BYTES: {
-            const byte *bytes_data = (void *)&data->data[*index];
+            const byte *bytes_data = (void *)&data->received.data[*index];
             (*index) += size;
             return mp_obj_new_bytes(bytes_data, size);
         }
@@ -400,10 +598,10 @@ static mp_obj_t pb_module_ble_decode(const observed_data_t *data, size_t *index)
  * @throws ValueError       If the channel is out of range.
  * @throws RuntimeError     If the last received data was invalid.
  */
-static const observed_data_t *pb_module_ble_get_channel_data(mp_obj_t channel_in) {
+static observed_data_t *pb_module_ble_get_channel_data(mp_obj_t channel_in) {
     mp_int_t channel = mp_obj_get_int(channel_in);
 
-    observed_data_t *ch_data = lookup_observed_data(channel);
+    observed_data_t *ch_data = channel < 0 || channel > UINT8_MAX ? NULL : lookup_observed_data(channel);
 
     if (!ch_data) {
         mp_raise_ValueError(MP_ERROR_TEXT("channel not configured"));
@@ -411,7 +609,7 @@ static const observed_data_t *pb_module_ble_get_channel_data(mp_obj_t channel_in
 
     // Reset the data if it is too old.
     if (mp_hal_ticks_ms() - ch_data->timestamp > OBSERVED_DATA_TIMEOUT_MS) {
-        ch_data->size = 0;
+        ch_data->received.size = 0;
         ch_data->rssi = INT8_MIN;
     }
 
@@ -444,19 +642,19 @@ static mp_obj_t pb_module_ble_observe(mp_obj_t self_in, mp_obj_t channel_in) {
     }
 
     // Handle single object.
-    if (ch_data.size != 0 && ch_data.data[0] >> 5 == PB_BLE_BROADCAST_DATA_TYPE_SINGLE_OBJECT) {
+    if (ch_data.received.size != 0 && ch_data.received.data[0] >> 5 == PB_BLE_BROADCAST_DATA_TYPE_SINGLE_OBJECT) {
         size_t value_index = 1;
         return pb_module_ble_decode(&ch_data, &value_index);
     }
 
     // Objects can be encoded in as little as one byte so we could have up to
     // this many objects received.
-    mp_obj_t items[OBSERVED_DATA_MAX_SIZE];
+    mp_obj_t items[BROADCAST_DATA_MAX_SIZE];
 
     size_t index = 0;
     size_t i;
-    for (i = 0; i < OBSERVED_DATA_MAX_SIZE; i++) {
-        if (index >= ch_data.size) {
+    for (i = 0; i < BROADCAST_DATA_MAX_SIZE; i++) {
+        if (index >= ch_data.received.size) {
             break;
         }
 
@@ -467,6 +665,50 @@ static mp_obj_t pb_module_ble_observe(mp_obj_t self_in, mp_obj_t channel_in) {
 }
 static MP_DEFINE_CONST_FUN_OBJ_2(pb_module_ble_observe_obj, pb_module_ble_observe);
 
+/**
+ * Tests if new data was received on a channel since the awaitable was created.
+ *
+ * @param [in]  channel_in  Python object containing the channel number.
+ * @param [in]  end_time    Number of payloads received on the channel when
+ *                          the awaitable was created.
+ * @returns                 True if new data was received.
+ */
+static bool pb_module_ble_observe_next_test_completion(mp_obj_t channel_in, uint32_t end_time) {
+    const observed_data_t *ch_data = lookup_observed_data(mp_obj_get_int(channel_in));
+
+    // Also done if BLE was cleaned up, so the return value raises.
+    return !ch_data || pbio_broadcast_is_received_since(&ch_data->received, end_time);
+}
+
+static mp_obj_t pb_module_ble_observe_next_return_value(mp_obj_t channel_in) {
+    return pb_module_ble_observe(MP_OBJ_NULL, channel_in);
+}
+
+/**
+ * Waits for new advertising data on the given channel.
+ *
+ * @param [in]  self_in     The BLE object.
+ * @param [in]  channel_in  Python object containing the channel number.
+ * @returns                 Awaitable that gives the decoded data just like
+ *                          pb_module_ble_observe() once new data is received.
+ * @throws ValueError       If the channel is out of range.
+ */
+static mp_obj_t pb_module_ble_observe_next(mp_obj_t self_in, mp_obj_t channel_in) {
+    const observed_data_t *ch_data = pb_module_ble_get_channel_data(channel_in);
+
+    // Each awaitable compares with the count at the time it was created, so
+    // several tasks can wait for data on the same channel.
+    return pb_type_awaitable_await_or_wait(
+        MP_OBJ_NEW_SMALL_INT(ch_data->channel),
+        NULL,
+        ch_data->received.count,
+        pb_module_ble_observe_next_test_completion,
+        pb_module_ble_observe_next_return_value,
+        pb_type_awaitable_cancel_none,
+        PB_TYPE_AWAITABLE_OPT_NONE);
+}
+static MP_DEFINE_CONST_FUN_OBJ_2(pb_module_ble_observe_next_obj, pb_module_ble_observe_next);
+
 /**
  * Enables or disable observing
  *
@@ -503,6 +745,81 @@ static mp_obj_t pb_module_ble_signal_strength(mp_obj_t self_in, mp_obj_t channel
 }
 static MP_DEFINE_CONST_FUN_OBJ_2(pb_module_ble_signal_strength_obj, pb_module_ble_signal_strength);
 
+static bool pb_module_ble_sync_time_test_completion(mp_obj_t self_in, uint32_t end_time) {
+    // Also done if BLE was cleaned up.
+    return !time_sync.follower || time_sync.clock.synced;
+}
+
+/**
+ * Starts synchronizing the clock with other hubs.
+ *
+ * If @p channel_in is the broadcast channel of this hub, this hub becomes the
+ * leader and includes its clock in its broadcasts. Otherwise, this hub follows
+ * the clock received on the given observed channel.
+ *
+ * @param [in]  self_in     The BLE object.
+ * @param [in]  channel_in  Python object containing the channel number.
+ * @returns                 Awaitable that completes when the leader has
+ *                          started broadcasting, or when a follower has
+ *                          received the first time from the leader.
+ * @throws ValueError       If the channel is not the broadcast channel or an
+ *                          observed channel.
+ */
+static mp_obj_t pb_module_ble_sync_time(mp_obj_t self_in, mp_obj_t channel_in) {
+    pb_obj_BLE_t *self = MP_OBJ_TO_PTR(self_in);
+
+    if (self->broadcast_channel != mp_const_none && mp_obj_equal(channel_in, self->broadcast_channel)) {
+        memset(&time_sync, 0, sizeof(time_sync));
+        time_sync.leader = true;
+
+        // Restart broadcast with the time included. If nothing was broadcast
+        // yet, this just broadcasts the time.
+        if (broadcast_num_fragments == 0) {
+            broadcast_payload_size = 0;
+        }
+        if (broadcast_interval == 0) {
+            broadcast_interval = 100;
+        }
+        return pb_module_ble_broadcast_start(self);
+    }
+
+    const observed_data_t *ch_data = pb_module_ble_get_channel_data(channel_in);
+
+    memset(&time_sync, 0, sizeof(time_sync));
+    time_sync.follower = true;
+    time_sync.channel = ch_data->channel;
+
+    return pb_type_awaitable_await_or_wait(
+        self_in,
+        NULL,
+        0,
+        pb_module_ble_sync_time_test_completion,
+        pb_type_awaitable_return_none,
+        pb_type_awaitable_cancel_none,
+        PB_TYPE_AWAITABLE_OPT_NONE);
+}
+static MP_DEFINE_CONST_FUN_OBJ_2(pb_module_ble_sync_time_obj, pb_module_ble_sync_time);
+
+/**
+ * Gets the time of the clock shared by synchronized hubs.
+ *
+ * On followers, this time never goes back when the estimate is corrected.
+ *
+ * @param [out] time    The synchronized time in milliseconds.
+ * @returns             @c true if the time is valid, @c false if this hub is
+ *                      not synchronized.
+ */
+bool pb_type_ble_get_synced_time(uint32_t *time) {
+    uint32_t now = mp_hal_ticks_ms();
+
+    if (time_sync.leader) {
+        *time = now;
+        return true;
+    }
+
+    return time_sync.follower && pbio_clock_sync_get_time(&time_sync.clock, now, time);
+}
+
 /**
  * Gets the Bluetooth chip frimware version.
  * @param [in]  self_in     The BLE MicroPython object instance.
@@ -519,7 +836,9 @@ static const mp_rom_map_elem_t common_BLE_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_broadcast), MP_ROM_PTR(&pb_module_ble_broadcast_obj) },
     { MP_ROM_QSTR(MP_QSTR_observe), MP_ROM_PTR(&pb_module_ble_observe_obj) },
     { MP_ROM_QSTR(MP_QSTR_observe_enable), MP_ROM_PTR(&pb_module_ble_observe_enable_obj) },
+    { MP_ROM_QSTR(MP_QSTR_observe_next), MP_ROM_PTR(&pb_module_ble_observe_next_obj) },
     { MP_ROM_QSTR(MP_QSTR_signal_strength), MP_ROM_PTR(&pb_module_ble_signal_strength_obj) },
+    { MP_ROM_QSTR(MP_QSTR_sync_time), MP_ROM_PTR(&pb_module_ble_sync_time_obj) },
     { MP_ROM_QSTR(MP_QSTR_version), MP_ROM_PTR(&pb_module_ble_version_obj) },
 };
 static MP_DEFINE_CONST_DICT(common_BLE_locals_dict, common_BLE_locals_dict_table);
@@ -562,6 +881,7 @@ mp_obj_t pb_type_BLE_new(mp_obj_t broadcast_channel_in, mp_obj_t observe_channel
 
     pb_obj_BLE_t *self = mp_obj_malloc_var(pb_obj_BLE_t, observed_data_t, num_observe_channels, &pb_type_BLE);
     self->broadcast_channel = broadcast_channel_in;
+    memset(self->observed_data_index, 0, sizeof(self->observed_data_index));
 
     for (mp_int_t i = 0; i < num_observe_channels; i++) {
         mp_int_t channel = mp_obj_get_int(mp_obj_subscr(
@@ -573,6 +893,12 @@ mp_obj_t pb_type_BLE_new(mp_obj_t broadcast_channel_in, mp_obj_t observe_channel
 
         self->observed_data[i].channel = channel;
         self->observed_data[i].rssi = INT8_MIN;
+        memset(&self->observed_data[i].received, 0, sizeof(self->observed_data[i].received));
+
+        // If a channel is given more than once, the first one is used.
+        if (!self->observed_data_index[channel]) {
+            self->observed_data_index[channel] = i + 1;
+        }
 
         // Suppress stale data by making everything outdated.
         self->observed_data[i].timestamp = mp_hal_ticks_ms() - RSSI_FILTER_WINDOW_MS - OBSERVED_DATA_TIMEOUT_MS;
@@ -581,6 +907,7 @@ mp_obj_t pb_type_BLE_new(mp_obj_t broadcast_channel_in, mp_obj_t observe_channel
     // globals for driver callback
     observed_data = self->observed_data;
     num_observed_data = num_observe_channels;
+    observed_data_index = self->observed_data_index;
 
     // Start observing right away by default.
     if (num_observe_channels > 0) {
@@ -595,8 +922,12 @@ void pb_type_ble_start_cleanup(void) {
     static pbio_task_t stop_observing_task;
     pbdrv_bluetooth_stop_broadcasting(&stop_broadcasting_task);
     pbdrv_bluetooth_stop_observing(&stop_observing_task);
+    broadcast_num_fragments = 0;
+    broadcast_interval = 0;
+    memset(&time_sync, 0, sizeof(time_sync));
     observed_data = NULL;
     num_observed_data = 0;
+    observed_data_index = NULL;
     // The aforementioned tasks started here are awaited in pybricks de-init.
 }
 
@@ -80,6 +80,48 @@ static bool pb_pup_device_test_completion(mp_obj_t self_in, uint32_t end_time) {
     return true;
 }
 
+/**
+ * Tests that a Powered Up device has received a sample since the awaitable
+ * was created.
+ *
+ * @param [in]  self_in     The sensor object instance.
+ * @param [in]  end_time    Sample count when the awaitable was created.
+ * @return                  True if new data is ready, false otherwise.
+ */
+static bool pb_pup_device_test_new_data(mp_obj_t self_in, uint32_t end_time) {
+    pb_type_device_obj_base_t *sensor = MP_OBJ_TO_PTR(self_in);
+    if (!pb_pup_device_test_completion(self_in, end_time)) {
+        return false;
+    }
+    uint32_t time;
+    uint32_t count;
+    pb_assert(pbio_port_lump_get_data_time(sensor->lump_dev, &time, &count));
+    return count != end_time;
+}
+
+/**
+ * Waits until a Powered Up device receives a new sample in its current mode.
+ *
+ * @param [in]  sensor      The powered up device.
+ * @return                  Awaitable object.
+ */
+mp_obj_t pb_type_device_await_new_data(pb_type_device_obj_base_t *sensor) {
+    uint32_t time;
+    uint32_t count;
+    pb_assert(pbio_port_lump_get_data_time(sensor->lump_dev, &time, &count));
+
+    // Each awaitable compares with the count at the time it was created, so
+    // several tasks can wait for new data from the same sensor.
+    return pb_type_awaitable_await_or_wait(
+        MP_OBJ_FROM_PTR(sensor),
+        sensor,
+        count,
+        pb_pup_device_test_new_data,
+        pb_type_awaitable_return_none,
+        pb_type_awaitable_cancel_none,
+        PB_TYPE_AWAITABLE_OPT_NONE);
+}
+
 /**
  * Implements calling of async sensor methods. This is called when a (constant)
  * entry of pb_type_device_method type in a sensor class is called. It is
@@ -102,7 +144,7 @@ mp_obj_t pb_type_device_method_call(mp_obj_t self_in, size_t n_args, size_t n_kw
 
     return pb_type_awaitable_await_or_wait(
         sensor_in,
-        sensor->awaitables,
+        sensor,
         pb_type_awaitable_end_time_none,
         pb_pup_device_test_completion,
         method->get_values,
@@ -136,7 +178,7 @@ mp_obj_t pb_type_device_set_data(pb_type_device_obj_base_t *sensor, uint8_t mode
     pb_assert(pbio_port_lump_set_mode_with_data(sensor->lump_dev, mode, data, size));
     return pb_type_awaitable_await_or_wait(
         MP_OBJ_FROM_PTR(sensor),
-        sensor->awaitables,
+        sensor,
         pb_type_awaitable_end_time_none,
         pb_pup_device_test_completion,
         pb_type_awaitable_return_none,
@@ -144,6 +186,28 @@ mp_obj_t pb_type_device_set_data(pb_type_device_obj_base_t *sensor, uint8_t mode
         PB_TYPE_AWAITABLE_OPT_RAISE_ON_BUSY);
 }
 
+/**
+ * Starts streaming the data of several modes of a Powered Up device at once.
+ * Returns an awaitable object that can be used to wait for the first data.
+ *
+ * @param [in]  sensor      The powered up device.
+ * @param [in]  modes       Modes to combine.
+ * @param [in]  num_modes   Number of modes.
+ * @param [in]  get_values  Function that makes the return value from the combined data.
+ * @return                  Awaitable object.
+ */
+mp_obj_t pb_type_device_set_combi_mode(pb_type_device_obj_base_t *sensor, const uint8_t *modes, uint8_t num_modes, pb_type_awaitable_return_t get_values) {
+    pb_assert(pbio_port_lump_set_combi_mode(sensor->lump_dev, modes, num_modes));
+    return pb_type_awaitable_await_or_wait(
+        MP_OBJ_FROM_PTR(sensor),
+        sensor,
+        pb_type_awaitable_end_time_none,
+        pb_pup_device_test_completion,
+        get_values,
+        pb_type_awaitable_cancel_none,
+        PB_TYPE_AWAITABLE_OPT_NONE);
+}
+
 void pb_device_set_lego_mode(pbio_port_t *port) {
     // Set the port mode to LEGO DCM if it is not already set.
     pbio_error_t err = pbio_port_set_mode(port, PBIO_PORT_MODE_LEGO_DCM);
@@ -176,7 +240,6 @@ lego_device_type_id_t pb_type_device_init_class(pb_type_device_obj_base_t *self,
         mp_hal_delay_ms(50);
     }
     pb_assert(err);
-    self->awaitables = mp_obj_new_list(0, NULL);
     return actual_id;
 }
 
@@ -19,7 +19,6 @@
 typedef struct _pb_type_device_obj_base_t {
     mp_obj_base_t base;
     pbio_port_lump_dev_t *lump_dev;
-    mp_obj_t awaitables;
 } pb_type_device_obj_base_t;
 
 #if PYBRICKS_PY_DEVICES
@@ -59,6 +58,8 @@ mp_obj_t pb_type_device_method_call(mp_obj_t self_in, size_t n_args, size_t n_kw
 mp_obj_t pb_type_pupdevices_method(mp_obj_t self_in, size_t n_args, size_t n_kw, const mp_obj_t *args);
 lego_device_type_id_t pb_type_device_init_class(pb_type_device_obj_base_t *self, mp_obj_t port_in, lego_device_type_id_t valid_id);
 mp_obj_t pb_type_device_set_data(pb_type_device_obj_base_t *sensor, uint8_t mode, const void *data, uint8_t size);
+mp_obj_t pb_type_device_await_new_data(pb_type_device_obj_base_t *sensor);
+mp_obj_t pb_type_device_set_combi_mode(pb_type_device_obj_base_t *sensor, const uint8_t *modes, uint8_t num_modes, pb_type_awaitable_return_t get_values);
 void *pb_type_device_get_data(mp_obj_t self_in, uint8_t mode);
 void *pb_type_device_get_data_blocking(mp_obj_t self_in, uint8_t mode);
 
@@ -148,8 +148,6 @@ static mp_obj_t pb_type_Motor_make_new(const mp_obj_type_t *type, size_t n_args,
     self->logger = common_Logger_obj_make_new(&self->srv->log, PBIO_SERVO_LOGGER_NUM_COLS);
     #endif
 
-    self->device_base.awaitables = mp_obj_new_list(0, NULL);
-
     return MP_OBJ_FROM_PTR(self);
 }
 
@@ -243,7 +241,7 @@ static mp_obj_t pb_type_Motor_reset_angle(size_t n_args, const mp_obj_t *pos_arg
 
     // Set the new angle
     pb_assert(pbio_servo_reset_angle(self->srv, reset_angle, reset_to_abs));
-    pb_type_awaitable_update_all(self->device_base.awaitables, PB_TYPE_AWAITABLE_OPT_CANCEL_ALL);
+    pb_type_awaitable_update_all(self, PB_TYPE_AWAITABLE_OPT_CANCEL_ALL);
     return mp_const_none;
 }
 static MP_DEFINE_CONST_FUN_OBJ_KW(pb_type_Motor_reset_angle_obj, 1, pb_type_Motor_reset_angle);
@@ -268,7 +266,7 @@ static mp_obj_t pb_type_Motor_run(size_t n_args, const mp_obj_t *pos_args, mp_ma
 
     mp_int_t speed = pb_obj_get_int(speed_in);
     pb_assert(pbio_servo_run_forever(self->srv, speed));
-    pb_type_awaitable_update_all(self->device_base.awaitables, PB_TYPE_AWAITABLE_OPT_CANCEL_ALL);
+    pb_type_awaitable_update_all(self, PB_TYPE_AWAITABLE_OPT_CANCEL_ALL);
     return mp_const_none;
 }
 static MP_DEFINE_CONST_FUN_OBJ_KW(pb_type_Motor_run_obj, 1, pb_type_Motor_run);
@@ -277,7 +275,7 @@ static MP_DEFINE_CONST_FUN_OBJ_KW(pb_type_Motor_run_obj, 1, pb_type_Motor_run);
 static mp_obj_t pb_type_Motor_hold(mp_obj_t self_in) {
     pb_type_Motor_obj_t *self = MP_OBJ_TO_PTR(self_in);
     pb_assert(pbio_servo_stop(self->srv, PBIO_CONTROL_ON_COMPLETION_HOLD));
-    pb_type_awaitable_update_all(self->device_base.awaitables, PB_TYPE_AWAITABLE_OPT_CANCEL_ALL);
+    pb_type_awaitable_update_all(self, PB_TYPE_AWAITABLE_OPT_CANCEL_ALL);
     return mp_const_none;
 }
 static MP_DEFINE_CONST_FUN_OBJ_1(pb_type_Motor_hold_obj, pb_type_Motor_hold);
@@ -301,7 +299,7 @@ static void pb_type_Motor_cancel(mp_obj_t self_in) {
 static mp_obj_t await_or_wait(pb_type_Motor_obj_t *self) {
     return pb_type_awaitable_await_or_wait(
         MP_OBJ_FROM_PTR(self),
-        self->device_base.awaitables,
+        self,
         pb_type_awaitable_end_time_none,
         pb_type_Motor_test_completion,
         pb_type_awaitable_return_none,
@@ -372,7 +370,7 @@ static mp_obj_t pb_type_Motor_run_until_stalled(size_t n_args, const mp_obj_t *p
     // Handle completion by awaiting or blocking.
     return pb_type_awaitable_await_or_wait(
         MP_OBJ_FROM_PTR(self),
-        self->device_base.awaitables,
+        self,
         pb_type_awaitable_end_time_none,
         pb_type_Motor_test_completion,
         pb_type_Motor_stall_return_value,
@@ -439,7 +437,7 @@ static mp_obj_t pb_type_Motor_track_target(size_t n_args, const mp_obj_t *pos_ar
 
     mp_int_t target_angle = pb_obj_get_int(target_angle_in);
     pb_assert(pbio_servo_track_target(self->srv, target_angle));
-    pb_type_awaitable_update_all(self->device_base.awaitables, PB_TYPE_AWAITABLE_OPT_CANCEL_ALL);
+    pb_type_awaitable_update_all(self, PB_TYPE_AWAITABLE_OPT_CANCEL_ALL);
     return mp_const_none;
 }
 static MP_DEFINE_CONST_FUN_OBJ_KW(pb_type_Motor_track_target_obj, 1, pb_type_Motor_track_target);
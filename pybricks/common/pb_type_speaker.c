@@ -33,7 +33,6 @@ typedef struct {
     uint32_t note_duration;
     uint32_t beep_end_time;
     uint32_t release_end_time;
-    mp_obj_t awaitables;
 
     // volume in 0..100 range
     uint8_t volume;
@@ -111,10 +110,6 @@ static mp_obj_t pb_type_Speaker_make_new(const mp_obj_type_t *type, size_t n_arg
 
     pb_type_Speaker_obj_t *self = mp_obj_malloc(pb_type_Speaker_obj_t, type);
 
-    // List of awaitables associated with speaker. By keeping track,
-    // we can cancel them as needed when a new sound is started.
-    self->awaitables = mp_obj_new_list(0, NULL);
-
     // REVISIT: If a user creates two Speaker instances, this will reset the volume settings for both.
     // If done only once per singleton, however, altered volume settings would be persisted between program runs.
     self->volume = 100;
@@ -161,7 +156,7 @@ static mp_obj_t pb_type_Speaker_beep(size_t n_args, const mp_obj_t *pos_args, mp
 
     return pb_type_awaitable_await_or_wait(
         MP_OBJ_FROM_PTR(self),
-        self->awaitables,
+        self,
         pb_type_awaitable_end_time_none,
         pb_type_Speaker_beep_test_completion,
         pb_type_awaitable_return_none,
@@ -377,7 +372,7 @@ static mp_obj_t pb_type_Speaker_play_notes(size_t n_args, const mp_obj_t *pos_ar
     self->release_end_time = self->beep_end_time;
     return pb_type_awaitable_await_or_wait(
         MP_OBJ_FROM_PTR(self),
-        self->awaitables,
+        self,
         pb_type_awaitable_end_time_none,
         pb_type_Speaker_notes_test_completion,
         pb_type_awaitable_return_none,
@@ -21,6 +21,7 @@
 #include <pybricks/common.h>
 #include <pybricks/parameters.h>
 #include <pybricks/util_pb/pb_error.h>
+#include <pybricks/util_mp/pb_heap_profiler.h>
 #include <pybricks/util_mp/pb_kwarg_helper.h>
 #include <pybricks/util_mp/pb_obj_helper.h>
 
@@ -50,6 +51,9 @@ static mp_obj_t pb_type_System_info(void) {
         #endif // PBDRV_CONFIG_RESET
         {MP_OBJ_NEW_QSTR(MP_QSTR_host_connected_ble), mp_obj_new_bool(pbsys_status_test(PBIO_PYBRICKS_STATUS_BLE_HOST_CONNECTED))},
         {MP_OBJ_NEW_QSTR(MP_QSTR_program_start_type), mp_obj_new_int(pbsys_main_program_get_start_request_type())},
+        #if PYBRICKS_OPT_HEAP_PROFILER
+        {MP_OBJ_NEW_QSTR(MP_QSTR_heap), pb_heap_profiler_get_info()},
+        #endif // PYBRICKS_OPT_HEAP_PROFILER
     };
     mp_obj_t info_dict = mp_obj_new_dict(MP_ARRAY_SIZE(info));
 
@@ -13,6 +13,7 @@
 #include <pbio/button.h>
 #include <pbio/color.h>
 #include <pbio/error.h>
+#include <pbio/int_math.h>
 #include <pbio/task.h>
 
 #include <pbsys/config.h>
@@ -21,6 +22,7 @@
 #include <pybricks/common.h>
 #include <pybricks/parameters.h>
 #include <pybricks/tools.h>
+#include <pybricks/tools/pb_type_awaitable.h>
 #include <pybricks/util_mp/pb_kwarg_helper.h>
 #include <pybricks/util_mp/pb_obj_helper.h>
 #include <pybricks/util_pb/pb_error.h>
@@ -36,6 +38,9 @@
 // A overhead of 3 yields a max message size of 20 (=23-3)
 #define LWP3_MAX_MESSAGE_SIZE 20
 
+// Number of received messages that can be queued before the oldest is dropped.
+#define LWP3_NOTIFICATION_QUEUE_SIZE 16
+
 enum {
     REMOTE_PORT_LEFT_BUTTONS    = 0,
     REMOTE_PORT_RIGHT_BUTTONS   = 1,
@@ -88,8 +93,16 @@ static pbdrv_bluetooth_peripheral_char_t pb_lwp3device_char = {
 typedef struct {
     pbio_task_t task;
     #if PYBRICKS_PY_IODEVICES
-    uint8_t buffer[LWP3_MAX_MESSAGE_SIZE];
-    bool notification_received;
+    // Queue of received messages, oldest first.
+    uint8_t buffer[LWP3_NOTIFICATION_QUEUE_SIZE][LWP3_MAX_MESSAGE_SIZE];
+    // Index of the oldest message in the queue.
+    uint8_t queue_start;
+    // Number of messages in the queue.
+    uint8_t queue_count;
+    // Maximum number of messages returned by the ongoing read.
+    uint8_t read_count;
+    // Number of messages dropped because the queue was full.
+    uint32_t dropped;
     #endif // PYBRICKS_PY_IODEVICES
     uint8_t left[3];
     uint8_t right[3];
@@ -108,10 +121,16 @@ static pbio_pybricks_error_t handle_notification(pbdrv_bluetooth_connection_t co
     pb_lwp3device_t *lwp3device = &pb_lwp3device_singleton;
 
     #if PYBRICKS_PY_IODEVICES
-    // Each message overwrites the previous received messages
-    // Messages will be lost if they are not read fast enough
-    memcpy(lwp3device->buffer, &value[0], (size < LWP3_MAX_MESSAGE_SIZE) ? size : LWP3_MAX_MESSAGE_SIZE);
-    lwp3device->notification_received = true;
+    // If messages are not read fast enough, the oldest message is dropped to
+    // make room for the new one.
+    if (lwp3device->queue_count == LWP3_NOTIFICATION_QUEUE_SIZE) {
+        lwp3device->queue_start = (lwp3device->queue_start + 1) % LWP3_NOTIFICATION_QUEUE_SIZE;
+        lwp3device->queue_count--;
+        lwp3device->dropped++;
+    }
+    uint8_t index = (lwp3device->queue_start + lwp3device->queue_count) % LWP3_NOTIFICATION_QUEUE_SIZE;
+    memcpy(lwp3device->buffer[index], &value[0], (size < LWP3_MAX_MESSAGE_SIZE) ? size : LWP3_MAX_MESSAGE_SIZE);
+    lwp3device->queue_count++;
 
     if (lwp3device->hub_kind != LWP3_HUB_KIND_HANDSET) {
         // This is not a handset, so we don't care about button state.
@@ -527,36 +546,107 @@ static mp_obj_t lwp3device_write(mp_obj_t self_in, mp_obj_t buf_in) {
 }
 static MP_DEFINE_CONST_FUN_OBJ_2(lwp3device_write_obj, lwp3device_write);
 
-static mp_obj_t lwp3device_read(mp_obj_t self_in) {
+static bool lwp3device_read_test_completion(mp_obj_t self_in, uint32_t end_time) {
+    pb_lwp3device_t *lwp3device = &pb_lwp3device_singleton;
+    pb_lwp3device_assert_connected();
+    return lwp3device->queue_count > 0;
+}
+
+// Tests if the oldest message in the queue has a valid size.
+static bool lwp3device_peek_message_is_valid(void) {
+    pb_lwp3device_t *lwp3device = &pb_lwp3device_singleton;
+    size_t len = lwp3device->buffer[lwp3device->queue_start][0];
+    return len >= LWP3_HEADER_SIZE && len <= LWP3_MAX_MESSAGE_SIZE;
+}
+
+// Removes the oldest message from the queue.
+static void lwp3device_drop_message(void) {
+    pb_lwp3device_t *lwp3device = &pb_lwp3device_singleton;
+    lwp3device->queue_start = (lwp3device->queue_start + 1) % LWP3_NOTIFICATION_QUEUE_SIZE;
+    lwp3device->queue_count--;
+}
+
+// Removes the oldest message from the queue and returns it. A good message
+// is only removed once it has been copied, so it is not lost if this raises.
+static mp_obj_t lwp3device_pop_message(void) {
     pb_lwp3device_t *lwp3device = &pb_lwp3device_singleton;
 
-    // wait until a notification is received
-    for (;;) {
-        pb_lwp3device_assert_connected();
+    if (!lwp3device_peek_message_is_valid()) {
+        lwp3device_drop_message();
+        mp_raise_msg(&mp_type_RuntimeError, MP_ERROR_TEXT("bad data"));
+    }
+
+    const uint8_t *message = lwp3device->buffer[lwp3device->queue_start];
+    mp_obj_t result = mp_obj_new_bytes(message, message[0]);
+    lwp3device_drop_message();
+    return result;
+}
 
-        if (lwp3device->notification_received) {
-            lwp3device->notification_received = false;
+static mp_obj_t lwp3device_read_return_one(mp_obj_t self_in) {
+    return lwp3device_pop_message();
+}
+
+static mp_obj_t lwp3device_read_return_many(mp_obj_t self_in) {
+    pb_lwp3device_t *lwp3device = &pb_lwp3device_singleton;
+
+    mp_obj_t messages[LWP3_NOTIFICATION_QUEUE_SIZE];
+    size_t num_messages = 0;
+    while (lwp3device->queue_count > 0 && num_messages < lwp3device->read_count) {
+        // Return the good messages before a bad one. The bad one stays in the
+        // queue, so the next read raises and removes it.
+        if (num_messages > 0 && !lwp3device_peek_message_is_valid()) {
             break;
         }
-
-        MICROPY_EVENT_POLL_HOOK
+        messages[num_messages++] = lwp3device_pop_message();
     }
+    return mp_obj_new_tuple(num_messages, messages);
+}
 
-    size_t len = lwp3device->buffer[0];
+static mp_obj_t lwp3device_read(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    PB_PARSE_ARGS_METHOD(n_args, pos_args, kw_args,
+        pb_type_pupdevices_Remote_obj_t, self,
+        PB_ARG_DEFAULT_NONE(count));
 
-    if (len < LWP3_HEADER_SIZE || len > LWP3_MAX_MESSAGE_SIZE) {
-        mp_raise_msg(&mp_type_RuntimeError, MP_ERROR_TEXT("bad data"));
+    pb_lwp3device_t *lwp3device = &pb_lwp3device_singleton;
+
+    pb_lwp3device_assert_connected();
+
+    // Without count, return only the oldest message as before. Otherwise
+    // return a tuple of up to count messages.
+    pb_type_awaitable_return_t return_func = lwp3device_read_return_one;
+    if (count_in != mp_const_none) {
+        mp_int_t count = pb_obj_get_positive_int(count_in);
+        if (count < 1) {
+            mp_raise_ValueError(MP_ERROR_TEXT("count must be at least 1"));
+        }
+        lwp3device->read_count = pbio_int_math_min(count, LWP3_NOTIFICATION_QUEUE_SIZE);
+        return_func = lwp3device_read_return_many;
     }
 
-    return mp_obj_new_bytes(lwp3device->buffer, len);
+    // Completes as soon as at least one message is queued.
+    return pb_type_awaitable_await_or_wait(
+        MP_OBJ_FROM_PTR(self),
+        lwp3device,
+        pb_type_awaitable_end_time_none,
+        lwp3device_read_test_completion,
+        return_func,
+        pb_type_awaitable_cancel_none,
+        PB_TYPE_AWAITABLE_OPT_RAISE_ON_BUSY);
+}
+static MP_DEFINE_CONST_FUN_OBJ_KW(lwp3device_read_obj, 1, lwp3device_read);
+
+static mp_obj_t lwp3device_dropped(mp_obj_t self_in) {
+    pb_lwp3device_t *lwp3device = &pb_lwp3device_singleton;
+    return mp_obj_new_int_from_uint(lwp3device->dropped);
 }
-static MP_DEFINE_CONST_FUN_OBJ_1(lwp3device_read_obj, lwp3device_read);
+static MP_DEFINE_CONST_FUN_OBJ_1(lwp3device_dropped_obj, lwp3device_dropped);
 
 static const mp_rom_map_elem_t pb_type_iodevices_LWP3Device_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_disconnect), MP_ROM_PTR(&pb_lwp3device_disconnect_obj) },
     { MP_ROM_QSTR(MP_QSTR_name), MP_ROM_PTR(&pb_lwp3device_name_obj) },
     { MP_ROM_QSTR(MP_QSTR_write), MP_ROM_PTR(&lwp3device_write_obj) },
     { MP_ROM_QSTR(MP_QSTR_read), MP_ROM_PTR(&lwp3device_read_obj) },
+    { MP_ROM_QSTR(MP_QSTR_dropped), MP_ROM_PTR(&lwp3device_dropped_obj) },
 };
 static MP_DEFINE_CONST_DICT(pb_type_iodevices_LWP3Device_locals_dict, pb_type_iodevices_LWP3Device_locals_dict_table);
 
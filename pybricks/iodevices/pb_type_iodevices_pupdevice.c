@@ -11,6 +11,7 @@
 #include <pbio/port_interface.h>
 #include <pbio/port_lump.h>
 #include <pbio/int_math.h>
+#include <pbio/util.h>
 
 #include "py/objstr.h"
 
@@ -30,6 +31,10 @@ typedef struct _iodevices_PUPDevice_obj_t {
     // on the awaitable instead, as extra context. For now, it is safe since
     // concurrent reads with the same sensor are not permitted.
     uint8_t last_mode;
+    // Modes used when initiating awaitable combined read.
+    uint8_t combi_modes[LUMP_MAX_EXT_MODE + 1];
+    // Number of modes used when initiating awaitable combined read.
+    uint8_t num_combi_modes;
     // ID of a passive device, if any.
     lego_device_type_id_t passive_id;
 } iodevices_PUPDevice_obj_t;
@@ -120,49 +125,99 @@ static mp_obj_t iodevices_PUPDevice_info(mp_obj_t self_in) {
 }
 MP_DEFINE_CONST_FUN_OBJ_1(iodevices_PUPDevice_info_obj, iodevices_PUPDevice_info);
 
-static mp_obj_t get_pup_data_tuple(mp_obj_t self_in) {
-    iodevices_PUPDevice_obj_t *self = MP_OBJ_TO_PTR(self_in);
-    void *data = pb_type_device_get_data(self_in, self->last_mode);
-
-    pbio_port_lump_mode_info_t *mode_info;
-    uint8_t current_mode;
-    uint8_t num_modes;
-    lego_device_type_id_t type_id = LEGO_DEVICE_TYPE_ID_ANY_LUMP_UART;
-    pb_assert(pbio_port_lump_assert_type_id(self->device_base.lump_dev, &type_id));
-    pb_assert(pbio_port_lump_get_info(self->device_base.lump_dev, &num_modes, &current_mode, &mode_info));
-
+/**
+ * Makes a tuple of the values of one mode.
+ *
+ * @param [in]  info        Information about the mode.
+ * @param [in]  data        Little-endian values, not necessarily aligned.
+ * @return                  Tuple of values.
+ */
+static mp_obj_t make_pup_data_tuple(const pbio_port_lump_mode_info_t *info, const uint8_t *data) {
 
     mp_obj_t values[LUMP_MAX_MSG_SIZE];
 
-    for (uint8_t i = 0; i < mode_info[current_mode].num_values; i++) {
-        switch (mode_info[current_mode].data_type) {
+    for (uint8_t i = 0; i < info->num_values; i++) {
+        switch (info->data_type) {
             case LUMP_DATA_TYPE_DATA8:
-                values[i] = mp_obj_new_int(((int8_t *)data)[i]);
+                values[i] = mp_obj_new_int((int8_t)data[i]);
                 break;
             case LUMP_DATA_TYPE_DATA16:
-                values[i] = mp_obj_new_int(((int16_t *)data)[i]);
+                values[i] = mp_obj_new_int((int16_t)pbio_get_uint16_le(data + i * 2));
                 break;
             case LUMP_DATA_TYPE_DATA32:
-                values[i] = mp_obj_new_int(((int32_t *)data)[i]);
+                values[i] = mp_obj_new_int((int32_t)pbio_get_uint32_le(data + i * 4));
                 break;
             #if MICROPY_PY_BUILTINS_FLOAT
-            case LUMP_DATA_TYPE_DATAF:
-                values[i] = mp_obj_new_float_from_f(((float *)data)[i]);
+            case LUMP_DATA_TYPE_DATAF: {
+                float value;
+                memcpy(&value, data + i * 4, sizeof(value));
+                values[i] = mp_obj_new_float_from_f(value);
                 break;
+            }
             #endif
             default:
                 pb_assert(PBIO_ERROR_IO);
         }
     }
 
-    return mp_obj_new_tuple(mode_info[current_mode].num_values, values);
+    return mp_obj_new_tuple(info->num_values, values);
+}
+
+static mp_obj_t get_pup_data_tuple(mp_obj_t self_in) {
+    iodevices_PUPDevice_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    void *data = pb_type_device_get_data(self_in, self->last_mode);
+
+    pbio_port_lump_mode_info_t *mode_info;
+    uint8_t current_mode;
+    uint8_t num_modes;
+    lego_device_type_id_t type_id = LEGO_DEVICE_TYPE_ID_ANY_LUMP_UART;
+    pb_assert(pbio_port_lump_assert_type_id(self->device_base.lump_dev, &type_id));
+    pb_assert(pbio_port_lump_get_info(self->device_base.lump_dev, &num_modes, &current_mode, &mode_info));
+
+    return make_pup_data_tuple(&mode_info[current_mode], data);
+}
+
+static mp_obj_t get_pup_data_tuple_with_timestamp(mp_obj_t self_in) {
+    iodevices_PUPDevice_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    uint32_t time;
+    uint32_t count;
+    pb_assert(pbio_port_lump_get_data_time(self->device_base.lump_dev, &time, &count));
+    mp_obj_t values[] = {
+        get_pup_data_tuple(self_in),
+        mp_obj_new_int_from_uint(time),
+        mp_obj_new_int_from_uint(count),
+    };
+    return mp_obj_new_tuple(MP_ARRAY_SIZE(values), values);
+}
+
+static mp_obj_t get_pup_combi_data_tuple(mp_obj_t self_in) {
+    iodevices_PUPDevice_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    const uint8_t *data = pb_type_device_get_data(self_in, PBIO_PORT_LUMP_MODE_COMBI);
+
+    pbio_port_lump_mode_info_t *mode_info;
+    uint8_t current_mode;
+    uint8_t num_modes;
+    lego_device_type_id_t type_id = LEGO_DEVICE_TYPE_ID_ANY_LUMP_UART;
+    pb_assert(pbio_port_lump_assert_type_id(self->device_base.lump_dev, &type_id));
+    pb_assert(pbio_port_lump_get_info(self->device_base.lump_dev, &num_modes, &current_mode, &mode_info));
+
+    // Values of each mode follow each other without padding.
+    mp_obj_t modes[MP_ARRAY_SIZE(self->combi_modes)];
+    for (uint8_t i = 0; i < self->num_combi_modes; i++) {
+        const pbio_port_lump_mode_info_t *info = &mode_info[self->combi_modes[i]];
+        modes[i] = make_pup_data_tuple(info, data);
+        data += info->num_values * pbio_port_lump_data_size(info->data_type);
+    }
+
+    return mp_obj_new_tuple(self->num_combi_modes, modes);
 }
 
 // pybricks.iodevices.PUPDevice.read
 static mp_obj_t iodevices_PUPDevice_read(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
     PB_PARSE_ARGS_METHOD(n_args, pos_args, kw_args,
         iodevices_PUPDevice_obj_t, self,
-        PB_ARG_REQUIRED(mode));
+        PB_ARG_REQUIRED(mode),
+        PB_ARG_DEFAULT_FALSE(with_timestamp));
 
     // Passive devices don't support reading.
     if (self->passive_id != LEGO_DEVICE_TYPE_ID_LPF2_UNKNOWN_UART) {
@@ -176,7 +231,7 @@ static mp_obj_t iodevices_PUPDevice_read(size_t n_args, const mp_obj_t *pos_args
     const pb_type_device_method_obj_t method = {
         {&pb_type_device_method},
         .mode = self->last_mode,
-        .get_values = get_pup_data_tuple,
+        .get_values = mp_obj_is_true(with_timestamp_in) ? get_pup_data_tuple_with_timestamp : get_pup_data_tuple,
     };
 
     // This will take care of checking that the requested mode exist and raise
@@ -185,6 +240,52 @@ static mp_obj_t iodevices_PUPDevice_read(size_t n_args, const mp_obj_t *pos_args
 }
 MP_DEFINE_CONST_FUN_OBJ_KW(iodevices_PUPDevice_read_obj, 1, iodevices_PUPDevice_read);
 
+// pybricks.iodevices.PUPDevice.read_combi
+static mp_obj_t iodevices_PUPDevice_read_combi(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    PB_PARSE_ARGS_METHOD(n_args, pos_args, kw_args,
+        iodevices_PUPDevice_obj_t, self,
+        PB_ARG_REQUIRED(modes));
+
+    // Passive devices don't support reading.
+    if (self->passive_id != LEGO_DEVICE_TYPE_ID_LPF2_UNKNOWN_UART) {
+        pb_assert(PBIO_ERROR_INVALID_OP);
+    }
+
+    mp_obj_t *modes;
+    size_t num_modes;
+    mp_obj_get_array(modes_in, &num_modes, &modes);
+    if (num_modes == 0 || num_modes > MP_ARRAY_SIZE(self->combi_modes)) {
+        mp_raise_msg(&mp_type_ValueError, MP_ERROR_TEXT("Invalid modes"));
+    }
+    for (size_t i = 0; i < num_modes; i++) {
+        mp_int_t mode = mp_obj_get_int(modes[i]);
+        if (mode < 0 || mode > UINT8_MAX) {
+            mp_raise_msg(&mp_type_ValueError, MP_ERROR_TEXT("Invalid modes"));
+        }
+        self->combi_modes[i] = mode;
+    }
+    self->num_combi_modes = num_modes;
+
+    // This checks that the device can stream these modes together and raises
+    // otherwise, so no need to check here. The device keeps streaming the
+    // combination until read() selects a single mode again.
+    return pb_type_device_set_combi_mode(&self->device_base, self->combi_modes, self->num_combi_modes, get_pup_combi_data_tuple);
+}
+MP_DEFINE_CONST_FUN_OBJ_KW(iodevices_PUPDevice_read_combi_obj, 1, iodevices_PUPDevice_read_combi);
+
+// pybricks.iodevices.PUPDevice.new_data
+static mp_obj_t iodevices_PUPDevice_new_data(mp_obj_t self_in) {
+    iodevices_PUPDevice_obj_t *self = MP_OBJ_TO_PTR(self_in);
+
+    // Passive devices don't support reading.
+    if (self->passive_id != LEGO_DEVICE_TYPE_ID_LPF2_UNKNOWN_UART) {
+        pb_assert(PBIO_ERROR_INVALID_OP);
+    }
+
+    return pb_type_device_await_new_data(&self->device_base);
+}
+MP_DEFINE_CONST_FUN_OBJ_1(iodevices_PUPDevice_new_data_obj, iodevices_PUPDevice_new_data);
+
 // pybricks.iodevices.PUPDevice.write
 static mp_obj_t iodevices_PUPDevice_write(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
     PB_PARSE_ARGS_METHOD(n_args, pos_args, kw_args,
@@ -288,6 +389,8 @@ MP_DEFINE_CONST_FUN_OBJ_1(iodevices_PUPDevice_reset_obj, iodevices_PUPDevice_res
 // dir(pybricks.iodevices.PUPDevice)
 static const mp_rom_map_elem_t iodevices_PUPDevice_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_read),       MP_ROM_PTR(&iodevices_PUPDevice_read_obj) },
+    { MP_ROM_QSTR(MP_QSTR_read_combi), MP_ROM_PTR(&iodevices_PUPDevice_read_combi_obj) },
+    { MP_ROM_QSTR(MP_QSTR_new_data),   MP_ROM_PTR(&iodevices_PUPDevice_new_data_obj) },
     { MP_ROM_QSTR(MP_QSTR_write),      MP_ROM_PTR(&iodevices_PUPDevice_write_obj)},
     { MP_ROM_QSTR(MP_QSTR_info),       MP_ROM_PTR(&iodevices_PUPDevice_info_obj)},
     { MP_ROM_QSTR(MP_QSTR_reset),      MP_ROM_PTR(&iodevices_PUPDevice_reset_obj)},
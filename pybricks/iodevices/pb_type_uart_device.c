@@ -30,10 +30,8 @@ typedef struct _pb_type_uart_device_obj_t {
     uint32_t timeout;
     pbio_os_state_t write_pt;
     mp_obj_t write_obj;
-    mp_obj_t write_awaitables;
     pbio_os_state_t read_pt;
     mp_obj_t read_obj;
-    mp_obj_t read_awaitables;
 } pb_type_uart_device_obj_t;
 
 // pybricks.iodevices.UARTDevice.__init__
@@ -63,10 +61,6 @@ static mp_obj_t pb_type_uart_device_make_new(const mp_obj_type_t *type, size_t n
     pbio_port_set_mode(self->port, PBIO_PORT_MODE_UART);
     pb_assert(pbio_port_get_uart_dev(self->port, &self->uart_dev));
 
-    // List of awaitables associated with reading and writing.
-    self->write_awaitables = mp_obj_new_list(0, NULL);
-    self->read_awaitables = mp_obj_new_list(0, NULL);
-
     return MP_OBJ_FROM_PTR(self);
 }
 
@@ -75,7 +69,7 @@ static bool pb_type_uart_device_write_test_completion(mp_obj_t self_in, uint32_t
     GET_STR_DATA_LEN(self->write_obj, data, data_len);
 
     // Runs one iteration of the write protothread.
-    pbio_error_t err = pbdrv_uart_write(&self->read_pt, self->uart_dev, (uint8_t *)data, data_len, self->timeout);
+    pbio_error_t err = pbdrv_uart_write(&self->write_pt, self->uart_dev, (uint8_t *)data, data_len, self->timeout);
     if (err == PBIO_ERROR_AGAIN) {
         // Not done yet, so return false.
         return false;
@@ -89,6 +83,16 @@ static bool pb_type_uart_device_write_test_completion(mp_obj_t self_in, uint32_t
     return true;
 }
 
+static void pb_type_uart_device_write_cancel(mp_obj_t self_in) {
+    pb_type_uart_device_obj_t *self = MP_OBJ_TO_PTR(self_in);
+
+    // Stop the driver from sending any more of the data and restart the
+    // protothread on the next write.
+    pbdrv_uart_flush(self->uart_dev);
+    self->write_pt = 0;
+    self->write_obj = mp_const_none;
+}
+
 // pybricks.iodevices.UARTDevice.write
 static mp_obj_t pb_type_uart_device_write(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
 
@@ -109,11 +113,11 @@ static mp_obj_t pb_type_uart_device_write(size_t n_args, const mp_obj_t *pos_arg
 
     return pb_type_awaitable_await_or_wait(
         MP_OBJ_FROM_PTR(self),
-        self->write_awaitables,
+        &self->write_obj, // Reading and writing may happen concurrently.
         pb_type_awaitable_end_time_none,
         pb_type_uart_device_write_test_completion,
         pb_type_awaitable_return_none,
-        pb_type_awaitable_cancel_none,
+        pb_type_uart_device_write_cancel,
         PB_TYPE_AWAITABLE_OPT_RAISE_ON_BUSY);
 }
 static MP_DEFINE_CONST_FUN_OBJ_KW(pb_type_uart_device_write_obj, 1, pb_type_uart_device_write);
@@ -151,6 +155,16 @@ static mp_obj_t pb_type_uart_device_read_return_value(mp_obj_t self_in) {
     return ret;
 }
 
+static void pb_type_uart_device_read_cancel(mp_obj_t self_in) {
+    pb_type_uart_device_obj_t *self = MP_OBJ_TO_PTR(self_in);
+
+    // Stop the driver from writing into the read buffer and restart the
+    // protothread on the next read.
+    pbdrv_uart_flush(self->uart_dev);
+    self->read_pt = 0;
+    self->read_obj = mp_const_none;
+}
+
 // pybricks.iodevices.UARTDevice.read
 static mp_obj_t pb_type_uart_device_read(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
 
@@ -167,11 +181,11 @@ static mp_obj_t pb_type_uart_device_read(size_t n_args, const mp_obj_t *pos_args
 
     return pb_type_awaitable_await_or_wait(
         MP_OBJ_FROM_PTR(self),
-        self->read_awaitables,
+        &self->read_obj,
         pb_type_awaitable_end_time_none,
         pb_type_uart_device_read_test_completion,
         pb_type_uart_device_read_return_value,
-        pb_type_awaitable_cancel_none,
+        pb_type_uart_device_read_cancel,
         PB_TYPE_AWAITABLE_OPT_RAISE_ON_BUSY);
 }
 static MP_DEFINE_CONST_FUN_OBJ_KW(pb_type_uart_device_read_obj, 1, pb_type_uart_device_read);
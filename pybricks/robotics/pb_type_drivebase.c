@@ -33,7 +33,6 @@ struct _pb_type_DriveBase_obj_t {
     mp_obj_t heading_control;
     mp_obj_t distance_control;
     #endif
-    mp_obj_t awaitables;
 };
 
 // pybricks.robotics.DriveBase.reset
@@ -78,10 +77,6 @@ static mp_obj_t pb_type_DriveBase_make_new(const mp_obj_type_t *type, size_t n_a
     self->distance_control = pb_type_Control_obj_make_new(&self->db->control_distance);
     #endif
 
-    // List of awaitables associated with this drivebase. By keeping track,
-    // we can cancel them as needed when a new movement is started.
-    self->awaitables = mp_obj_new_list(0, NULL);
-
     return MP_OBJ_FROM_PTR(self);
 }
 
@@ -107,7 +102,7 @@ static void pb_type_DriveBase_cancel(mp_obj_t self_in) {
 static mp_obj_t await_or_wait(pb_type_DriveBase_obj_t *self) {
     return pb_type_awaitable_await_or_wait(
         MP_OBJ_FROM_PTR(self),
-        self->awaitables,
+        self,
         pb_type_awaitable_end_time_none,
         pb_type_DriveBase_test_completion,
         pb_type_awaitable_return_none,
@@ -229,7 +224,7 @@ static mp_obj_t pb_type_DriveBase_drive(size_t n_args, const mp_obj_t *pos_args,
     mp_int_t turn_rate = pb_obj_get_int(turn_rate_in);
 
     // Cancel awaitables but not hardware. Drive forever will handle this.
-    pb_type_awaitable_update_all(self->awaitables, PB_TYPE_AWAITABLE_OPT_CANCEL_ALL);
+    pb_type_awaitable_update_all(self, PB_TYPE_AWAITABLE_OPT_CANCEL_ALL);
 
     pb_assert(pbio_drivebase_drive_forever(self->db, speed, turn_rate));
     return mp_const_none;
@@ -241,7 +236,7 @@ static mp_obj_t pb_type_DriveBase_stop(mp_obj_t self_in) {
 
     // Cancel awaitables.
     pb_type_DriveBase_obj_t *self = MP_OBJ_TO_PTR(self_in);
-    pb_type_awaitable_update_all(self->awaitables, PB_TYPE_AWAITABLE_OPT_CANCEL_ALL);
+    pb_type_awaitable_update_all(self, PB_TYPE_AWAITABLE_OPT_CANCEL_ALL);
 
     // Stop hardware.
     pb_type_DriveBase_cancel(self_in);
@@ -255,7 +250,7 @@ static mp_obj_t pb_type_DriveBase_brake(mp_obj_t self_in) {
 
     // Cancel awaitables.
     pb_type_DriveBase_obj_t *self = MP_OBJ_TO_PTR(self_in);
-    pb_type_awaitable_update_all(self->awaitables, PB_TYPE_AWAITABLE_OPT_CANCEL_ALL);
+    pb_type_awaitable_update_all(self, PB_TYPE_AWAITABLE_OPT_CANCEL_ALL);
 
     // Stop hardware.
     pb_assert(pbio_drivebase_stop(self->db, PBIO_CONTROL_ON_COMPLETION_BRAKE));
@@ -28,6 +28,8 @@ extern const mp_obj_type_t pb_type_app_data;
 
 extern const mp_obj_type_t pb_type_Task;
 
+MP_DECLARE_CONST_FUN_OBJ_2(pb_type_Task_with_timeout_obj);
+
 #endif // PYBRICKS_PY_TOOLS
 
 #endif // PYBRICKS_INCLUDED_PYBRICKS_TOOLS_H
@@ -42,12 +42,6 @@ void pb_module_tools_assert_blocking(void) {
     }
 }
 
-// The awaitables for the wait() function have no object associated with
-// it (unlike e.g. a motor), so we make a starting point here. These never
-// have to cancel each other so shouldn't need to be in a list, but this lets
-// us share the same code with other awaitables. It also minimizes allocation.
-MP_REGISTER_ROOT_POINTER(mp_obj_t wait_awaitables);
-
 static bool pb_module_tools_wait_test_completion(mp_obj_t obj, uint32_t end_time) {
     return mp_hal_ticks_ms() - end_time < UINT32_MAX / 2;
 }
@@ -73,7 +67,7 @@ static mp_obj_t pb_module_tools_wait(size_t n_args, const mp_obj_t *pos_args, mp
 
     return pb_type_awaitable_await_or_wait(
         NULL, // wait functions are not associated with an object
-        MP_STATE_PORT(wait_awaitables),
+        NULL, // and never have to cancel each other
         mp_hal_ticks_ms() + time,
         time > 0 ? pb_module_tools_wait_test_completion : pb_type_awaitable_test_completion_yield_once,
         pb_type_awaitable_return_none,
@@ -129,9 +123,9 @@ void pb_module_tools_pbio_task_do_blocking(pbio_task_t *task, mp_int_t timeout)
 
 // The awaitables associated with pbio tasks can originate from different
 // objects. At the moment, they are only associated with Bluetooth tasks, and
-// they cannot run at the same time. So we keep a single list of awaitables
-// here instead of with each Bluetooth-related MicroPython object.
-MP_REGISTER_ROOT_POINTER(mp_obj_t pbio_task_awaitables);
+// they cannot run at the same time. So we link all of them to this resource
+// instead of to each Bluetooth-related MicroPython object.
+static const uint8_t pbio_task_awaitables_link;
 
 static bool pb_module_tools_pbio_task_test_completion(mp_obj_t obj, uint32_t end_time) {
     pbio_task_t *task = MP_OBJ_TO_PTR(obj);
@@ -146,14 +140,33 @@ static bool pb_module_tools_pbio_task_test_completion(mp_obj_t obj, uint32_t end
     return true;
 }
 
+/**
+ * Cancels a pbio task and waits for the driver to stop using it, so that the
+ * task and the buffers it uses can be reused right away.
+ */
+static void pb_module_tools_pbio_task_cancel(mp_obj_t obj) {
+    pbio_task_t *task = MP_OBJ_TO_PTR(obj);
+
+    pbio_task_cancel(task);
+
+    while (task->status == PBIO_ERROR_AGAIN) {
+        MICROPY_VM_HOOK_LOOP
+
+        // Stop waiting (and potentially blocking) in case of forced shutdown.
+        if (pbsys_status_test(PBIO_PYBRICKS_STATUS_SHUTDOWN_REQUEST)) {
+            break;
+        }
+    }
+}
+
 mp_obj_t pb_module_tools_pbio_task_wait_or_await(pbio_task_t *task) {
     return pb_type_awaitable_await_or_wait(
         MP_OBJ_FROM_PTR(task),
-        MP_STATE_PORT(pbio_task_awaitables),
+        &pbio_task_awaitables_link,
         pb_type_awaitable_end_time_none,
         pb_module_tools_pbio_task_test_completion,
         pb_type_awaitable_return_none,
-        pb_type_awaitable_cancel_none,
+        pb_module_tools_pbio_task_cancel,
         PB_TYPE_AWAITABLE_OPT_RAISE_ON_BUSY);
 }
 
@@ -249,8 +262,7 @@ static MP_DEFINE_CONST_FUN_OBJ_KW(pb_module_tools_run_task_obj, 0, pb_module_too
 
 // Reset global awaitable state when user program starts.
 void pb_module_tools_init(void) {
-    MP_STATE_PORT(wait_awaitables) = mp_obj_new_list(0, NULL);
-    MP_STATE_PORT(pbio_task_awaitables) = mp_obj_new_list(0, NULL);
+    pb_type_awaitable_init();
     run_loop_is_active = false;
 }
 
@@ -367,6 +379,7 @@ static const mp_rom_map_elem_t tools_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR_run_task),    MP_ROM_PTR(&pb_module_tools_run_task_obj)     },
     { MP_ROM_QSTR(MP_QSTR_StopWatch),   MP_ROM_PTR(&pb_type_StopWatch)                },
     { MP_ROM_QSTR(MP_QSTR_multitask),   MP_ROM_PTR(&pb_type_Task)                     },
+    { MP_ROM_QSTR(MP_QSTR_with_timeout), MP_ROM_PTR(&pb_type_Task_with_timeout_obj) },
     #if MICROPY_PY_BUILTINS_FLOAT
     { MP_ROM_QSTR(MP_QSTR_Matrix),      MP_ROM_PTR(&pb_type_Matrix)           },
     { MP_ROM_QSTR(MP_QSTR_vector),      MP_ROM_PTR(&pb_geometry_vector_obj)   },
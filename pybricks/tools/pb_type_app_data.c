@@ -8,7 +8,10 @@
 #include <string.h>
 
 #include <pbsys/command.h>
+#include <pbsys/config.h>
+#include <pbsys/host.h>
 #include <pbdrv/bluetooth.h>
+#include <pbio/int_math.h>
 
 #include "py/mphal.h"
 #include "py/objstr.h"
@@ -26,7 +29,13 @@ typedef struct _pb_type_app_data_obj_t {
     pbdrv_bluetooth_send_context_t tx_context;
     mp_obj_t rx_format;
     mp_obj_str_t rx_bytes_obj;
-    uint8_t tx_buffer[20]; // REVISIT: Could be the negotiated MTU - 3 for better throughput https://github.com/pybricks/support/issues/1727
+    // Big enough for the largest notification. Actual size is limited by
+    // the negotiated MTU.
+    uint8_t tx_buffer[PBSYS_CONFIG_BLUETOOTH_MAX_CHAR_SIZE];
+    // Frame waiting for room in the app data frame queue.
+    bool tx_frame_pending;
+    uint32_t tx_frame_size;
+    uint8_t tx_frame[PBSYS_CONFIG_BLUETOOTH_MAX_CHAR_SIZE];
     uint8_t rx_buffer[] __attribute__((aligned(4)));
 } pb_type_app_data_obj_t;
 
@@ -71,9 +80,11 @@ STATIC mp_obj_t pb_type_app_data_write_bytes(mp_obj_t self_in, mp_obj_t data_in)
     size_t len;
     const char *data = mp_obj_str_get_data(data_in, &len);
 
-    if (len > sizeof(self->tx_buffer) - 1) {
+    // One byte is used for the event type.
+    size_t max_len = pbio_int_math_min(pbdrv_bluetooth_get_mtu() - 3, PBSYS_CONFIG_BLUETOOTH_MAX_CHAR_SIZE) - 1;
+    if (len > max_len) {
         mp_raise_msg_varg(&mp_type_ValueError,
-            MP_ERROR_TEXT("Cannot send more than %d bytes\n"), sizeof(self->tx_buffer) - 1);
+            MP_ERROR_TEXT("Cannot send more than %d bytes\n"), max_len);
     }
 
     memcpy(self->tx_buffer + 1, data, len);
@@ -84,6 +95,72 @@ STATIC mp_obj_t pb_type_app_data_write_bytes(mp_obj_t self_in, mp_obj_t data_in)
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_2(pb_type_app_data_write_bytes_obj, pb_type_app_data_write_bytes);
 
+STATIC bool pb_type_app_data_write_frame_test_completion(mp_obj_t self_in, uint32_t end_time) {
+    pb_type_app_data_obj_t *self = MP_OBJ_TO_PTR(self_in);
+
+    // Keep trying until there is room in the queue. On other errors such as
+    // a lost connection, the frame is dropped, just like printed output.
+    if (self->tx_frame_pending) {
+        self->tx_frame_pending = pbsys_host_app_data_tx(self->tx_frame, self->tx_frame_size) == PBIO_ERROR_AGAIN;
+    }
+    return !self->tx_frame_pending;
+}
+
+STATIC void pb_type_app_data_write_frame_cancel(mp_obj_t self_in) {
+    pb_type_app_data_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    self->tx_frame_pending = false;
+}
+
+STATIC mp_obj_t pb_type_app_data_write_frame(mp_obj_t self_in, mp_obj_t data_in) {
+    pb_type_app_data_obj_t *self = MP_OBJ_TO_PTR(self_in);
+
+    size_t len;
+    const char *data = mp_obj_str_get_data(data_in, &len);
+
+    size_t max_len = pbio_int_math_min(pbsys_host_app_data_tx_get_max_size(), sizeof(self->tx_frame));
+    if (len > max_len) {
+        mp_raise_msg_varg(&mp_type_ValueError,
+            MP_ERROR_TEXT("Cannot send more than %d bytes\n"), max_len);
+    }
+
+    // Only one frame can wait for room at a time.
+    if (self->tx_frame_pending) {
+        pb_assert(PBIO_ERROR_BUSY);
+    }
+
+    // Copy data to local buffer so it can be queued once there is room.
+    memcpy(self->tx_frame, data, len);
+    self->tx_frame_size = len;
+    self->tx_frame_pending = true;
+
+    // Queue right away if possible, so frames are not delayed until awaited.
+    pb_type_app_data_write_frame_test_completion(self_in, 0);
+
+    return pb_type_awaitable_await_or_wait(
+        MP_OBJ_FROM_PTR(self),
+        self,
+        0,
+        pb_type_app_data_write_frame_test_completion,
+        pb_type_awaitable_return_none,
+        pb_type_app_data_write_frame_cancel,
+        PB_TYPE_AWAITABLE_OPT_NONE);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_2(pb_type_app_data_write_frame_obj, pb_type_app_data_write_frame);
+
+STATIC mp_obj_t pb_type_app_data_read_frame(mp_obj_t self_in) {
+    uint8_t frame[UINT8_MAX];
+    uint32_t size = sizeof(frame);
+
+    pbio_error_t err = pbsys_host_app_data_rx(frame, &size);
+    if (err == PBIO_ERROR_AGAIN) {
+        return mp_const_none;
+    }
+    pb_assert(err);
+
+    return mp_obj_new_bytes(frame, size);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(pb_type_app_data_read_frame_obj, pb_type_app_data_read_frame);
+
 static const mp_obj_str_t pb_const_empty_str_obj = {{&mp_type_str}, 0, 0, (const byte *)""};
 
 STATIC mp_obj_t pb_type_app_data_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args) {
@@ -112,12 +189,14 @@ STATIC mp_obj_t pb_type_app_data_make_new(const mp_obj_type_t *type, size_t n_ar
 
     // Activate callback now that we have allocated the rx_buffer.
     pbsys_command_set_write_app_data_callback(handle_incoming_app_data);
+    pbsys_host_app_data_set_enabled(true);
 
     // Prepare tx context. Only the length and data is variable.
     app_data_instance->tx_context.done = NULL;
     app_data_instance->tx_context.connection = PBDRV_BLUETOOTH_CONNECTION_PYBRICKS;
     app_data_instance->tx_context.data = app_data_instance->tx_buffer;
     app_data_instance->tx_buffer[0] = PBIO_PYBRICKS_EVENT_WRITE_APP_DATA;
+    app_data_instance->tx_frame_pending = false;
 
     return MP_OBJ_FROM_PTR(app_data_instance);
 }
@@ -125,6 +204,7 @@ STATIC mp_obj_t pb_type_app_data_make_new(const mp_obj_type_t *type, size_t n_ar
 mp_obj_t pb_type_app_data_close(mp_obj_t stream) {
     if (app_data_instance) {
         pbsys_command_set_write_app_data_callback(NULL);
+        pbsys_host_app_data_set_enabled(false);
         app_data_instance = NULL;
     }
     return mp_const_none;
@@ -136,7 +216,9 @@ STATIC const mp_rom_map_elem_t pb_type_app_data_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_close),        MP_ROM_PTR(&pb_type_app_data_close_obj) },
     { MP_ROM_QSTR(MP_QSTR_get_bytes),    MP_ROM_PTR(&pb_type_app_data_get_bytes_obj) },
     { MP_ROM_QSTR(MP_QSTR_get_values),   MP_ROM_PTR(&pb_type_app_data_get_values_obj) },
+    { MP_ROM_QSTR(MP_QSTR_read_frame),   MP_ROM_PTR(&pb_type_app_data_read_frame_obj) },
     { MP_ROM_QSTR(MP_QSTR_write_bytes),    MP_ROM_PTR(&pb_type_app_data_write_bytes_obj) },
+    { MP_ROM_QSTR(MP_QSTR_write_frame),  MP_ROM_PTR(&pb_type_app_data_write_frame_obj) },
 };
 STATIC MP_DEFINE_CONST_DICT(pb_type_app_data_locals_dict, pb_type_app_data_locals_dict_table);
 
@@ -5,6 +5,7 @@
 
 #if PYBRICKS_PY_TOOLS
 
+#include "py/mperrno.h"
 #include "py/mphal.h"
 #include "py/mpstate.h"
 #include "py/obj.h"
@@ -22,11 +23,26 @@ struct _pb_type_awaitable_obj_t {
      * Object associated with this awaitable, such as the motor we wait on.
      */
     mp_obj_t obj;
+    /**
+     * Identifies the resource shared by linked awaitables, such as the motor
+     * object. Awaitables with the same link can cancel each other.
+     */
+    const void *link;
     /**
      * End time. Gets passed to completion test to allow for graceful timeout
-     * or raise timeout errors if desired.
+     * or raise timeout errors if desired. Completion tests that don't need a
+     * time may use it for other state of this awaitable, such as a count.
      */
     uint32_t end_time;
+    /**
+     * Wall time in milliseconds after which the operation is cancelled and
+     * raises a timeout error. Only used if has_deadline is set.
+     */
+    uint32_t deadline;
+    /**
+     * Whether a deadline was set for this awaitable.
+     */
+    bool has_deadline;
     /**
      * Tests if operation is complete. Gets reset to AWAITABLE_FREE
      * on completion, which means that it can be used again.
@@ -42,14 +58,32 @@ struct _pb_type_awaitable_obj_t {
     pb_type_awaitable_cancel_t cancel;
 };
 
+/**
+ * Marks the awaitable as free to be reused. This also drops the references to
+ * the object it was used for, so that the pool does not keep it alive.
+ */
+static void pb_type_awaitable_release(pb_type_awaitable_obj_t *self) {
+    self->test_completion = AWAITABLE_FREE;
+    self->obj = MP_OBJ_NULL;
+    self->link = NULL;
+    self->return_value = NULL;
+    self->cancel = NULL;
+}
+
 // close() cancels the awaitable.
 static mp_obj_t pb_type_awaitable_close(mp_obj_t self_in) {
     pb_type_awaitable_obj_t *self = MP_OBJ_TO_PTR(self_in);
-    self->test_completion = AWAITABLE_FREE;
+
+    // Nothing to cancel if already completed.
+    if (self->test_completion == AWAITABLE_FREE) {
+        return mp_const_none;
+    }
+
     // Handle optional clean up/cancelling of hardware operation.
     if (self->cancel) {
         self->cancel(self->obj);
     }
+    pb_type_awaitable_release(self);
     return mp_const_none;
 }
 static MP_DEFINE_CONST_FUN_OBJ_1(pb_type_awaitable_close_obj, pb_type_awaitable_close);
@@ -91,21 +125,33 @@ static mp_obj_t pb_type_awaitable_iternext(mp_obj_t self_in) {
         self->test_completion = pb_type_awaitable_test_completion_completed;
     }
 
-    // Keep going if not completed by returning None.
     if (!complete) {
+        // Cancel the operation if it is still running after the deadline.
+        // Like close(), this calls the cancel function to stop the hardware,
+        // if any. This is checked after the completion test, so awaitables
+        // that were already gracefully cancelled by a newer operation don't
+        // stop that operation.
+        if (self->has_deadline && mp_hal_ticks_ms() - self->deadline < UINT32_MAX / 2) {
+            pb_type_awaitable_close(self_in);
+            mp_raise_OSError(MP_ETIMEDOUT);
+        }
+
+        // Keep going if not completed by returning None.
         return mp_const_none;
     }
 
-    // Complete, so unset callback.
-    self->test_completion = AWAITABLE_FREE;
+    // Complete, so the awaitable can be reused.
+    mp_obj_t obj = self->obj;
+    pb_type_awaitable_return_t return_value = self->return_value;
+    pb_type_awaitable_release(self);
 
     // For no return value, return basic stop iteration.
-    if (!self->return_value) {
+    if (!return_value) {
         return MP_OBJ_STOP_ITERATION;
     }
 
     // Otherwise, set return value via stop iteration.
-    return mp_make_stop_iteration(self->return_value(self->obj));
+    return mp_make_stop_iteration(return_value(obj));
 }
 
 static const mp_rom_map_elem_t pb_type_awaitable_locals_dict_table[] = {
@@ -121,17 +167,46 @@ MP_DEFINE_CONST_OBJ_TYPE(pb_type_awaitable,
     iter, pb_type_awaitable_iternext,
     locals_dict, &pb_type_awaitable_locals_dict);
 
+// All awaitables are kept in a single pool that is shared by all objects.
+// Awaitables are reused once completed, so new ones are only allocated when
+// more operations run concurrently than ever before in this program. This
+// means that long-running async programs do not keep allocating memory.
+MP_REGISTER_ROOT_POINTER(mp_obj_t awaitable_pool);
+
+// Number of awaitables allocated up front when the pool is first used. This
+// is enough for a few motors, a drive base, and some waits in parallel.
+#define AWAITABLE_POOL_SIZE_INITIAL (8)
+
 /**
- * Gets an awaitable object that is not in use, or makes a new one.
+ * Allocates a new awaitable and adds it to the pool.
+ */
+static pb_type_awaitable_obj_t *pb_type_awaitable_new(void) {
+    pb_type_awaitable_obj_t *awaitable = mp_obj_malloc(pb_type_awaitable_obj_t, &pb_type_awaitable);
+    awaitable->test_completion = AWAITABLE_FREE;
+    mp_obj_list_append(MP_STATE_PORT(awaitable_pool), MP_OBJ_FROM_PTR(awaitable));
+    return awaitable;
+}
+
+/**
+ * Resets the awaitable pool. Called when the user program starts.
  *
- * @param [in] awaitables_in        List of awaitables associated with @p obj.
+ * This does not allocate the awaitables themselves, so programs that do not
+ * use the run loop do not spend memory on them.
  */
-static pb_type_awaitable_obj_t *pb_type_awaitable_get(mp_obj_t awaitables_in) {
+void pb_type_awaitable_init(void) {
+    MP_STATE_PORT(awaitable_pool) = mp_obj_new_list(0, NULL);
+}
 
-    mp_obj_list_t *awaitables = MP_OBJ_TO_PTR(awaitables_in);
+/**
+ * Gets an awaitable object from the pool that is not in use, or makes a new
+ * one if all of them are busy.
+ */
+static pb_type_awaitable_obj_t *pb_type_awaitable_get(void) {
 
-    for (size_t i = 0; i < awaitables->len; i++) {
-        pb_type_awaitable_obj_t *awaitable = MP_OBJ_TO_PTR(awaitables->items[i]);
+    mp_obj_list_t *pool = MP_OBJ_TO_PTR(MP_STATE_PORT(awaitable_pool));
+
+    for (size_t i = 0; i < pool->len; i++) {
+        pb_type_awaitable_obj_t *awaitable = MP_OBJ_TO_PTR(pool->items[i]);
 
         // Return awaitable if it is not in use.
         if (awaitable->test_completion == AWAITABLE_FREE) {
@@ -139,36 +214,57 @@ static pb_type_awaitable_obj_t *pb_type_awaitable_get(mp_obj_t awaitables_in) {
         }
     }
 
-    // Otherwise allocate a new one.
-    pb_type_awaitable_obj_t *awaitable = mp_obj_malloc(pb_type_awaitable_obj_t, &pb_type_awaitable);
-    awaitable->test_completion = AWAITABLE_FREE;
+    // On first use, fill the pool so the first few operations do not each
+    // have to allocate. After that, only grow the pool one at a time.
+    while (pool->len + 1 < AWAITABLE_POOL_SIZE_INITIAL) {
+        pb_type_awaitable_new();
+    }
+    return pb_type_awaitable_new();
+}
 
-    // Add to list of awaitables.
-    mp_obj_list_append(awaitables_in, MP_OBJ_FROM_PTR(awaitable));
+/**
+ * Tests if an object is an awaitable from the pool.
+ *
+ * @param [in] obj                   The object to test.
+ * @return                           True if @p obj is a pbio awaitable.
+ */
+bool pb_type_awaitable_is_awaitable(mp_obj_t obj) {
+    return mp_obj_is_type(obj, &pb_type_awaitable);
+}
 
-    return awaitable;
+/**
+ * Sets a deadline for an awaitable that is in progress. If the operation is
+ * not complete by then, it is cancelled and raises a timeout error.
+ *
+ * @param [in] awaitable_in          The awaitable.
+ * @param [in] timeout               Time in milliseconds from now.
+ */
+void pb_type_awaitable_set_timeout(mp_obj_t awaitable_in, uint32_t timeout) {
+    pb_type_awaitable_obj_t *awaitable = MP_OBJ_TO_PTR(awaitable_in);
+    awaitable->deadline = mp_hal_ticks_ms() + timeout;
+    awaitable->has_deadline = true;
 }
 
 /**
- * Checks and updates all awaitables associated with an object.
+ * Checks and updates all awaitables associated with a resource.
  *
- * @param [in] awaitables_in         List of awaitables associated with @p obj.
+ * @param [in] link                  The resource shared by linked awaitables.
  * @param [in] options               Controls update behavior.
  */
-void pb_type_awaitable_update_all(mp_obj_t awaitables_in, pb_type_awaitable_opt_t options) {
+void pb_type_awaitable_update_all(const void *link, pb_type_awaitable_opt_t options) {
 
     // Exit if nothing to do.
     if (!pb_module_tools_run_loop_is_active() || options == PB_TYPE_AWAITABLE_OPT_NONE) {
         return;
     }
 
-    mp_obj_list_t *awaitables = MP_OBJ_TO_PTR(awaitables_in);
+    mp_obj_list_t *pool = MP_OBJ_TO_PTR(MP_STATE_PORT(awaitable_pool));
 
-    for (size_t i = 0; i < awaitables->len; i++) {
-        pb_type_awaitable_obj_t *awaitable = MP_OBJ_TO_PTR(awaitables->items[i]);
+    for (size_t i = 0; i < pool->len; i++) {
+        pb_type_awaitable_obj_t *awaitable = MP_OBJ_TO_PTR(pool->items[i]);
 
-        // Skip awaitables that are not in use.
-        if (!awaitable->test_completion) {
+        // Skip awaitables that are not in use or belong to something else.
+        if (!awaitable->test_completion || awaitable->link != link) {
             continue;
         }
 
@@ -196,9 +292,11 @@ void pb_type_awaitable_update_all(mp_obj_t awaitables_in, pb_type_awaitable_opt_
  * Automatically cancels any previous awaitables associated with the object if requested.
  *
  * @param [in] obj                   The object whose method we want to wait for completion.
- * @param [in] awaitables_in         List of awaitables associated with @p obj.
+ * @param [in] link                  The resource shared by linked awaitables,
+ *                                   usually the same as @p obj.
  * @param [in] end_time              Wall time in milliseconds when the operation should end.
- *                                   May be arbitrary if completion function does not need it.
+ *                                   May be arbitrary if completion function does not need it,
+ *                                   or hold other state that the completion test compares with.
  * @param [in] test_completion_func  Function to test if the operation is complete.
  * @param [in] return_value_func     Function that gets the return value for the awaitable.
  * @param [in] cancel_func           Function to cancel the hardware operation.
@@ -206,7 +304,7 @@ void pb_type_awaitable_update_all(mp_obj_t awaitables_in, pb_type_awaitable_opt_
  */
 mp_obj_t pb_type_awaitable_await_or_wait(
     mp_obj_t obj,
-    mp_obj_t awaitables_in,
+    const void *link,
     uint32_t end_time,
     pb_type_awaitable_test_completion_t test_completion_func,
     pb_type_awaitable_return_t return_value_func,
@@ -222,17 +320,19 @@ mp_obj_t pb_type_awaitable_await_or_wait(
         }
 
         // First cancel linked awaitables if requested.
-        pb_type_awaitable_update_all(awaitables_in, options);
+        pb_type_awaitable_update_all(link, options);
 
-        // Gets free existing awaitable or creates a new one.
-        pb_type_awaitable_obj_t *awaitable = pb_type_awaitable_get(awaitables_in);
+        // Gets free existing awaitable from the pool.
+        pb_type_awaitable_obj_t *awaitable = pb_type_awaitable_get();
 
         // Initialize awaitable.
         awaitable->obj = obj;
+        awaitable->link = link;
         awaitable->test_completion = test_completion_func;
         awaitable->return_value = return_value_func;
         awaitable->cancel = cancel_func;
         awaitable->end_time = end_time;
+        awaitable->has_deadline = false;
         return MP_OBJ_FROM_PTR(awaitable);
     }
 
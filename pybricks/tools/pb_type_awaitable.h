@@ -84,11 +84,17 @@ typedef void (*pb_type_awaitable_cancel_t)(mp_obj_t obj);
 
 bool pb_type_awaitable_test_completion_yield_once(mp_obj_t obj, uint32_t end_time);
 
-void pb_type_awaitable_update_all(mp_obj_t awaitables_in, pb_type_awaitable_opt_t options);
+void pb_type_awaitable_init(void);
+
+bool pb_type_awaitable_is_awaitable(mp_obj_t obj);
+
+void pb_type_awaitable_set_timeout(mp_obj_t awaitable_in, uint32_t timeout);
+
+void pb_type_awaitable_update_all(const void *link, pb_type_awaitable_opt_t options);
 
 mp_obj_t pb_type_awaitable_await_or_wait(
     mp_obj_t obj,
-    mp_obj_t awaitables_in,
+    const void *link,
     uint32_t end_time,
     pb_type_awaitable_test_completion_t test_completion_func,
     pb_type_awaitable_return_t return_value_func,
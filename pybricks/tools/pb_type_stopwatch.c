@@ -7,6 +7,7 @@
 
 #include "py/mphal.h"
 
+#include <pybricks/common.h>
 #include <pybricks/tools.h>
 
 #include <pybricks/util_mp/pb_kwarg_helper.h>
@@ -19,11 +20,32 @@ typedef struct _tools_StopWatch_obj_t {
     uint32_t time_stop;
     uint32_t time_spent_pausing;
     bool running;
+    bool synced;
 } tools_StopWatch_obj_t;
 
+/**
+ * Gets the current time of the clock used by this stopwatch.
+ *
+ * @param [in]  self    The stopwatch.
+ * @returns             The local time, or the time shared by hubs if synced.
+ * @throws RuntimeError If synced but the clock is not synchronized yet.
+ */
+static uint32_t tools_StopWatch_get_clock(tools_StopWatch_obj_t *self) {
+    #if PYBRICKS_PY_COMMON_BLE
+    uint32_t time;
+    if (self->synced) {
+        if (!pb_type_ble_get_synced_time(&time)) {
+            mp_raise_msg(&mp_type_RuntimeError, MP_ERROR_TEXT("clock not synchronized"));
+        }
+        return time;
+    }
+    #endif
+    return mp_hal_ticks_ms();
+}
+
 static mp_obj_t tools_StopWatch_reset(mp_obj_t self_in) {
     tools_StopWatch_obj_t *self = MP_OBJ_TO_PTR(self_in);
-    self->time_start = mp_hal_ticks_ms();
+    self->time_start = tools_StopWatch_get_clock(self);
     self->time_stop = self->time_start;
     self->time_spent_pausing = 0;
     return mp_const_none;
@@ -34,7 +56,7 @@ static mp_obj_t tools_StopWatch_time(mp_obj_t self_in) {
     tools_StopWatch_obj_t *self = MP_OBJ_TO_PTR(self_in);
     return mp_obj_new_int_from_uint(
         self->running ?
-        mp_hal_ticks_ms() - self->time_start - self->time_spent_pausing :
+        tools_StopWatch_get_clock(self) - self->time_start - self->time_spent_pausing :
         self->time_stop - self->time_start - self->time_spent_pausing);
 }
 static MP_DEFINE_CONST_FUN_OBJ_1(tools_StopWatch_time_obj, tools_StopWatch_time);
@@ -43,7 +65,7 @@ static mp_obj_t tools_StopWatch_pause(mp_obj_t self_in) {
     tools_StopWatch_obj_t *self = MP_OBJ_TO_PTR(self_in);
     if (self->running) {
         self->running = false;
-        self->time_stop = mp_hal_ticks_ms();
+        self->time_stop = tools_StopWatch_get_clock(self);
     }
     return mp_const_none;
 }
@@ -59,15 +81,36 @@ static mp_obj_t tools_StopWatch_resume(mp_obj_t self_in) {
     tools_StopWatch_obj_t *self = MP_OBJ_TO_PTR(self_in);
     if (!self->running) {
         self->running = true;
-        self->time_spent_pausing += mp_hal_ticks_ms() - self->time_stop;
+        self->time_spent_pausing += tools_StopWatch_get_clock(self) - self->time_stop;
     }
     return mp_const_none;
 }
 static MP_DEFINE_CONST_FUN_OBJ_1(tools_StopWatch_resume_obj, tools_StopWatch_resume);
 
 static mp_obj_t tools_StopWatch_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args) {
+    PB_PARSE_ARGS_CLASS(n_args, n_kw, args,
+        PB_ARG_DEFAULT_FALSE(synced));
+
     tools_StopWatch_obj_t *self = m_new_obj(tools_StopWatch_obj_t);
     self->base.type = type;
+    self->synced = mp_obj_is_true(synced_in);
+
+    #if !PYBRICKS_PY_COMMON_BLE
+    if (self->synced) {
+        mp_raise_ValueError(MP_ERROR_TEXT("synced clock not supported on this hub"));
+    }
+    #endif
+
+    // A synced stopwatch gives the time shared by all synced hubs, so it
+    // starts at zero instead of the current time.
+    if (self->synced) {
+        self->time_start = 0;
+        self->time_stop = 0;
+        self->time_spent_pausing = 0;
+        self->running = true;
+        return MP_OBJ_FROM_PTR(self);
+    }
+
     self->running = false;
     tools_StopWatch_reset(MP_OBJ_FROM_PTR(self));
     tools_StopWatch_resume(MP_OBJ_FROM_PTR(self));
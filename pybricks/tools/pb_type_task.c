@@ -6,9 +6,14 @@
 #if PYBRICKS_PY_TOOLS
 
 #include "py/builtin.h"
+#include "py/mperrno.h"
+#include "py/mphal.h"
 #include "py/objmodule.h"
+#include "py/objtuple.h"
 #include "py/runtime.h"
 
+#include <pbio/int_math.h>
+
 #include <pybricks/parameters.h>
 #include <pybricks/common.h>
 #include <pybricks/tools.h>
@@ -21,7 +26,6 @@
  */
 typedef struct {
     mp_obj_t arg;
-    mp_obj_t return_val;
     mp_obj_iter_buf_t iter_buf;
     mp_obj_t iterable;
     bool done;
@@ -41,6 +45,24 @@ typedef struct {
      * The tasks managed by this all or race awaitable.
      */
     pb_type_Task_progress_t *tasks;
+    /**
+     * The return values of all tasks. This is allocated up front so that
+     * completing the collection does not allocate.
+     */
+    mp_obj_tuple_t *return_vals;
+    /**
+     * Wall time in milliseconds after which all tasks are cancelled and the
+     * collection raises a timeout error. Only used if has_deadline is set.
+     */
+    uint32_t deadline;
+    /**
+     * Whether a deadline was set for this collection.
+     */
+    bool has_deadline;
+    /**
+     * Whether to return the value of the only task instead of a tuple.
+     */
+    bool unpack;
 } pb_type_Task_obj_t;
 
 // Cancel all tasks by calling their close methods.
@@ -95,7 +117,7 @@ static mp_obj_t pb_type_Task_iternext(mp_obj_t self_in) {
             // Task is done, save return value.
             if (result == MP_OBJ_STOP_ITERATION) {
                 if (MP_STATE_THREAD(stop_iteration_arg) != MP_OBJ_NULL) {
-                    task->return_val = MP_STATE_THREAD(stop_iteration_arg);
+                    self->return_vals->items[i] = MP_STATE_THREAD(stop_iteration_arg);
                 }
                 task->done = true;
                 done_total++;
@@ -112,17 +134,21 @@ static mp_obj_t pb_type_Task_iternext(mp_obj_t self_in) {
         // Successfully did one iteration of all tasks.
         nlr_pop();
 
-        // If collection not done yet, indicate that it should run again.
+        // If collection not done yet, indicate that it should run again,
+        // unless it ran out of time.
         if (done_total < self->num_tasks_required) {
+            if (self->has_deadline && mp_hal_ticks_ms() - self->deadline < UINT32_MAX / 2) {
+                pb_type_Task_close(self_in);
+                mp_raise_OSError(MP_ETIMEDOUT);
+            }
             return mp_const_none;
         }
 
         // Otherwise raise StopIteration with return values.
-        mp_obj_t *ret = m_new(mp_obj_t, self->num_tasks);
-        for (size_t i = 0; i < self->num_tasks; i++) {
-            ret[i] = self->tasks[i].return_val;
+        if (self->unpack) {
+            return mp_make_stop_iteration(self->return_vals->items[0]);
         }
-        return mp_make_stop_iteration(mp_obj_new_tuple(self->num_tasks, ret));
+        return mp_make_stop_iteration(MP_OBJ_FROM_PTR(self->return_vals));
     } else {
         // On failure of one task, cancel others, then stop iterating collection by re-raising.
         pb_type_Task_close(self_in);
@@ -135,25 +161,79 @@ static const mp_rom_map_elem_t pb_type_Task_locals_dict_table[] = {
 };
 MP_DEFINE_CONST_DICT(pb_type_Task_locals_dict, pb_type_Task_locals_dict_table);
 
-static mp_obj_t pb_type_Task_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args) {
-
-    // Whether to race until one task is done (True) or wait for all tasks (False).
-    bool race = n_kw == 1 && mp_obj_is_true(args[n_args - 1]);
+/**
+ * Creates a collection of tasks.
+ *
+ * @param [in]  type        The type of the collection.
+ * @param [in]  n_args      The number of tasks.
+ * @param [in]  args        The tasks.
+ * @param [in]  race        Whether to race until one task is done (True) or
+ *                          wait for all tasks (False).
+ * @param [in]  timeout_in  Time in milliseconds after which all tasks are
+ *                          cancelled, or None to wait forever.
+ * @param [in]  unpack      Whether to return the value of the first task
+ *                          instead of a tuple of all values.
+ * @returns                 The collection.
+ */
+static mp_obj_t pb_type_Task_new_collection(const mp_obj_type_t *type, size_t n_args, const mp_obj_t *args, bool race, mp_obj_t timeout_in, bool unpack) {
 
     pb_type_Task_obj_t *self = mp_obj_malloc(pb_type_Task_obj_t, type);
     self->num_tasks = n_args;
+    self->unpack = unpack;
     self->num_tasks_required = race ? 1 : n_args;
+    self->has_deadline = timeout_in != mp_const_none;
+    if (self->has_deadline) {
+        self->deadline = mp_hal_ticks_ms() + pbio_int_math_max(pb_obj_get_int(timeout_in), 0);
+    }
     self->tasks = m_new(pb_type_Task_progress_t, n_args);
+    self->return_vals = MP_OBJ_TO_PTR(mp_obj_new_tuple(n_args, NULL));
     for (size_t i = 0; i < n_args; i++) {
         pb_type_Task_progress_t *task = &self->tasks[i];
         task->arg = args[i];
-        task->return_val = mp_const_none;
+        self->return_vals->items[i] = mp_const_none;
         task->iterable = mp_getiter(args[i], &task->iter_buf);
         task->done = false;
     }
     return MP_OBJ_FROM_PTR(self);
 }
 
+static mp_obj_t pb_type_Task_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args) {
+
+    mp_map_t kw_args;
+    mp_map_init_fixed_table(&kw_args, n_kw, args + n_args);
+
+    // Whether to race until one task is done (True) or wait for all tasks (False).
+    mp_map_elem_t *race = mp_map_lookup(&kw_args, MP_OBJ_NEW_QSTR(MP_QSTR_race), MP_MAP_LOOKUP);
+
+    // Optional time after which all tasks are cancelled.
+    mp_map_elem_t *timeout = mp_map_lookup(&kw_args, MP_OBJ_NEW_QSTR(MP_QSTR_timeout), MP_MAP_LOOKUP);
+
+    // Tasks are positional, so any other keyword is a mistake.
+    if (n_kw != (race != NULL) + (timeout != NULL)) {
+        mp_raise_TypeError(MP_ERROR_TEXT("unexpected keyword argument"));
+    }
+
+    return pb_type_Task_new_collection(type, n_args, args,
+        race && mp_obj_is_true(race->value),
+        timeout ? timeout->value : mp_const_none,
+        false);
+}
+
+// pybricks.tools.with_timeout
+static mp_obj_t pb_type_Task_with_timeout(mp_obj_t task_in, mp_obj_t timeout_in) {
+
+    // Motors, sensors, and other awaitables can cancel themselves, so no
+    // additional collection needs to be allocated to run them.
+    if (pb_type_awaitable_is_awaitable(task_in)) {
+        pb_type_awaitable_set_timeout(task_in, pbio_int_math_max(pb_obj_get_int(timeout_in), 0));
+        return task_in;
+    }
+
+    // Anything else, such as a coroutine, is run as a collection of one.
+    return pb_type_Task_new_collection(&pb_type_Task, 1, &task_in, false, timeout_in, true);
+}
+MP_DEFINE_CONST_FUN_OBJ_2(pb_type_Task_with_timeout_obj, pb_type_Task_with_timeout);
+
 MP_DEFINE_CONST_OBJ_TYPE(pb_type_Task,
     MP_QSTR_Task,
     MP_TYPE_FLAG_ITER_IS_ITERNEXT,
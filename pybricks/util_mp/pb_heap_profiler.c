@@ -0,0 +1,256 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2025 The Pybricks Authors
+
+// Records where and how much the MicroPython heap is used.
+//
+// The MicroPython allocation functions are wrapped at link time (see
+// PB_HEAP_PROFILER in arm_none_eabi.mk), so every call to m_malloc and
+// friends from any object file, including the m_new and mp_obj_malloc
+// macros, passes through here. Sites are identified by the return address of
+// the caller, which can be looked up in the firmware.elf with addr2line.
+//
+// Only a fixed number of sites is kept. When the table is full, a new site
+// replaces the one with the fewest bytes and takes over its counts, like the
+// space-saving algorithm for finding the most frequent items. So sites that
+// allocate a lot are kept even if they are first used long after the sites
+// used while loading the program. The counts of a site that replaced another
+// one are an upper bound.
+
+#include "py/mpconfig.h"
+
+#if PYBRICKS_OPT_HEAP_PROFILER
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "py/gc.h"
+#include "py/misc.h"
+#include "py/obj.h"
+#include "py/runtime.h"
+
+#include <pybricks/util_mp/pb_heap_profiler.h>
+
+typedef struct {
+    // Return address of the call to the allocator.
+    uintptr_t address;
+    // Number of allocations made here.
+    uint32_t count;
+    // Total number of bytes requested here.
+    uint32_t bytes;
+} pb_heap_profiler_site_t;
+
+typedef struct {
+    uint32_t gc_count;
+    uint32_t gc_time_total;
+    uint32_t gc_time_max;
+    uint32_t alloc_count;
+    uint32_t alloc_bytes;
+    uint32_t alloc_max;
+    uint32_t alloc_failed;
+    // Number of times a site replaced another one because the table was full.
+    uint32_t sites_evicted;
+    uint32_t num_sites;
+    pb_heap_profiler_site_t sites[PB_HEAP_PROFILER_NUM_SITES];
+} pb_heap_profiler_t;
+
+static pb_heap_profiler_t profiler;
+
+// Return address of the caller of mp_obj_malloc_helper, while it is running.
+static uintptr_t helper_address;
+
+void pb_heap_profiler_reset(void) {
+    memset(&profiler, 0, sizeof(profiler));
+    helper_address = 0;
+}
+
+void pb_heap_profiler_add_gc_pause(uint32_t duration) {
+    profiler.gc_count++;
+    profiler.gc_time_total += duration;
+    if (duration > profiler.gc_time_max) {
+        profiler.gc_time_max = duration;
+    }
+}
+
+static void pb_heap_profiler_add_alloc(uintptr_t address, size_t num_bytes, void *ptr) {
+
+    if (!ptr) {
+        profiler.alloc_failed++;
+        return;
+    }
+
+    profiler.alloc_count++;
+    profiler.alloc_bytes += num_bytes;
+    if (num_bytes > profiler.alloc_max) {
+        profiler.alloc_max = num_bytes;
+    }
+
+    // Clear the Thumb bit so the address matches the disassembly.
+    address &= ~(uintptr_t)1;
+
+    pb_heap_profiler_site_t *smallest = &profiler.sites[0];
+    for (uint32_t i = 0; i < profiler.num_sites; i++) {
+        pb_heap_profiler_site_t *site = &profiler.sites[i];
+        if (site->address == address) {
+            site->count++;
+            site->bytes += num_bytes;
+            return;
+        }
+        if (site->bytes < smallest->bytes) {
+            smallest = site;
+        }
+    }
+
+    if (profiler.num_sites < PB_HEAP_PROFILER_NUM_SITES) {
+        profiler.sites[profiler.num_sites++] = (pb_heap_profiler_site_t) {
+            .address = address,
+            .count = 1,
+            .bytes = num_bytes,
+        };
+        return;
+    }
+
+    // Table is full, so replace the site with the fewest bytes.
+    profiler.sites_evicted++;
+    smallest->address = address;
+    smallest->count++;
+    smallest->bytes += num_bytes;
+}
+
+/**
+ * Gets the address to record for an allocation made by the allocator that
+ * was called from @p return_address.
+ *
+ * Objects made with mp_obj_malloc and mp_obj_malloc_var all call m_malloc
+ * from the same place in mp_obj_malloc_helper, so those are recorded at
+ * the caller of the helper instead. This is cleared before the allocation
+ * is made, so it doesn't stick if the allocation raises MemoryError.
+ */
+static uintptr_t pb_heap_profiler_get_address(uintptr_t return_address) {
+    uintptr_t address = helper_address ? helper_address : return_address;
+    helper_address = 0;
+    return address;
+}
+
+#define RETURN_ADDRESS ((uintptr_t)__builtin_return_address(0))
+
+void *__real_mp_obj_malloc_helper(size_t num_bytes, const mp_obj_type_t *type);
+
+void *__wrap_mp_obj_malloc_helper(size_t num_bytes, const mp_obj_type_t *type) {
+    helper_address = RETURN_ADDRESS;
+    return __real_mp_obj_malloc_helper(num_bytes, type);
+}
+
+void *__real_m_malloc(size_t num_bytes);
+void *__real_m_malloc_maybe(size_t num_bytes);
+void *__real_m_malloc0(size_t num_bytes);
+
+void *__wrap_m_malloc(size_t num_bytes) {
+    uintptr_t address = pb_heap_profiler_get_address(RETURN_ADDRESS);
+    void *ptr = __real_m_malloc(num_bytes);
+    pb_heap_profiler_add_alloc(address, num_bytes, ptr);
+    return ptr;
+}
+
+void *__wrap_m_malloc_maybe(size_t num_bytes) {
+    uintptr_t address = pb_heap_profiler_get_address(RETURN_ADDRESS);
+    void *ptr = __real_m_malloc_maybe(num_bytes);
+    pb_heap_profiler_add_alloc(address, num_bytes, ptr);
+    return ptr;
+}
+
+void *__wrap_m_malloc0(size_t num_bytes) {
+    uintptr_t address = pb_heap_profiler_get_address(RETURN_ADDRESS);
+    void *ptr = __real_m_malloc0(num_bytes);
+    pb_heap_profiler_add_alloc(address, num_bytes, ptr);
+    return ptr;
+}
+
+#if MICROPY_ENABLE_FINALISER
+void *__real_m_malloc_with_finaliser(size_t num_bytes);
+
+void *__wrap_m_malloc_with_finaliser(size_t num_bytes) {
+    uintptr_t address = pb_heap_profiler_get_address(RETURN_ADDRESS);
+    void *ptr = __real_m_malloc_with_finaliser(num_bytes);
+    pb_heap_profiler_add_alloc(address, num_bytes, ptr);
+    return ptr;
+}
+#endif // MICROPY_ENABLE_FINALISER
+
+// Growing lists, strings and buffers goes through m_realloc. These are
+// counted with their new size, since they may have been moved.
+#if MICROPY_MALLOC_USES_ALLOCATED_SIZE
+void *__real_m_realloc(void *ptr, size_t old_num_bytes, size_t new_num_bytes);
+
+void *__wrap_m_realloc(void *ptr, size_t old_num_bytes, size_t new_num_bytes) {
+    uintptr_t address = pb_heap_profiler_get_address(RETURN_ADDRESS);
+    void *new_ptr = __real_m_realloc(ptr, old_num_bytes, new_num_bytes);
+    pb_heap_profiler_add_alloc(address, new_num_bytes, new_ptr);
+    return new_ptr;
+}
+#else
+void *__real_m_realloc(void *ptr, size_t new_num_bytes);
+
+void *__wrap_m_realloc(void *ptr, size_t new_num_bytes) {
+    uintptr_t address = pb_heap_profiler_get_address(RETURN_ADDRESS);
+    void *new_ptr = __real_m_realloc(ptr, new_num_bytes);
+    pb_heap_profiler_add_alloc(address, new_num_bytes, new_ptr);
+    return new_ptr;
+}
+#endif // MICROPY_MALLOC_USES_ALLOCATED_SIZE
+
+mp_obj_t pb_heap_profiler_get_info(void) {
+
+    // Creating the result allocates too, so take a copy first.
+    pb_heap_profiler_t stats = profiler;
+
+    gc_info_t heap;
+    gc_info(&heap);
+
+    // Sort sites by number of bytes, largest first.
+    for (uint32_t i = 1; i < stats.num_sites; i++) {
+        pb_heap_profiler_site_t site = stats.sites[i];
+        uint32_t j = i;
+        while (j > 0 && stats.sites[j - 1].bytes < site.bytes) {
+            stats.sites[j] = stats.sites[j - 1];
+            j--;
+        }
+        stats.sites[j] = site;
+    }
+
+    mp_obj_tuple_t *sites = MP_OBJ_TO_PTR(mp_obj_new_tuple(stats.num_sites, NULL));
+    for (uint32_t i = 0; i < stats.num_sites; i++) {
+        mp_obj_t site[] = {
+            mp_obj_new_int_from_uint(stats.sites[i].address),
+            mp_obj_new_int_from_uint(stats.sites[i].count),
+            mp_obj_new_int_from_uint(stats.sites[i].bytes),
+        };
+        sites->items[i] = mp_obj_new_tuple(MP_ARRAY_SIZE(site), site);
+    }
+
+    mp_map_elem_t info[] = {
+        {MP_OBJ_NEW_QSTR(MP_QSTR_total), mp_obj_new_int_from_uint(heap.total)},
+        {MP_OBJ_NEW_QSTR(MP_QSTR_used), mp_obj_new_int_from_uint(heap.used)},
+        {MP_OBJ_NEW_QSTR(MP_QSTR_free), mp_obj_new_int_from_uint(heap.free)},
+        {MP_OBJ_NEW_QSTR(MP_QSTR_max_free), mp_obj_new_int_from_uint(heap.max_free * MICROPY_BYTES_PER_GC_BLOCK)},
+        {MP_OBJ_NEW_QSTR(MP_QSTR_gc_count), mp_obj_new_int_from_uint(stats.gc_count)},
+        {MP_OBJ_NEW_QSTR(MP_QSTR_gc_time_total), mp_obj_new_int_from_uint(stats.gc_time_total)},
+        {MP_OBJ_NEW_QSTR(MP_QSTR_gc_time_max), mp_obj_new_int_from_uint(stats.gc_time_max)},
+        {MP_OBJ_NEW_QSTR(MP_QSTR_alloc_count), mp_obj_new_int_from_uint(stats.alloc_count)},
+        {MP_OBJ_NEW_QSTR(MP_QSTR_alloc_bytes), mp_obj_new_int_from_uint(stats.alloc_bytes)},
+        {MP_OBJ_NEW_QSTR(MP_QSTR_alloc_max), mp_obj_new_int_from_uint(stats.alloc_max)},
+        {MP_OBJ_NEW_QSTR(MP_QSTR_alloc_failed), mp_obj_new_int_from_uint(stats.alloc_failed)},
+        {MP_OBJ_NEW_QSTR(MP_QSTR_sites), MP_OBJ_FROM_PTR(sites)},
+        {MP_OBJ_NEW_QSTR(MP_QSTR_sites_evicted), mp_obj_new_int_from_uint(stats.sites_evicted)},
+    };
+    mp_obj_t info_dict = mp_obj_new_dict(MP_ARRAY_SIZE(info));
+
+    for (size_t i = 0; i < MP_ARRAY_SIZE(info); i++) {
+        mp_map_elem_t *elem = &info[i];
+        mp_obj_dict_store(info_dict, elem->key, elem->value);
+    }
+
+    return info_dict;
+}
+
+#endif // PYBRICKS_OPT_HEAP_PROFILER
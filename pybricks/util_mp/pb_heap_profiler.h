@@ -0,0 +1,29 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2025 The Pybricks Authors
+
+#ifndef PYBRICKS_INCLUDED_PY_PB_HEAP_PROFILER_H
+#define PYBRICKS_INCLUDED_PY_PB_HEAP_PROFILER_H
+
+#include "py/mpconfig.h"
+
+#if PYBRICKS_OPT_HEAP_PROFILER
+
+#include <stdint.h>
+
+#include "py/obj.h"
+
+// Maximum number of distinct allocation sites that are recorded
+#define PB_HEAP_PROFILER_NUM_SITES (32)
+
+// Clears all statistics, to be called when the heap is (re)initialized
+void pb_heap_profiler_reset(void);
+
+// Records the duration of one garbage collection in microseconds
+void pb_heap_profiler_add_gc_pause(uint32_t duration);
+
+// Gets a dictionary with heap and allocation statistics
+mp_obj_t pb_heap_profiler_get_info(void);
+
+#endif // PYBRICKS_OPT_HEAP_PROFILER
+
+#endif // PYBRICKS_INCLUDED_PY_PB_HEAP_PROFILER_H
@@ -23,9 +23,18 @@ make -s -j $(nproc --all) -C "$BRICK_DIR"
 export MICROPY_MICROPYTHON="$BUILD_DIR/virtualhub-micropython"
 export PYTHONPATH="$PBIO_DIR/cpython"
 export PBIO_VIRTUAL_PLATFORM_MODULE=pbio_virtual.platform.robot
+export BENCHMARK_OUTPUT="$BUILD_DIR/benchmark.json"
 
 cd "$MP_TEST_DIR"
-./run-tests.py --test-dirs $(find "$PB_TEST_DIR/virtualhub" -type d -and ! -wholename "*/build/*"  -and ! -wholename "*/run_test.py") "$@" || \
+./run-tests.py --test-dirs $(find "$PB_TEST_DIR/virtualhub" -type d -and ! -wholename "*/build/*"  -and ! -wholename "*/run_test.py" -and ! -wholename "*/drivebase_sim" -and ! -wholename "*/virtual_time") "$@" || \
+    (code=$?; ./run-tests.py --print-failures; exit $code)
+
+# These tests need motors A and B coupled through the simulated drive base.
+PBIO_VIRTUAL_DRIVEBASE=1 ./run-tests.py --test-dirs "$PB_TEST_DIR/virtualhub/drivebase_sim" "$@" || \
+    (code=$?; ./run-tests.py --print-failures; exit $code)
+
+# These tests check exact timings, so they need the virtual clock.
+PBIO_VIRTUAL_TIME=1 ./run-tests.py --test-dirs "$PB_TEST_DIR/virtualhub/virtual_time" "$@" || \
     (code=$?; ./run-tests.py --print-failures; exit $code)
 
 if [[ $COVERAGE ]]; then
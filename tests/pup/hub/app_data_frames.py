@@ -0,0 +1,37 @@
+# SPDX-License-Identifier: MIT
+# Copyright (c) 2025 The Pybricks Authors
+
+"""
+Hardware Module: Any hub with Bluetooth.
+
+Description: Streams app data frames to the host while connected over
+Bluetooth. The host is not expected to send any frames.
+"""
+
+from pybricks.tools import AppData, StopWatch, run_task
+
+app_data = AppData()
+
+
+async def main():
+    # Nothing was received from the host.
+    print(app_data.read_frame())
+
+    # Frames that don't fit in one notification are refused.
+    try:
+        await app_data.write_frame(bytes(256))
+    except ValueError:
+        print("too big")
+
+    # Writing many frames waits for room instead of raising or dropping them.
+    watch = StopWatch()
+    for i in range(200):
+        await app_data.write_frame(bytes([i]) * 10)
+    print("sent", watch.time() < 10000)
+
+    # Closing discards frames from the host.
+    app_data.close()
+    print(app_data.read_frame())
+
+
+run_task(main())
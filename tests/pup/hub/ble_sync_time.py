@@ -0,0 +1,53 @@
+# SPDX-License-Identifier: MIT
+# Copyright (c) 2025 The Pybricks Authors
+
+"""
+Hardware Module: Any hub with Bluetooth broadcasting.
+
+Description: Checks the synced StopWatch before and after this hub becomes
+the time sync leader. No other hubs should broadcast on channel 2.
+"""
+
+from pybricks.hubs import ThisHub
+from pybricks.tools import StopWatch, multitask, run_task, wait
+
+hub = ThisHub(broadcast_channel=1, observe_channels=[2])
+
+
+async def main():
+    synced = StopWatch(synced=True)
+
+    # Without a leader, there is no shared time.
+    try:
+        synced.time()
+    except RuntimeError:
+        print("not synced")
+
+    # Following a channel without a leader does not complete.
+    print(await multitask(hub.ble.sync_time(2), wait(500), race=True))
+    try:
+        synced.time()
+    except RuntimeError:
+        print("not synced")
+
+    # The leader uses its own clock.
+    await hub.ble.sync_time(1)
+    local = StopWatch()
+    start = synced.time()
+    await wait(100)
+    print("elapsed", abs(synced.time() - start - 100) <= 5)
+    print("matches", abs(synced.time() - start - local.time()) <= 5)
+
+    # The shared time never goes back.
+    previous = synced.time()
+    monotonic = True
+    for i in range(1000):
+        now = synced.time()
+        monotonic = monotonic and now >= previous
+        previous = now
+        if i % 100 == 0:
+            await wait(10)
+    print("monotonic", monotonic)
+
+
+run_task(main())
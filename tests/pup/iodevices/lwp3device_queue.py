@@ -0,0 +1,72 @@
+# SPDX-License-Identifier: MIT
+# Copyright (c) 2025 The Pybricks Authors
+
+"""
+Hardware Module: Any hub with Bluetooth, and a Powered Up Remote with LEGO
+firmware. Other LWP3 hubs can be used by changing HUB_KIND.
+
+Description: Checks the order, count and overflow of the queue of received
+messages, using hub property requests. Don't press the remote buttons.
+"""
+
+from pybricks.iodevices import LWP3Device
+from pybricks.tools import multitask, run_task, wait
+
+HUB_KIND = 0x42
+
+# Hub properties that every LWP3 hub reports, each in one message.
+PROPERTIES = [0x03, 0x04, 0x08, 0x0A, 0x0B]
+
+QUEUE_SIZE = 16
+
+device = LWP3Device(HUB_KIND)
+
+
+async def request(index):
+    prop = PROPERTIES[index % len(PROPERTIES)]
+    await device.write(bytes([5, 0, 0x01, prop, 0x05]))
+    await wait(100)
+
+
+def properties(messages):
+    return [message[3] for message in messages]
+
+
+async def drain():
+    while True:
+        result = await multitask(device.read(count=QUEUE_SIZE), wait(500), race=True)
+        if result[0] is None:
+            return
+
+
+async def main():
+    await drain()
+
+    # Messages are read in the order they were received.
+    for i in range(4):
+        await request(i)
+    messages = await device.read(count=4)
+    print(len(messages), properties(messages) == PROPERTIES[:4])
+    print(all(message[2] == 0x01 and message[4] == 0x06 for message in messages))
+
+    # No more than count messages are returned, and the rest stay queued.
+    for i in range(4):
+        await request(i)
+    messages = await device.read(count=2)
+    print(len(messages), properties(messages) == PROPERTIES[:2])
+    message = await device.read()
+    print(message[3] == PROPERTIES[2])
+    messages = await device.read(count=QUEUE_SIZE)
+    print(len(messages), properties(messages) == PROPERTIES[3:4])
+
+    # If the queue is full, the oldest messages are dropped and counted.
+    dropped = device.dropped()
+    for i in range(QUEUE_SIZE + 4):
+        await request(i)
+    messages = await device.read(count=QUEUE_SIZE + 4)
+    print(len(messages), device.dropped() - dropped)
+    expected = [PROPERTIES[i % len(PROPERTIES)] for i in range(4, QUEUE_SIZE + 4)]
+    print(properties(messages) == expected)
+
+
+run_task(main())
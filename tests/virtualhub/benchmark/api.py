@@ -0,0 +1,130 @@
+"""
+Measures the time and memory used by commonly used Python-facing APIs.
+
+Each benchmark prints its name, so this also runs as a regular test. To keep
+the results, set BENCHMARK_OUTPUT to the path of a JSON file. This is done by
+test-virtualhub.sh, which saves it as benchmark.json in the build directory.
+
+Timings use the hub clock, so this is only meaningful without virtual time.
+"""
+
+import gc
+import ujson
+
+from pybricks import version
+from pybricks.parameters import Color, Direction, Port
+from pybricks.pupdevices import Motor
+from pybricks.robotics import DriveBase
+from pybricks.tools import Matrix, multitask, run_task, vector, wait
+from uos import getenv, remove
+from utime import ticks_diff, ticks_us
+
+ITERATIONS = int(getenv("BENCHMARK_ITERATIONS") or 1000)
+
+# Allocation is counted over fewer calls with the garbage collector disabled,
+# so that benchmarks that allocate do not run out of memory.
+ALLOC_ITERATIONS = 100
+
+results = {}
+
+
+def record(name, elapsed, iterations, allocated, alloc_iterations):
+    results[name] = {
+        "us_per_call": elapsed / iterations,
+        "bytes_per_call": allocated / alloc_iterations,
+    }
+    print(name)
+
+
+def measure(name, func, iterations=ITERATIONS):
+    # Warm up so that one-time allocations are not counted.
+    func()
+
+    gc.collect()
+    gc.disable()
+    start = gc.mem_alloc()
+    for i in range(min(ALLOC_ITERATIONS, iterations)):
+        func()
+    allocated = gc.mem_alloc() - start
+    gc.enable()
+
+    gc.collect()
+    start = ticks_us()
+    for i in range(iterations):
+        func()
+    elapsed = ticks_diff(ticks_us(), start)
+
+    record(name, elapsed, iterations, allocated, min(ALLOC_ITERATIONS, iterations))
+
+
+async def measure_async(name, func, iterations=ITERATIONS):
+    await func()
+
+    gc.collect()
+    gc.disable()
+    start = gc.mem_alloc()
+    for i in range(ALLOC_ITERATIONS):
+        await func()
+    allocated = gc.mem_alloc() - start
+    gc.enable()
+
+    gc.collect()
+    start = ticks_us()
+    for i in range(iterations):
+        await func()
+    elapsed = ticks_diff(ticks_us(), start)
+
+    record(name, elapsed, iterations, allocated, ALLOC_ITERATIONS)
+
+
+left_motor = Motor(Port.A, Direction.COUNTERCLOCKWISE)
+right_motor = Motor(Port.B)
+drive_base = DriveBase(left_motor, right_motor, wheel_diameter=56, axle_track=112)
+motor = Motor(Port.C)
+
+measure("Motor.angle", motor.angle)
+measure("Motor.run", lambda: motor.run(500))
+motor.stop()
+
+measure("DriveBase.state", drive_base.state)
+
+# There is no color sensor on the virtual hub, so this measures the color
+# arithmetic that is done on the values it returns.
+measure("Color.scale", lambda: Color.RED * 0.5)
+measure("Color.shift", lambda: Color.RED >> 120)
+
+a = Matrix([[1, 2, 3], [4, 5, 6], [7, 8, 9]])
+v = vector(1, 2, 3)
+measure("Matrix.mul", lambda: a * v)
+measure("Matrix.add", lambda: a + a)
+measure("Matrix.T", lambda: a.T)
+
+
+async def two_waits():
+    await multitask(wait(0), wait(0))
+
+
+async def logger_save():
+    motor.log.start(1000)
+    motor.run(500)
+    await wait(200)
+    motor.stop()
+
+    # Saving is slow, so only a few iterations are needed.
+    measure("Logger.save", lambda: motor.log.save("benchmark_log.txt"), 10)
+    remove("benchmark_log.txt")
+
+
+async def main():
+    await measure_async("multitask", two_waits)
+    await logger_save()
+
+
+run_task(main())
+
+output = getenv("BENCHMARK_OUTPUT")
+if output:
+    with open(output, "w") as f:
+        ujson.dump(
+            {"version": version, "iterations": ITERATIONS, "results": results}, f
+        )
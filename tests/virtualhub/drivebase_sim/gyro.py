@@ -0,0 +1,39 @@
+# Runs with PBIO_VIRTUAL_DRIVEBASE set, so motors A and B drive a simulated
+# robot with a wheel diameter of 56 mm and an axle track of 112 mm.
+
+from pybricks.hubs import ThisHub
+from pybricks.pupdevices import Motor
+from pybricks.parameters import Port, Direction
+from pybricks.robotics import DriveBase
+from pybricks.tools import wait, StopWatch
+
+hub = ThisHub()
+left_motor = Motor(Port.A, Direction.COUNTERCLOCKWISE)
+right_motor = Motor(Port.B)
+drive_base = DriveBase(left_motor, right_motor, wheel_diameter=56, axle_track=112)
+
+
+def near(value, expected, tolerance):
+    return abs(value - expected) <= tolerance
+
+
+# The gyro is calibrated once the robot has been stationary for a while.
+watch = StopWatch()
+while not hub.imu.ready() and watch.time() < 5000:
+    wait(10)
+print("ready", hub.imu.ready())
+
+drive_base.use_gyro(True)
+
+# Drive straight. The robot should not turn.
+drive_base.straight(500)
+print("straight", near(drive_base.distance(), 500, 10), near(hub.imu.heading(), 0, 2))
+
+# Turn clockwise in place. The gyro and the drive base agree on the heading.
+drive_base.turn(90)
+print("turn", near(hub.imu.heading(), 90, 3), near(drive_base.angle(), 90, 3))
+
+# Drive on and turn back.
+drive_base.straight(200)
+drive_base.turn(-90)
+print("back", near(drive_base.distance(), 700, 15), near(hub.imu.heading(), 0, 3))
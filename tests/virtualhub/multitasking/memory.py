@@ -0,0 +1,91 @@
+import gc
+
+from pybricks.pupdevices import Motor
+from pybricks.parameters import Port
+from pybricks.tools import multitask, run_task, wait
+
+motor = Motor(Port.A)
+other_motors = [Motor(port) for port in (Port.B, Port.C, Port.D, Port.E, Port.F)]
+
+ITERATIONS = 10000
+
+
+def heap_growth(start):
+    gc.collect()
+    return gc.mem_alloc() - start
+
+
+async def test_wait():
+    print("test_wait")
+
+    # Warm up so the awaitable pool is allocated.
+    await wait(0)
+
+    gc.collect()
+    start = gc.mem_alloc()
+    gc.disable()
+    for i in range(ITERATIONS):
+        await wait(0)
+    growth = gc.mem_alloc() - start
+    gc.enable()
+
+    # Awaitables are reused, so waiting should not allocate at all.
+    print(growth < 64)
+
+
+async def test_motor():
+    print("test_motor")
+
+    await motor.run_angle(500, 10)
+
+    gc.collect()
+    start = gc.mem_alloc()
+    gc.disable()
+    for i in range(10):
+        await motor.run_angle(500, 10)
+    growth = gc.mem_alloc() - start
+    gc.enable()
+
+    print(growth < 64)
+
+
+async def test_objects():
+    print("test_objects")
+
+    # Awaiting on many different objects uses the same pooled awaitables
+    # instead of allocating new ones for each object.
+    await motor.run_angle(500, 10)
+
+    gc.collect()
+    start = gc.mem_alloc()
+    gc.disable()
+    for i in range(10):
+        for m in other_motors:
+            await m.run_angle(500, 10)
+    growth = gc.mem_alloc() - start
+    gc.enable()
+
+    print(growth < 64)
+
+
+async def test_parallel():
+    print("test_parallel")
+
+    # Multiple awaitables in use at the same time should reuse the pool too.
+    await multitask(wait(0), wait(0), wait(0))
+    start = gc.mem_alloc()
+    for i in range(ITERATIONS // 10):
+        await multitask(wait(0), wait(0), wait(0))
+
+    # Each multitask call allocates itself, but awaitables are not retained.
+    print(heap_growth(start) < 64)
+
+
+async def main():
+    await test_wait()
+    await test_motor()
+    await test_objects()
+    await test_parallel()
+
+
+run_task(main())
@@ -0,0 +1,92 @@
+from pybricks.pupdevices import Motor
+from pybricks.parameters import Port
+from pybricks.tools import multitask, run_task, wait, with_timeout, StopWatch
+
+from uerrno import ETIMEDOUT
+
+motor = Motor(Port.A)
+watch = StopWatch()
+
+
+async def slow(value):
+    await wait(1000)
+    return value
+
+
+async def fast(value):
+    await wait(10)
+    return value
+
+
+def print_timeout(e):
+    print(type(e), e.args[0] == ETIMEDOUT)
+
+
+async def test_awaitable():
+    print("test_awaitable")
+
+    # Completes before the deadline.
+    print(await with_timeout(wait(10), 500))
+
+    # Does not complete in time.
+    watch.reset()
+    try:
+        await with_timeout(wait(1000), 100)
+    except OSError as e:
+        print_timeout(e)
+    print(watch.time() < 200)
+
+
+async def test_motor():
+    print("test_motor")
+
+    # The motor is stopped by the awaitable cancel hook.
+    try:
+        await with_timeout(motor.run_angle(500, 3600), 100)
+    except OSError as e:
+        print_timeout(e)
+    print(motor.control.done())
+
+
+async def test_coroutine():
+    print("test_coroutine")
+
+    # Return value is passed through.
+    print(await with_timeout(fast(5), 500))
+
+    # Coroutine is cancelled on timeout.
+    watch.reset()
+    try:
+        await with_timeout(slow(5), 100)
+    except OSError as e:
+        print_timeout(e)
+    print(watch.time() < 200)
+
+
+async def test_multitask():
+    print("test_multitask")
+
+    print(await multitask(fast(1), fast(2), timeout=500))
+
+    try:
+        await multitask(fast(1), slow(2), timeout=100)
+    except OSError as e:
+        print_timeout(e)
+
+    print(await multitask(fast(1), slow(2), race=True, timeout=500))
+
+    # Misspelled keywords are not silently ignored.
+    try:
+        await multitask(fast(1), slow(2), timout=100)
+    except TypeError as e:
+        print(type(e))
+
+
+async def main():
+    await test_awaitable()
+    await test_motor()
+    await test_coroutine()
+    await test_multitask()
+
+
+run_task(main())
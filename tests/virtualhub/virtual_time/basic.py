@@ -0,0 +1,33 @@
+# Runs with PBIO_VIRTUAL_TIME set, so time only moves while the hub waits.
+
+from pybricks.pupdevices import Motor
+from pybricks.parameters import Port
+from pybricks.tools import wait, StopWatch
+
+from utime import time
+
+motor = Motor(Port.A)
+watch = StopWatch()
+
+# Computing takes no time, no matter how fast the computer is.
+total = 0
+for i in range(100000):
+    total += i
+print("compute", watch.time())
+
+# Waits end exactly on time.
+wait(1000)
+print("wait", watch.time())
+
+# The simulated motor follows the virtual clock too.
+motor.reset_angle(0)
+motor.run(500)
+wait(2000)
+motor.stop()
+print("motor", abs(motor.angle() - 1000) < 150)
+
+# A long wait completes much faster than on the wall clock.
+start = time()
+wait(30000)
+print("faster", time() - start < 15)
+print("total", watch.time())
@@ -0,0 +1,178 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: MIT
+# Copyright (c) 2025 The Pybricks Authors
+
+"""
+Runs a MicroPython script on many virtual hubs at once.
+
+Each trial runs in its own virtualhub process, so all pbio state is separate.
+Trials run on virtual time (PBIO_VIRTUAL_TIME), so they complete as fast as
+the host allows and give the same result every time.
+
+Parameters are given as NAME=VALUE[,VALUE...]. All combinations are run. The
+values of a trial are passed to the script as a dictionary in the PARAMS
+environment variable, so the script runs unchanged and tracebacks point at the
+right lines. For example:
+
+    ./tools/virtualhub-batch.py tune.py kp=10000,15000,20000 kd=0,500,1000
+
+    # tune.py
+    from uos import getenv
+
+    PARAMS = eval(getenv("PARAMS"))
+    motor = Motor(Port.A)
+    motor.control.pid(kp=PARAMS["kp"], kd=PARAMS["kd"])
+
+The output of each trial is saved in the output directory, along with a
+results.csv that lists the parameters, exit code, run time and the last line
+printed by each trial. Printing a score as the last line makes it easy to
+compare trials.
+"""
+
+import argparse
+import ast
+import csv
+import itertools
+import os
+import pathlib
+import subprocess
+import sys
+import time
+from concurrent.futures import ThreadPoolExecutor
+
+# Path to repo top-level dir.
+TOP = pathlib.Path(__file__).resolve().parent.parent
+
+DEFAULT_EXECUTABLE = TOP / "bricks" / "virtualhub" / "build" / "virtualhub-micropython"
+
+
+def parse_param(arg):
+    """Parses NAME=VALUE[,VALUE...] into a name and a list of values."""
+    name, sep, values = arg.partition("=")
+    if not sep or not name.isidentifier():
+        raise argparse.ArgumentTypeError(
+            f"expecting NAME=VALUE[,VALUE...], got '{arg}'"
+        )
+
+    def literal(value):
+        # Numbers and other literals are passed as such, anything else as str.
+        try:
+            return ast.literal_eval(value)
+        except (ValueError, SyntaxError):
+            return value
+
+    return name, [literal(v) for v in values.split(",")]
+
+
+def run_trial(args, index, params):
+    """Runs one trial and returns a row for the results table."""
+    log = args.output_dir / f"trial_{index:04d}.txt"
+
+    env = dict(os.environ)
+    env["PBIO_VIRTUAL_TIME"] = "1"
+    env["PARAMS"] = repr(params)
+    env["PYTHONPATH"] = os.pathsep.join(
+        filter(None, [str(TOP / "lib" / "pbio" / "cpython"), env.get("PYTHONPATH")])
+    )
+
+    start = time.monotonic()
+    try:
+        result = subprocess.run(
+            [str(args.executable), str(args.script)],
+            env=env,
+            stdout=subprocess.PIPE,
+            stderr=subprocess.STDOUT,
+            timeout=args.timeout,
+        )
+        output = result.stdout.decode(errors="replace")
+        returncode = result.returncode
+    except subprocess.TimeoutExpired as ex:
+        output = (ex.stdout or b"").decode(errors="replace")
+        returncode = "timeout"
+    elapsed = time.monotonic() - start
+
+    log.write_text(output)
+    lines = output.strip().splitlines()
+
+    return {
+        "trial": index,
+        **params,
+        "returncode": returncode,
+        "seconds": f"{elapsed:.3f}",
+        "last_line": lines[-1] if lines else "",
+    }
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(
+        description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter
+    )
+    parser.add_argument("script", type=pathlib.Path, help="MicroPython script to run")
+    parser.add_argument(
+        "params", metavar="NAME=VALUE[,VALUE...]", nargs="*", type=parse_param
+    )
+    parser.add_argument(
+        "-j",
+        "--jobs",
+        type=int,
+        default=os.cpu_count(),
+        help="number of hubs to run at the same time (default: number of cores)",
+    )
+    parser.add_argument(
+        "-o",
+        "--output-dir",
+        type=pathlib.Path,
+        default=pathlib.Path("virtualhub-batch"),
+        help="directory for trial output and results.csv",
+    )
+    parser.add_argument(
+        "--executable",
+        type=pathlib.Path,
+        default=DEFAULT_EXECUTABLE,
+        help="virtualhub-micropython executable",
+    )
+    parser.add_argument(
+        "--timeout", type=float, default=600, help="time limit per trial in seconds"
+    )
+
+    args = parser.parse_args()
+
+    if not args.executable.exists():
+        print(
+            f"{args.executable} not found, run 'make virtualhub' first", file=sys.stderr
+        )
+        sys.exit(1)
+
+    if not args.script.exists():
+        print(f"{args.script} not found", file=sys.stderr)
+        sys.exit(1)
+
+    args.output_dir.mkdir(parents=True, exist_ok=True)
+
+    names = [name for name, _ in args.params]
+    trials = [
+        dict(zip(names, values))
+        for values in itertools.product(*(values for _, values in args.params))
+    ]
+
+    with ThreadPoolExecutor(max_workers=args.jobs) as executor:
+        futures = [
+            executor.submit(run_trial, args, i, params)
+            for i, params in enumerate(trials)
+        ]
+        rows = []
+        for future in futures:
+            row = future.result()
+            rows.append(row)
+            print(", ".join(f"{k}={v}" for k, v in row.items()))
+
+    with open(args.output_dir / "results.csv", "w", newline="") as f:
+        writer = csv.DictWriter(
+            f, fieldnames=["trial", *names, "returncode", "seconds", "last_line"]
+        )
+        writer.writeheader()
+        writer.writerows(rows)
+
+    failed = sum(1 for row in rows if row["returncode"] != 0)
+    print(f"{len(rows)} trials, {failed} failed, results in {args.output_dir}")
+    sys.exit(1 if failed else 0)